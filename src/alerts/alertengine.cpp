@@ -0,0 +1,416 @@
+#include "alertengine.h"
+#include "fleetstate.h"
+#include "geofence.h"
+#include "logger.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+// Transitions logged individually per tick; the rest are summarized
+const std::size_t MAX_LOGGED_ALERTS = 16;
+
+struct FieldName {
+    const char* name;
+    AlertCondition::Field field;
+};
+
+const FieldName FIELD_NAMES[] = {
+    {"battery", AlertCondition::BATTERY},
+    {"altitude", AlertCondition::ALTITUDE},
+    {"speed", AlertCondition::SPEED},
+    {"heading", AlertCondition::HEADING},
+    {"latitude", AlertCondition::LATITUDE},
+    {"longitude", AlertCondition::LONGITUDE},
+    {"gps", AlertCondition::GPS_STATUS},
+    {"geofence", AlertCondition::GEOFENCE},
+};
+
+struct ComparisonName {
+    const char* name;
+    AlertCondition::Comparison comparison;
+};
+
+const ComparisonName COMPARISON_NAMES[] = {
+    {"<", AlertCondition::LESS},
+    {"<=", AlertCondition::LESS_EQUAL},
+    {">", AlertCondition::GREATER},
+    {">=", AlertCondition::GREATER_EQUAL},
+    {"==", AlertCondition::EQUAL},
+    {"!=", AlertCondition::NOT_EQUAL},
+};
+
+// GPS and geofence conditions may name the status instead of giving its numeric value
+const char* const GPS_STATUS_NAMES[] = {"NO_FIX", "FIX_2D", "FIX_3D"};
+const char* const GEOFENCE_STATUS_NAMES[] = {"CLEAR", "OUTSIDE_INCLUSION", "INSIDE_EXCLUSION"};
+
+template <std::size_t N>
+bool parseStatusName(const QString& name, const char* const (&names)[N], double& value) {
+    for (std::size_t i = 0; i < N; ++i) {
+        if (name == names[i]) {
+            value = static_cast<double>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+AlertRule makeRule(const QString& name, AlertRule::Trigger trigger, AlertRule::Severity severity,
+                   const AlertCondition& condition, const QString& message) {
+    AlertRule rule;
+    rule.name = name;
+    rule.trigger = trigger;
+    rule.severity = severity;
+    rule.conditions.push_back(condition);
+    rule.message = message;
+    return rule;
+}
+
+bool parseCondition(const QJsonObject& object, AlertCondition& condition, QString& error) {
+    const QString field = object.value("field").toString();
+    const FieldName* fieldName = std::find_if(std::begin(FIELD_NAMES), std::end(FIELD_NAMES),
+        [&field](const FieldName& entry) { return field == entry.name; });
+    if (fieldName == std::end(FIELD_NAMES)) {
+        error = QString("unknown field \"%1\"").arg(field);
+        return false;
+    }
+    condition.field = fieldName->field;
+
+    const QString op = object.value("op").toString();
+    const ComparisonName* comparisonName = std::find_if(std::begin(COMPARISON_NAMES), std::end(COMPARISON_NAMES),
+        [&op](const ComparisonName& entry) { return op == entry.name; });
+    if (comparisonName == std::end(COMPARISON_NAMES)) {
+        error = QString("unknown comparison \"%1\"").arg(op);
+        return false;
+    }
+    condition.comparison = comparisonName->comparison;
+
+    const QJsonValue value = object.value("value");
+    if (value.isDouble()) {
+        condition.value = value.toDouble();
+        return true;
+    }
+    if (value.isString()) {
+        const QString status = value.toString().toUpper();
+        if ((condition.field == AlertCondition::GPS_STATUS && parseStatusName(status, GPS_STATUS_NAMES, condition.value))
+            || (condition.field == AlertCondition::GEOFENCE && parseStatusName(status, GEOFENCE_STATUS_NAMES, condition.value))) {
+            return true;
+        }
+    }
+    error = QString("invalid value for field \"%1\"").arg(field);
+    return false;
+}
+
+bool parseRule(const QJsonObject& object, AlertRule& rule, QString& error) {
+    rule.name = object.value("name").toString();
+    if (rule.name.isEmpty()) {
+        error = "rule without a name";
+        return false;
+    }
+
+    const QString trigger = object.value("trigger").toString("level");
+    if (trigger == "level") {
+        rule.trigger = AlertRule::LEVEL;
+    } else if (trigger == "edge") {
+        rule.trigger = AlertRule::EDGE;
+    } else {
+        error = QString("rule \"%1\": unknown trigger \"%2\"").arg(rule.name, trigger);
+        return false;
+    }
+
+    const QString severity = object.value("severity").toString("warning");
+    if (severity == "info") {
+        rule.severity = AlertRule::INFO;
+    } else if (severity == "warning") {
+        rule.severity = AlertRule::WARNING;
+    } else if (severity == "error") {
+        rule.severity = AlertRule::ERROR;
+    } else {
+        error = QString("rule \"%1\": unknown severity \"%2\"").arg(rule.name, severity);
+        return false;
+    }
+
+    const QJsonArray conditions = object.value("when").toArray();
+    if (conditions.isEmpty()) {
+        error = QString("rule \"%1\" has no conditions").arg(rule.name);
+        return false;
+    }
+    rule.conditions.clear();
+    for (const QJsonValue& value : conditions) {
+        AlertCondition condition;
+        if (!parseCondition(value.toObject(), condition, error)) {
+            error = QString("rule \"%1\": %2").arg(rule.name, error);
+            return false;
+        }
+        rule.conditions.push_back(condition);
+    }
+
+    rule.message = object.value("message").toString();
+    return true;
+}
+}
+
+AlertEngine::AlertEngine()
+    : stateWords(0)
+    , stateLayoutVersion(0)
+    , stateStale(true)
+    , totalRaised(0)
+{
+    setRules(defaultRules());
+}
+
+std::vector<AlertRule> AlertEngine::defaultRules() {
+    std::vector<AlertRule> defaults;
+    defaults.push_back(makeRule("battery-low", AlertRule::EDGE, AlertRule::WARNING,
+                                AlertCondition{AlertCondition::BATTERY, AlertCondition::LESS_EQUAL, 20.0},
+                                "Drone %1 battery is low (20%)"));
+    defaults.push_back(makeRule("battery-critical", AlertRule::EDGE, AlertRule::ERROR,
+                                AlertCondition{AlertCondition::BATTERY, AlertCondition::LESS_EQUAL, 5.0},
+                                "Drone %1 battery is critically low (5%)"));
+    defaults.push_back(makeRule("gps-lost", AlertRule::LEVEL, AlertRule::WARNING,
+                                AlertCondition{AlertCondition::GPS_STATUS, AlertCondition::EQUAL,
+                                               static_cast<double>(GPSFixStatus::NO_FIX)},
+                                "Drone %1 lost GPS fix"));
+    defaults.push_back(makeRule("geofence-exit", AlertRule::LEVEL, AlertRule::WARNING,
+                                AlertCondition{AlertCondition::GEOFENCE, AlertCondition::EQUAL,
+                                               static_cast<double>(Geofence::OUTSIDE_INCLUSION)},
+                                "Drone %1 left the operating area"));
+    defaults.push_back(makeRule("geofence-exclusion", AlertRule::LEVEL, AlertRule::ERROR,
+                                AlertCondition{AlertCondition::GEOFENCE, AlertCondition::EQUAL,
+                                               static_cast<double>(Geofence::INSIDE_EXCLUSION)},
+                                "Drone %1 entered an exclusion zone"));
+    return defaults;
+}
+
+bool AlertEngine::parseRules(const QByteArray& json, std::vector<AlertRule>& parsed, QString& error) {
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        error = QString("%1 at offset %2").arg(parseError.errorString()).arg(parseError.offset);
+        return false;
+    }
+    if (!document.isObject() || !document.object().value("rules").isArray()) {
+        error = "expected an object with a \"rules\" array";
+        return false;
+    }
+
+    std::vector<AlertRule> result;
+    for (const QJsonValue& value : document.object().value("rules").toArray()) {
+        AlertRule rule;
+        if (!value.isObject()) {
+            error = "every rule must be an object";
+            return false;
+        }
+        if (!parseRule(value.toObject(), rule, error)) {
+            return false;
+        }
+        result.push_back(rule);
+    }
+    parsed.swap(result);
+    return true;
+}
+
+bool AlertEngine::loadRules(const QString& filename) {
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        LOG_ERROR(QString("Cannot read alert rules %1: %2").arg(filename, file.errorString()));
+        return false;
+    }
+
+    std::vector<AlertRule> loaded;
+    QString error;
+    if (!parseRules(file.readAll(), loaded, error)) {
+        LOG_ERROR(QString("Cannot load alert rules %1: %2").arg(filename, error));
+        return false;
+    }
+    setRules(loaded);
+    LOG_INFO(QString("Loaded %1 alert rules from %2").arg(static_cast<qulonglong>(rules.size())).arg(filename));
+    return true;
+}
+
+void AlertEngine::setRules(const std::vector<AlertRule>& newRules) {
+    rules = newRules;
+    program.compile(rules);
+    active.clear();
+    unseen.clear();
+    stateIds.clear();
+    stateWords = 0;
+    stateStale = true;
+    events.clear();
+}
+
+const std::vector<AlertRule>& AlertEngine::getRules() const {
+    return rules;
+}
+
+std::size_t AlertEngine::getPredicateCount() const {
+    return program.predicateCount();
+}
+
+void AlertEngine::setGeofence(std::shared_ptr<const Geofence> fence) {
+    geofence = std::move(fence);
+}
+
+void AlertEngine::updateFleet(const FleetSnapshotPtr& snapshot) {
+    evaluate(*snapshot);
+    notify();
+}
+
+void AlertEngine::addListener(AlertListener* listener) {
+    if (listener && std::find(listeners.begin(), listeners.end(), listener) == listeners.end()) {
+        listeners.push_back(listener);
+    }
+}
+
+void AlertEngine::removeListener(AlertListener* listener) {
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
+
+void AlertEngine::notify() {
+    for (AlertListener* listener : listeners) {
+        listener->updateAlerts(events);
+    }
+}
+
+const std::vector<AlertEvent>& AlertEngine::evaluate(const FleetState& fleet) {
+    events.clear();
+    if (rules.empty()) {
+        return events;
+    }
+    if (stateStale || fleet.getLayoutVersion() != stateLayoutVersion) {
+        remapState(fleet);
+    }
+
+    const std::size_t words = AlertProgram::BLOCK_WORDS;
+    blockBits.resize(rules.size() * words);
+
+    for (std::size_t begin = 0; begin < fleet.size(); begin += AlertProgram::BLOCK_SIZE) {
+        const std::size_t end = qMin(fleet.size(), begin + AlertProgram::BLOCK_SIZE);
+        const std::size_t blockWord = begin / 64;
+        program.evaluate(fleet, geofence.get(), begin, end, blockBits.data(), scratch);
+
+        for (std::size_t r = 0; r < rules.size(); ++r) {
+            const bool edge = rules[r].trigger == AlertRule::EDGE;
+            const quint64* current = blockBits.data() + r * words;
+            quint64* previous = active.data() + r * stateWords + blockWord;
+
+            for (std::size_t w = 0; w < words; ++w) {
+                quint64 raised = current[w] & ~previous[w];
+                quint64 cleared = previous[w] & ~current[w];
+                if (edge) {
+                    raised &= ~unseen[blockWord + w];
+                    cleared = 0;
+                }
+                previous[w] = current[w];
+
+                // Only drones whose state changed are visited
+                while (raised) {
+                    const std::size_t index = begin + w * 64 + qCountTrailingZeroBits(raised);
+                    events.push_back(AlertEvent{index, fleet.idAt(index), r, AlertEvent::RAISED});
+                    raised &= raised - 1;
+                }
+                while (cleared) {
+                    const std::size_t index = begin + w * 64 + qCountTrailingZeroBits(cleared);
+                    events.push_back(AlertEvent{index, fleet.idAt(index), r, AlertEvent::CLEARED});
+                    cleared &= cleared - 1;
+                }
+            }
+        }
+    }
+    std::fill(unseen.begin(), unseen.end(), 0);
+
+    if (events.empty()) {
+        return events;
+    }
+    std::sort(events.begin(), events.end(), [](const AlertEvent& x, const AlertEvent& y) {
+        return x.index != y.index ? x.index < y.index : x.rule < y.rule;
+    });
+    for (const AlertEvent& event : events) {
+        totalRaised += event.transition == AlertEvent::RAISED;
+    }
+    logEvents(fleet);
+    return events;
+}
+
+const std::vector<AlertEvent>& AlertEngine::getEvents() const {
+    return events;
+}
+
+quint64 AlertEngine::getTotalRaised() const {
+    return totalRaised;
+}
+
+void AlertEngine::remapState(const FleetState& fleet) {
+    // Whole blocks, so evaluation never needs a bounds check
+    const std::size_t blocks = (fleet.size() + AlertProgram::BLOCK_SIZE - 1) / AlertProgram::BLOCK_SIZE;
+    const std::size_t words = blocks * AlertProgram::BLOCK_WORDS;
+    std::vector<quint64> remapped(rules.size() * words, 0);
+    std::vector<quint64> remappedUnseen(words, 0);
+
+    std::unordered_map<DroneId, std::size_t> previousIndex;
+    previousIndex.reserve(stateIds.size());
+    for (std::size_t i = 0; i < stateIds.size(); ++i) {
+        previousIndex.emplace(stateIds[i], i);
+    }
+
+    stateIds.resize(fleet.size());
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        stateIds[i] = fleet.idAt(i);
+        const auto found = previousIndex.find(stateIds[i]);
+        if (found == previousIndex.end()) {
+            remappedUnseen[i / 64] |= quint64(1) << (i % 64);
+            continue;
+        }
+        const std::size_t from = found->second;
+        for (std::size_t r = 0; r < rules.size(); ++r) {
+            const quint64 bit = (active[r * stateWords + from / 64] >> (from % 64)) & 1;
+            remapped[r * words + i / 64] |= bit << (i % 64);
+        }
+    }
+
+    active.swap(remapped);
+    unseen.swap(remappedUnseen);
+    stateWords = words;
+    stateLayoutVersion = fleet.getLayoutVersion();
+    stateStale = false;
+}
+
+void AlertEngine::logEvents(const FleetState& fleet) const {
+    std::size_t logged = 0;
+    for (const AlertEvent& event : events) {
+        if (logged++ == MAX_LOGGED_ALERTS) {
+            break;
+        }
+        const AlertRule& rule = rules[event.rule];
+        const QString name = fleet.nameAt(event.index);
+        if (event.transition == AlertEvent::CLEARED) {
+            LOG_INFO(QString("Alert %1 cleared for drone %2").arg(rule.name, name));
+            continue;
+        }
+
+        const QString message = rule.message.contains("%1") ? rule.message.arg(name)
+            : QString("Alert %1 raised for drone %2%3")
+                  .arg(rule.name, name, rule.message.isEmpty() ? QString() : ": " + rule.message);
+        switch (rule.severity) {
+            case AlertRule::INFO:
+                LOG_INFO(message);
+                break;
+            case AlertRule::WARNING:
+                LOG_WARNING(message);
+                break;
+            case AlertRule::ERROR:
+                LOG_ERROR(message);
+                break;
+        }
+    }
+    if (events.size() > MAX_LOGGED_ALERTS) {
+        LOG_WARNING(QString("%1 further alert transitions this tick")
+                    .arg(static_cast<qulonglong>(events.size() - MAX_LOGGED_ALERTS)));
+    }
+}
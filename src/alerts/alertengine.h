@@ -0,0 +1,105 @@
+#ifndef ALERTENGINE_H
+#define ALERTENGINE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "alertprogram.h"
+#include "droneidregistry.h"
+#include "observer.h"
+
+class FleetState;
+class Geofence;
+
+// One drone entering or leaving a rule's alert state on a tick
+struct AlertEvent {
+    enum Transition {
+        RAISED = 0,
+        CLEARED = 1   // level rules only
+    };
+
+    std::size_t index;   // fleet index
+    DroneId droneId;
+    std::size_t rule;    // index into AlertEngine::getRules()
+    Transition transition;
+};
+
+// Receives the alert transitions of every tick from an AlertEngine
+class AlertListener {
+public:
+    virtual ~AlertListener() = default;
+    // The events of the tick, possibly none
+    virtual void updateAlerts(const std::vector<AlertEvent>& alerts) = 0;
+};
+
+// Evaluates operator-declared alert rules against the whole fleet once per
+// tick. The rules are compiled into an AlertProgram and run block by block
+// over the telemetry columns; each rule's per-drone state is one bit, so the
+// previous tick is compared 64 drones at a time and only transitions become
+// events. Drones are matched across ticks by ID, so adding or removing
+// drones keeps the state of the others. New events are logged with the
+// rule's severity; listeners added to the engine receive each tick's
+// events through updateAlerts().
+class AlertEngine : public Observer {
+public:
+    AlertEngine();
+
+    // The built-in rules: battery low (20%) and critical (5%) edges, loss of
+    // GPS fix, and leaving the operating area or entering an exclusion zone
+    static std::vector<AlertRule> defaultRules();
+
+    // Parses a JSON rule file (format in the README); on failure `error` says why
+    static bool parseRules(const QByteArray& json, std::vector<AlertRule>& rules, QString& error);
+
+    // Replaces the rules with the file's; keeps the current rules on failure
+    bool loadRules(const QString& filename);
+    // Compiles the rules; every drone is treated as newly seen on the next tick
+    void setRules(const std::vector<AlertRule>& rules);
+    const std::vector<AlertRule>& getRules() const;
+    std::size_t getPredicateCount() const;
+
+    // Zones behind the "geofence" field; without one every drone is clear
+    void setGeofence(std::shared_ptr<const Geofence> fence);
+
+    // Observer: evaluates the tick's snapshot, then notifies
+    void updateFleet(const FleetSnapshotPtr& snapshot) override;
+
+    void addListener(AlertListener* listener);
+    void removeListener(AlertListener* listener);
+    // Forwards the last evaluated events to the listeners
+    void notify();
+
+    // Runs one tick of evaluation directly; events are ordered by (index, rule)
+    const std::vector<AlertEvent>& evaluate(const FleetState& fleet);
+
+    const std::vector<AlertEvent>& getEvents() const;
+    // Alerts raised since construction
+    quint64 getTotalRaised() const;
+
+private:
+    void remapState(const FleetState& fleet);
+    void logEvents(const FleetState& fleet) const;
+
+    std::vector<AlertRule> rules;
+    AlertProgram program;
+    std::shared_ptr<const Geofence> geofence;
+
+    // Rule-major bitsets: bit i of rule r is word r * stateWords + i / 64
+    std::vector<quint64> active;
+    std::vector<quint64> unseen;   // drones without a previous tick; edge rules only take their baseline
+    std::vector<DroneId> stateIds; // drone behind each state bit
+    std::size_t stateWords;
+    quint64 stateLayoutVersion;
+    bool stateStale;
+
+    std::vector<quint64> blockBits;
+    std::vector<quint64> scratch;
+    std::vector<AlertEvent> events;
+    std::vector<AlertListener*> listeners;
+    quint64 totalRaised;
+};
+
+#endif // ALERTENGINE_H
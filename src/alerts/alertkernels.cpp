@@ -0,0 +1,312 @@
+#include "alertkernels.h"
+#include "movementkernels.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ALERT_KERNELS_X86 1
+#define KERNEL_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define ALERT_KERNELS_X86 1
+#define KERNEL_TARGET(isa)
+#include <immintrin.h>
+#endif
+
+namespace AlertKernels {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Scalar reference. The comparison is shifted in, never branched on.
+// ---------------------------------------------------------------------------
+
+template <int Op>
+inline bool compareLane(double lane, double value) {
+    if constexpr (Op == AlertCondition::LESS) {
+        return lane < value;
+    } else if constexpr (Op == AlertCondition::LESS_EQUAL) {
+        return lane <= value;
+    } else if constexpr (Op == AlertCondition::GREATER) {
+        return lane > value;
+    } else if constexpr (Op == AlertCondition::GREATER_EQUAL) {
+        return lane >= value;
+    } else if constexpr (Op == AlertCondition::EQUAL) {
+        return lane == value;
+    } else {
+        return lane != value;
+    }
+}
+
+template <int Op, typename T>
+inline void compareScalar(const T* column, std::size_t count, double value, quint64* bits, std::size_t begin) {
+    for (std::size_t i = begin; i < count; ++i) {
+        bits[i / 64] |= static_cast<quint64>(compareLane<Op>(static_cast<double>(column[i]), value)) << (i % 64);
+    }
+}
+
+// The byte values satisfying a comparison against a constant are one range
+// [low, high] (possibly empty, low > high) or, for !=, everything outside one
+struct ByteRange {
+    int low;
+    int high;
+    bool outside;
+};
+
+template <int Op>
+ByteRange unboundedByteRange(double value) {
+    if (std::isnan(value)) {
+        return ByteRange{1, 0, Op == AlertCondition::NOT_EQUAL};
+    }
+    // Clamped first so infinities and huge thresholds convert safely
+    const double bounded = std::max(-1.0, std::min(256.0, value));
+    const int below = static_cast<int>(std::floor(bounded));
+    const int above = static_cast<int>(std::ceil(bounded));
+    if constexpr (Op == AlertCondition::LESS) {
+        return ByteRange{0, above - 1, false};
+    } else if constexpr (Op == AlertCondition::LESS_EQUAL) {
+        return ByteRange{0, below, false};
+    } else if constexpr (Op == AlertCondition::GREATER) {
+        return ByteRange{below + 1, 255, false};
+    } else if constexpr (Op == AlertCondition::GREATER_EQUAL) {
+        return ByteRange{above, 255, false};
+    } else {
+        // A fractional threshold equals no byte
+        const int exact = below == above ? below : 256;
+        return ByteRange{exact, exact, Op == AlertCondition::NOT_EQUAL};
+    }
+}
+
+// Limited to 0..255, so a non-empty range fits the byte lanes
+template <int Op>
+ByteRange byteRange(double value) {
+    ByteRange range = unboundedByteRange<Op>(value);
+    range.low = std::max(range.low, 0);
+    range.high = std::min(range.high, 255);
+    return range;
+}
+
+inline void compareBytesScalar(const quint8* column, std::size_t count, const ByteRange& range,
+                               quint64* bits, std::size_t begin) {
+    for (std::size_t i = begin; i < count; ++i) {
+        const bool inRange = (column[i] >= range.low) & (column[i] <= range.high);
+        bits[i / 64] |= static_cast<quint64>(inRange != range.outside) << (i % 64);
+    }
+}
+
+#ifdef ALERT_KERNELS_X86
+
+// ---------------------------------------------------------------------------
+// SSE2: two drones per compare, whole words at a time; the partial last
+// word goes through the scalar path. The predicates match the scalar
+// operators, including NaN (false for all but !=).
+// ---------------------------------------------------------------------------
+
+template <int Op>
+KERNEL_TARGET("sse2")
+inline int compareMaskSse2(const double* lanes, __m128d threshold) {
+    const __m128d values = _mm_loadu_pd(lanes);
+    __m128d result;
+    if constexpr (Op == AlertCondition::LESS) {
+        result = _mm_cmplt_pd(values, threshold);
+    } else if constexpr (Op == AlertCondition::LESS_EQUAL) {
+        result = _mm_cmple_pd(values, threshold);
+    } else if constexpr (Op == AlertCondition::GREATER) {
+        result = _mm_cmpgt_pd(values, threshold);
+    } else if constexpr (Op == AlertCondition::GREATER_EQUAL) {
+        result = _mm_cmpge_pd(values, threshold);
+    } else if constexpr (Op == AlertCondition::EQUAL) {
+        result = _mm_cmpeq_pd(values, threshold);
+    } else {
+        result = _mm_cmpneq_pd(values, threshold);
+    }
+    return _mm_movemask_pd(result);
+}
+
+template <int Op>
+KERNEL_TARGET("sse2")
+void compareSse2(const double* column, std::size_t count, double value, quint64* bits) {
+    const __m128d threshold = _mm_set1_pd(value);
+    std::size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        // The word is built in a register, eight lanes per shift; storing
+        // per compare would serialize on memory
+        quint64 word = 0;
+        for (std::size_t lane = 0; lane < 64; lane += 8) {
+            const double* group = column + i + lane;
+            const int mask = compareMaskSse2<Op>(group, threshold)
+                | compareMaskSse2<Op>(group + 2, threshold) << 2
+                | compareMaskSse2<Op>(group + 4, threshold) << 4
+                | compareMaskSse2<Op>(group + 6, threshold) << 6;
+            word |= static_cast<quint64>(mask) << lane;
+        }
+        bits[i / 64] = word;
+    }
+    compareScalar<Op>(column, count, value, bits, i);
+}
+
+// Bytes: sixteen drones per compare. A lane is in [low, high] when clamping
+// it to the range leaves it unchanged (unsigned min/max, as SSE2 has no
+// unsigned byte compare). Only called with a non-empty range.
+KERNEL_TARGET("sse2")
+void compareBytesSse2(const quint8* column, std::size_t count, const ByteRange& range, quint64* bits) {
+    const __m128i low = _mm_set1_epi8(static_cast<char>(range.low));
+    const __m128i high = _mm_set1_epi8(static_cast<char>(range.high));
+    const quint64 flip = range.outside ? ~quint64(0) : 0;
+    std::size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        quint64 word = 0;
+        for (std::size_t lane = 0; lane < 64; lane += 16) {
+            const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i + lane));
+            const __m128i inRange = _mm_cmpeq_epi8(_mm_min_epu8(_mm_max_epu8(values, low), high), values);
+            word |= static_cast<quint64>(static_cast<quint16>(_mm_movemask_epi8(inRange))) << lane;
+        }
+        bits[i / 64] = word ^ flip;
+    }
+    compareBytesScalar(column, count, range, bits, i);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2: four drones per compare, sixteen per shift
+// ---------------------------------------------------------------------------
+
+constexpr int avxPredicate(int op) {
+    return op == AlertCondition::LESS ? _CMP_LT_OQ
+        : op == AlertCondition::LESS_EQUAL ? _CMP_LE_OQ
+        : op == AlertCondition::GREATER ? _CMP_GT_OQ
+        : op == AlertCondition::GREATER_EQUAL ? _CMP_GE_OQ
+        : op == AlertCondition::EQUAL ? _CMP_EQ_OQ
+        : _CMP_NEQ_UQ;
+}
+
+template <int Op>
+KERNEL_TARGET("avx2")
+inline int compareMaskAvx2(const double* lanes, __m256d threshold) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(lanes), threshold, avxPredicate(Op)));
+}
+
+template <int Op>
+KERNEL_TARGET("avx2")
+void compareAvx2(const double* column, std::size_t count, double value, quint64* bits) {
+    const __m256d threshold = _mm256_set1_pd(value);
+    std::size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        quint64 word = 0;
+        for (std::size_t lane = 0; lane < 64; lane += 16) {
+            const double* group = column + i + lane;
+            const int mask = compareMaskAvx2<Op>(group, threshold)
+                | compareMaskAvx2<Op>(group + 4, threshold) << 4
+                | compareMaskAvx2<Op>(group + 8, threshold) << 8
+                | compareMaskAvx2<Op>(group + 12, threshold) << 12;
+            word |= static_cast<quint64>(mask) << lane;
+        }
+        bits[i / 64] = word;
+    }
+    compareScalar<Op>(column, count, value, bits, i);
+}
+
+KERNEL_TARGET("avx2")
+void compareBytesAvx2(const quint8* column, std::size_t count, const ByteRange& range, quint64* bits) {
+    const __m256i low = _mm256_set1_epi8(static_cast<char>(range.low));
+    const __m256i high = _mm256_set1_epi8(static_cast<char>(range.high));
+    const quint64 flip = range.outside ? ~quint64(0) : 0;
+    std::size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        quint64 word = 0;
+        for (std::size_t lane = 0; lane < 64; lane += 32) {
+            const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i + lane));
+            const __m256i inRange = _mm256_cmpeq_epi8(_mm256_min_epu8(_mm256_max_epu8(values, low), high), values);
+            word |= static_cast<quint64>(static_cast<quint32>(_mm256_movemask_epi8(inRange))) << lane;
+        }
+        bits[i / 64] = word ^ flip;
+    }
+    compareBytesScalar(column, count, range, bits, i);
+}
+
+#endif // ALERT_KERNELS_X86
+
+template <int Op>
+void compareDoubles(const double* column, std::size_t count, double value, quint64* bits) {
+    switch (MovementKernels::activeInstructionSet()) {
+#ifdef ALERT_KERNELS_X86
+        case MovementKernels::AVX2:
+            compareAvx2<Op>(column, count, value, bits);
+            return;
+        case MovementKernels::SSE2:
+            compareSse2<Op>(column, count, value, bits);
+            return;
+#endif
+        default:
+            compareScalar<Op>(column, count, value, bits, 0);
+            return;
+    }
+}
+
+void compareBytes(const quint8* column, std::size_t count, const ByteRange& range, quint64* bits) {
+    if (range.low > range.high) {
+        // No byte is in range: nothing matches, or everything does for !=
+        if (range.outside) {
+            std::fill(bits, bits + count / 64, ~quint64(0));
+            compareBytesScalar(column, count, range, bits, count / 64 * 64);
+        }
+        return;
+    }
+    switch (MovementKernels::activeInstructionSet()) {
+#ifdef ALERT_KERNELS_X86
+        case MovementKernels::AVX2:
+            compareBytesAvx2(column, count, range, bits);
+            return;
+        case MovementKernels::SSE2:
+            compareBytesSse2(column, count, range, bits);
+            return;
+#endif
+        default:
+            compareBytesScalar(column, count, range, bits, 0);
+            return;
+    }
+}
+
+template <typename Kernel>
+void dispatch(AlertCondition::Comparison comparison, Kernel kernel) {
+    switch (comparison) {
+        case AlertCondition::LESS:
+            kernel(std::integral_constant<int, AlertCondition::LESS>());
+            break;
+        case AlertCondition::LESS_EQUAL:
+            kernel(std::integral_constant<int, AlertCondition::LESS_EQUAL>());
+            break;
+        case AlertCondition::GREATER:
+            kernel(std::integral_constant<int, AlertCondition::GREATER>());
+            break;
+        case AlertCondition::GREATER_EQUAL:
+            kernel(std::integral_constant<int, AlertCondition::GREATER_EQUAL>());
+            break;
+        case AlertCondition::EQUAL:
+            kernel(std::integral_constant<int, AlertCondition::EQUAL>());
+            break;
+        case AlertCondition::NOT_EQUAL:
+            kernel(std::integral_constant<int, AlertCondition::NOT_EQUAL>());
+            break;
+    }
+}
+
+} // namespace
+
+void compare(const double* column, std::size_t count, AlertCondition::Comparison comparison,
+             double value, quint64* bits, std::size_t wordCount) {
+    std::fill(bits, bits + wordCount, 0);
+    dispatch(comparison, [=](auto op) {
+        compareDoubles<decltype(op)::value>(column, count, value, bits);
+    });
+}
+
+void compare(const quint8* column, std::size_t count, AlertCondition::Comparison comparison,
+             double value, quint64* bits, std::size_t wordCount) {
+    std::fill(bits, bits + wordCount, 0);
+    dispatch(comparison, [=](auto op) {
+        compareBytes(column, count, byteRange<decltype(op)::value>(value), bits);
+    });
+}
+
+} // namespace AlertKernels
@@ -0,0 +1,27 @@
+#ifndef ALERTKERNELS_H
+#define ALERTKERNELS_H
+
+#include <QtGlobal>
+#include <cstddef>
+#include "alertprogram.h"
+
+// Column comparison kernels behind AlertProgram. Each packs `column[i] <op>
+// value` for i < count into bit i % 64 of bits[i / 64] and zeroes the rest
+// of the `wordCount` words. The double kernels come in AVX2, SSE2 and
+// scalar variants (compare + movemask, four or two drones per instruction)
+// that produce identical bits and dispatch on
+// MovementKernels::activeInstructionSet().
+namespace AlertKernels {
+
+void compare(const double* column, std::size_t count, AlertCondition::Comparison comparison,
+             double value, quint64* bits, std::size_t wordCount);
+
+// Byte columns such as the GPS fix status. The threshold is reduced to the
+// range of byte values that satisfy it, tested sixteen (SSE2) or thirty-two
+// (AVX2) drones per instruction.
+void compare(const quint8* column, std::size_t count, AlertCondition::Comparison comparison,
+             double value, quint64* bits, std::size_t wordCount);
+
+} // namespace AlertKernels
+
+#endif // ALERTKERNELS_H
@@ -0,0 +1,118 @@
+#include "alertprogram.h"
+#include "alertkernels.h"
+#include "fleetstate.h"
+#include "geofence.h"
+#include <algorithm>
+
+namespace {
+
+bool sameCondition(const AlertCondition& a, const AlertCondition& b) {
+    return a.field == b.field && a.comparison == b.comparison && a.value == b.value;
+}
+
+} // namespace
+
+AlertProgram::AlertProgram() = default;
+
+void AlertProgram::compile(const std::vector<AlertRule>& alertRules) {
+    predicates.clear();
+    terms.clear();
+    rules.clear();
+    rules.reserve(alertRules.size());
+
+    for (const AlertRule& rule : alertRules) {
+        rules.push_back(RuleSpan{terms.size(), rule.conditions.size()});
+        for (const AlertCondition& condition : rule.conditions) {
+            // Rules sharing a threshold share the predicate, so it is packed once per block
+            auto existing = std::find_if(predicates.begin(), predicates.end(),
+                [&condition](const AlertCondition& predicate) { return sameCondition(predicate, condition); });
+            if (existing == predicates.end()) {
+                existing = predicates.insert(predicates.end(), condition);
+            }
+            terms.push_back(static_cast<quint32>(existing - predicates.begin()));
+        }
+    }
+}
+
+std::size_t AlertProgram::ruleCount() const {
+    return rules.size();
+}
+
+std::size_t AlertProgram::predicateCount() const {
+    return predicates.size();
+}
+
+void AlertProgram::evaluate(const FleetState& fleet, const Geofence* geofence, std::size_t begin, std::size_t end,
+                            quint64* ruleBits, std::vector<quint64>& scratch) const {
+    const std::size_t count = std::min(end - begin, BLOCK_SIZE);
+    scratch.resize(predicates.size() * BLOCK_WORDS);
+
+    // Geofence status is derived from the position columns, so it is
+    // computed per block, only when a rule asks for it
+    quint8 geofenceStatus[BLOCK_SIZE];
+    bool geofenceClassified = false;
+
+    // Pass 1: one column scan per distinct predicate
+    for (std::size_t p = 0; p < predicates.size(); ++p) {
+        const AlertCondition& predicate = predicates[p];
+        quint64* bits = scratch.data() + p * BLOCK_WORDS;
+        const double* column = nullptr;
+        switch (predicate.field) {
+            case AlertCondition::BATTERY:
+                column = fleet.batteries();
+                break;
+            case AlertCondition::ALTITUDE:
+                column = fleet.altitudes();
+                break;
+            case AlertCondition::SPEED:
+                column = fleet.speeds();
+                break;
+            case AlertCondition::HEADING:
+                column = fleet.headings();
+                break;
+            case AlertCondition::LATITUDE:
+                column = fleet.latitudes();
+                break;
+            case AlertCondition::LONGITUDE:
+                column = fleet.longitudes();
+                break;
+            case AlertCondition::GPS_STATUS:
+                AlertKernels::compare(reinterpret_cast<const quint8*>(fleet.gpsStatuses()) + begin, count,
+                                      predicate.comparison, predicate.value, bits, BLOCK_WORDS);
+                continue;
+            case AlertCondition::GEOFENCE:
+                if (!geofenceClassified) {
+                    if (geofence) {
+                        geofence->classify(fleet.latitudes() + begin, fleet.longitudes() + begin, count, geofenceStatus);
+                    } else {
+                        std::fill(geofenceStatus, geofenceStatus + count, quint8(Geofence::CLEAR));
+                    }
+                    geofenceClassified = true;
+                }
+                AlertKernels::compare(geofenceStatus, count, predicate.comparison, predicate.value, bits, BLOCK_WORDS);
+                continue;
+        }
+        AlertKernels::compare(column + begin, count, predicate.comparison, predicate.value, bits, BLOCK_WORDS);
+    }
+
+    // Lanes holding a drone; a rule without conditions matches all of them
+    quint64 lanes[BLOCK_WORDS];
+    for (std::size_t word = 0; word < BLOCK_WORDS; ++word) {
+        const std::size_t first = word * 64;
+        lanes[word] = first >= count ? 0
+            : count - first >= 64 ? ~quint64(0) : (quint64(1) << (count - first)) - 1;
+    }
+
+    // Pass 2: each rule ANDs its predicates' words, 64 drones per operation
+    for (std::size_t r = 0; r < rules.size(); ++r) {
+        quint64* out = ruleBits + r * BLOCK_WORDS;
+        std::copy(lanes, lanes + BLOCK_WORDS, out);
+        const RuleSpan& span = rules[r];
+        for (std::size_t t = span.firstTerm; t < span.firstTerm + span.termCount; ++t) {
+            const quint64* bits = scratch.data() + terms[t] * BLOCK_WORDS;
+            for (std::size_t word = 0; word < BLOCK_WORDS; ++word) {
+                out[word] &= bits[word];
+            }
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef ALERTPROGRAM_H
+#define ALERTPROGRAM_H
+
+#include <QString>
+#include <QtGlobal>
+#include <cstddef>
+#include <vector>
+
+class FleetState;
+class Geofence;
+
+// One comparison of a telemetry column against a constant
+struct AlertCondition {
+    enum Field {
+        BATTERY = 0,
+        ALTITUDE = 1,
+        SPEED = 2,
+        HEADING = 3,
+        LATITUDE = 4,
+        LONGITUDE = 5,
+        GPS_STATUS = 6,   // compared as the GPSFixStatus value (0 no fix, 1 2D, 2 3D)
+        GEOFENCE = 7      // compared as the Geofence::Status value (0 clear, 1 outside inclusion, 2 inside exclusion)
+    };
+
+    enum Comparison {
+        LESS = 0,
+        LESS_EQUAL = 1,
+        GREATER = 2,
+        GREATER_EQUAL = 3,
+        EQUAL = 4,
+        NOT_EQUAL = 5
+    };
+
+    Field field;
+    Comparison comparison;
+    double value;
+};
+
+// An operator-declared alert: all conditions must hold for a drone
+struct AlertRule {
+    enum Trigger {
+        LEVEL = 0,  // raised when the conditions start to hold, cleared when they stop
+        EDGE = 1    // raised only when they start to hold; drones already matching are not reported
+    };
+
+    enum Severity {
+        INFO = 0,
+        WARNING = 1,
+        ERROR = 2
+    };
+
+    QString name;
+    Trigger trigger;
+    Severity severity;
+    std::vector<AlertCondition> conditions;
+    QString message;  // logged when raised; %1 is the drone name
+};
+
+// Rules compiled into a flat predicate program. Identical conditions across
+// rules become one predicate, each predicate is evaluated over a block of
+// fleet columns into a bitmask (one bit per drone), and each rule is the AND
+// of its predicates' bitmasks. Evaluation is branch-free per drone and its
+// cost is linear in drones x (predicates + rule terms). Blocks are small
+// enough that a column slice stays in L1 while every predicate on it runs.
+class AlertProgram {
+public:
+    // Drones evaluated per block; one rule's result for a block is BLOCK_WORDS words
+    static constexpr std::size_t BLOCK_SIZE = 1024;
+    static constexpr std::size_t BLOCK_WORDS = BLOCK_SIZE / 64;
+
+    AlertProgram();
+
+    void compile(const std::vector<AlertRule>& rules);
+
+    std::size_t ruleCount() const;
+    std::size_t predicateCount() const;
+
+    // Evaluates drones [begin, end) (at most BLOCK_SIZE) into ruleBits,
+    // ruleCount() x BLOCK_WORDS words; bit i of rule r is drone begin + i.
+    // scratch holds the predicate bitmasks between the two passes. GEOFENCE
+    // conditions classify the block against `geofence` once, before any of
+    // them is packed; without a geofence every drone is clear.
+    void evaluate(const FleetState& fleet, const Geofence* geofence, std::size_t begin, std::size_t end,
+                  quint64* ruleBits, std::vector<quint64>& scratch) const;
+
+private:
+    struct RuleSpan {
+        std::size_t firstTerm;
+        std::size_t termCount;
+    };
+
+    std::vector<AlertCondition> predicates;
+    std::vector<quint32> terms;  // predicate indices, rule after rule
+    std::vector<RuleSpan> rules;
+};
+
+#endif // ALERTPROGRAM_H
@@ -1,22 +1,44 @@
 #include "drone.h"
 #include "logger.h"
 
-Drone::Drone(QObject *parent)
+Drone::Drone(std::size_t fleetIndex, QObject *parent)
     : QObject(parent)
+    , fleetIndex(fleetIndex)
 {
     Logger::getInstance().log(Logger::INFO, "Drone object created");
 }
 
 void Drone::update(const DroneData& data) {
     currentData = data;
-    emit dataChanged(data);
+    snapshot.reset();
+    emit dataChanged(currentData);
 
-    Logger::getInstance().log(Logger::DEBUG, 
-        QString("Drone data updated - ID: %1, Battery: %2%")
-        .arg(data.getId())
-        .arg(data.getBattery(), 0, 'f', 1));
+    LOG_DEBUG(QString("Drone data updated - ID: %1, Battery: %2%")
+              .arg(data.getName())
+              .arg(data.getBattery(), 0, 'f', 1));
 }
 
-const DroneData& Drone::getData() const {
-    return currentData;
-}
\ No newline at end of file
+void Drone::updateFleet(const FleetSnapshotPtr& fleetSnapshot) {
+    if (!fleetSnapshot || fleetIndex >= fleetSnapshot->size()) {
+        return;
+    }
+
+    snapshot = fleetSnapshot;
+    emit snapshotChanged(snapshot);
+
+    LOG_DEBUG(QString("Drone data updated - ID: %1, Battery: %2%")
+              .arg(snapshot->nameAt(fleetIndex))
+              .arg(snapshot->batteries()[fleetIndex], 0, 'f', 1));
+}
+
+DroneData Drone::getData() const {
+    return snapshot ? snapshot->view(fleetIndex) : currentData;
+}
+
+FleetSnapshotPtr Drone::getSnapshot() const {
+    return snapshot;
+}
+
+std::size_t Drone::getFleetIndex() const {
+    return fleetIndex;
+}
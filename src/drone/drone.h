@@ -2,6 +2,7 @@
 #define DRONE_H
 
 #include <QObject>
+#include <cstddef>
 #include "dronedata.h"
 #include "observer.h"
 
@@ -9,18 +10,28 @@ class Drone : public QObject, public Observer {
     Q_OBJECT
 
 public:
-    explicit Drone(QObject *parent = nullptr);
+    // fleetIndex selects this drone within published fleet snapshots
+    explicit Drone(std::size_t fleetIndex = 0, QObject *parent = nullptr);
 
     // Observer pattern implementation
     void update(const DroneData& data) override;
 
-    const DroneData& getData() const;
+    // Keeps a reference to the tick's snapshot instead of copying the drone out
+    void updateFleet(const FleetSnapshotPtr& snapshot) override;
+
+    // This drone in the latest snapshot, or the last update() value
+    DroneData getData() const;
+    FleetSnapshotPtr getSnapshot() const;
+    std::size_t getFleetIndex() const;
 
 signals:
     void dataChanged(const DroneData& data);
+    void snapshotChanged(const FleetSnapshotPtr& snapshot);
 
 private:
+    std::size_t fleetIndex;
+    FleetSnapshotPtr snapshot;
     DroneData currentData;
 };
 
-#endif // DRONE_H
\ No newline at end of file
+#endif // DRONE_H
@@ -1,30 +1,40 @@
 #include "dronedata.h"
 
+namespace {
+DroneId defaultDroneId() {
+    static const DroneId id = DroneIdRegistry::getInstance().intern("DRONE-001");
+    return id;
+}
+}
+
 DroneData::DroneData()
-    : droneId("DRONE-001")
-    , latitude(28.4595)
-    , longitude(77.0266)
-    , altitude(100.0)
-    , heading(0.0)
-    , speed(0.0)
-    , battery(100.0)
-    , gpsStatus(GPSFixStatus::FIX_3D)
+    : DroneData(defaultDroneId(), 28.4595, 77.0266, 100.0, 0.0, 0.0, 100.0, GPSFixStatus::FIX_3D)
 {
 }
 
-DroneData::DroneData(const QString& id, double lat, double lon, double alt, 
+DroneData::DroneData(DroneId id, double lat, double lon, double alt,
                      double heading, double speed, double battery, GPSFixStatus gps)
-    : droneId(id)
-    , latitude(lat)
+    : latitude(lat)
     , longitude(lon)
-    , altitude(alt)
-    , heading(heading)
-    , speed(speed)
-    , battery(battery)
+    , altitude(static_cast<float>(alt))
+    , heading(static_cast<float>(heading))
+    , speed(static_cast<float>(speed))
+    , battery(static_cast<float>(battery))
+    , droneId(id)
     , gpsStatus(gps)
 {
 }
 
+DroneData::DroneData(const QString& name, double lat, double lon, double alt,
+                     double heading, double speed, double battery, GPSFixStatus gps)
+    : DroneData(DroneIdRegistry::getInstance().intern(name), lat, lon, alt, heading, speed, battery, gps)
+{
+}
+
+QString DroneData::getName() const {
+    return DroneIdRegistry::getInstance().nameOf(droneId);
+}
+
 QString DroneData::gpsStatusString() const {
     switch (gpsStatus) {
         case GPSFixStatus::NO_FIX: return "No Fix";
@@ -2,21 +2,31 @@
 #define DRONEDATA_H
 
 #include <QString>
+#include <QtGlobal>
+#include <type_traits>
+#include "droneidregistry.h"
 
-enum class GPSFixStatus {
+enum class GPSFixStatus : quint8 {
     NO_FIX = 0,
     FIX_2D = 1,
     FIX_3D = 2
 };
 
+// Fixed-size telemetry record. The drone is named by its interned ID, so a
+// record is plain bytes that can be memcpy'd into buffers, files or shared
+// memory. Coordinates keep double precision; the rest is packed as float.
 class DroneData {
 public:
     DroneData();
-    DroneData(const QString& id, double lat, double lon, double alt, 
+    DroneData(DroneId id, double lat, double lon, double alt,
+              double heading, double speed, double battery, GPSFixStatus gps);
+    // Interns the name in DroneIdRegistry
+    DroneData(const QString& name, double lat, double lon, double alt,
               double heading, double speed, double battery, GPSFixStatus gps);
 
     // Getters
-    QString getId() const { return droneId; }
+    DroneId getId() const { return droneId; }
+    QString getName() const;
     double getLatitude() const { return latitude; }
     double getLongitude() const { return longitude; }
     double getAltitude() const { return altitude; }
@@ -26,27 +36,30 @@ public:
     GPSFixStatus getGPSStatus() const { return gpsStatus; }
 
     // Setters
-    void setId(const QString& id) { droneId = id; }
+    void setId(DroneId id) { droneId = id; }
     void setLatitude(double lat) { latitude = lat; }
     void setLongitude(double lon) { longitude = lon; }
-    void setAltitude(double alt) { altitude = alt; }
-    void setHeading(double h) { heading = h; }
-    void setSpeed(double s) { speed = s; }
-    void setBattery(double b) { battery = b; }
+    void setAltitude(double alt) { altitude = static_cast<float>(alt); }
+    void setHeading(double h) { heading = static_cast<float>(h); }
+    void setSpeed(double s) { speed = static_cast<float>(s); }
+    void setBattery(double b) { battery = static_cast<float>(b); }
     void setGPSStatus(GPSFixStatus status) { gpsStatus = status; }
 
     // Utility
     QString gpsStatusString() const;
 
 private:
-    QString droneId;
     double latitude;
     double longitude;
-    double altitude;
-    double heading;
-    double speed;
-    double battery;
+    float altitude;
+    float heading;
+    float speed;
+    float battery;
+    DroneId droneId;
     GPSFixStatus gpsStatus;
 };
 
-#endif // DRONEDATA_H
\ No newline at end of file
+static_assert(std::is_trivially_copyable<DroneData>::value, "DroneData must stay memcpy-safe");
+static_assert(sizeof(DroneData) <= 64, "DroneData must fit in one cache line");
+
+#endif // DRONEDATA_H
@@ -0,0 +1,57 @@
+#include "droneidregistry.h"
+
+DroneIdRegistry& DroneIdRegistry::getInstance() {
+    static DroneIdRegistry instance;
+    return instance;
+}
+
+DroneId DroneIdRegistry::intern(const QString& name) {
+    {
+        QReadLocker readLocker(&lock);
+        auto found = ids.constFind(name);
+        if (found != ids.constEnd()) {
+            return found.value();
+        }
+    }
+
+    // Another thread may have interned the name between the two locks
+    QWriteLocker writeLocker(&lock);
+    auto found = ids.constFind(name);
+    if (found != ids.constEnd()) {
+        return found.value();
+    }
+    const DroneId id = static_cast<DroneId>(names.size());
+    names.push_back(name);
+    ids.insert(name, id);
+    return id;
+}
+
+std::vector<DroneId> DroneIdRegistry::intern(const std::vector<QString>& droneNames) {
+    std::vector<DroneId> result;
+    result.reserve(droneNames.size());
+
+    QWriteLocker writeLocker(&lock);
+    ids.reserve(static_cast<qsizetype>(names.size() + droneNames.size()));
+    for (const QString& name : droneNames) {
+        auto found = ids.constFind(name);
+        if (found != ids.constEnd()) {
+            result.push_back(found.value());
+            continue;
+        }
+        const DroneId id = static_cast<DroneId>(names.size());
+        names.push_back(name);
+        ids.insert(name, id);
+        result.push_back(id);
+    }
+    return result;
+}
+
+QString DroneIdRegistry::nameOf(DroneId id) const {
+    QReadLocker readLocker(&lock);
+    return id < names.size() ? names[id] : QString();
+}
+
+std::size_t DroneIdRegistry::size() const {
+    QReadLocker readLocker(&lock);
+    return names.size();
+}
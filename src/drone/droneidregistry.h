@@ -0,0 +1,43 @@
+#ifndef DRONEIDREGISTRY_H
+#define DRONEIDREGISTRY_H
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QtGlobal>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+// Compact drone identifier carried in telemetry records
+typedef quint32 DroneId;
+
+// Process-wide table that interns drone display names. Telemetry only
+// carries the numeric ID; the name is looked up for display, logging and
+// files. IDs are process-local, so anything written out stores the name.
+class DroneIdRegistry {
+public:
+    static DroneIdRegistry& getInstance();
+
+    // Returns the name's existing ID or assigns the next free one
+    DroneId intern(const QString& name);
+    // Bulk form for loaders: one lock for the whole list
+    std::vector<DroneId> intern(const std::vector<QString>& droneNames);
+
+    // Display name for an interned ID; empty for unknown IDs
+    QString nameOf(DroneId id) const;
+
+    std::size_t size() const;
+
+private:
+    DroneIdRegistry() = default;
+    ~DroneIdRegistry() = default;
+    DroneIdRegistry(const DroneIdRegistry&) = delete;
+    DroneIdRegistry& operator=(const DroneIdRegistry&) = delete;
+
+    mutable QReadWriteLock lock;
+    QHash<QString, DroneId> ids;
+    std::deque<QString> names;
+};
+
+#endif // DRONEIDREGISTRY_H
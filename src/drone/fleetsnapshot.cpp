@@ -0,0 +1,44 @@
+#include "fleetsnapshot.h"
+
+namespace {
+// Buffers kept for reuse; a tick rarely has more than a few snapshots alive
+const std::size_t MAX_FREE_BUFFERS = 4;
+}
+
+FleetSnapshotPool::FleetSnapshotPool()
+    : freeList(std::make_shared<FreeList>())
+{
+}
+
+FleetSnapshotPtr FleetSnapshotPool::capture(const FleetState& fleet) {
+    std::unique_ptr<FleetState> buffer;
+    {
+        std::lock_guard<std::mutex> lock(freeList->mutex);
+        if (!freeList->buffers.empty()) {
+            buffer = std::move(freeList->buffers.back());
+            freeList->buffers.pop_back();
+        }
+    }
+    if (!buffer) {
+        buffer = std::make_unique<FleetState>();
+    }
+    buffer->assignFrom(fleet);
+
+    std::weak_ptr<FreeList> owner = freeList;
+    return FleetSnapshotPtr(buffer.release(), [owner](const FleetState* snapshot) {
+        FleetState* recycled = const_cast<FleetState*>(snapshot);
+        if (std::shared_ptr<FreeList> list = owner.lock()) {
+            std::lock_guard<std::mutex> lock(list->mutex);
+            if (list->buffers.size() < MAX_FREE_BUFFERS) {
+                list->buffers.emplace_back(recycled);
+                return;
+            }
+        }
+        delete recycled;
+    });
+}
+
+std::size_t FleetSnapshotPool::freeBuffers() const {
+    std::lock_guard<std::mutex> lock(freeList->mutex);
+    return freeList->buffers.size();
+}
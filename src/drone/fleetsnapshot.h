@@ -0,0 +1,44 @@
+#ifndef FLEETSNAPSHOT_H
+#define FLEETSNAPSHOT_H
+
+#include <QMetaType>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "fleetstate.h"
+
+// Immutable fleet state published once per tick. Observers and signal
+// receivers share the same snapshot and may keep it past the call; it is
+// never modified after publication.
+typedef std::shared_ptr<const FleetState> FleetSnapshotPtr;
+Q_DECLARE_METATYPE(FleetSnapshotPtr)
+
+// Hands out snapshots backed by recycled FleetState buffers. When the last
+// reference to a snapshot is dropped (on any thread) its buffer returns to
+// the pool, so steady-state publishing allocates nothing and, while the
+// drone list is unchanged, copies only the numeric columns.
+class FleetSnapshotPool {
+public:
+    FleetSnapshotPool();
+
+    FleetSnapshotPool(const FleetSnapshotPool&) = delete;
+    FleetSnapshotPool& operator=(const FleetSnapshotPool&) = delete;
+
+    FleetSnapshotPtr capture(const FleetState& fleet);
+
+    // Buffers waiting for reuse
+    std::size_t freeBuffers() const;
+
+private:
+    struct FreeList {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<FleetState>> buffers;
+    };
+
+    // Shared with the snapshot deleters so buffers released after the pool
+    // is gone are simply freed
+    std::shared_ptr<FreeList> freeList;
+};
+
+#endif // FLEETSNAPSHOT_H
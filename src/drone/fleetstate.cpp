@@ -0,0 +1,126 @@
+#include "fleetstate.h"
+#include <atomic>
+
+namespace {
+std::atomic<quint64> nextLayoutVersion(1);
+}
+
+FleetState::FleetState()
+    : tick(0)
+    , simulationTime(0.0)
+    , layoutVersion(0)
+{
+    layoutChanged();
+}
+
+void FleetState::reserve(std::size_t count) {
+    ids.reserve(count);
+    latitude.reserve(count);
+    longitude.reserve(count);
+    altitude.reserve(count);
+    heading.reserve(count);
+    speed.reserve(count);
+    battery.reserve(count);
+    gpsStatus.reserve(count);
+}
+
+void FleetState::clear() {
+    ids.clear();
+    latitude.clear();
+    longitude.clear();
+    altitude.clear();
+    heading.clear();
+    speed.clear();
+    battery.clear();
+    gpsStatus.clear();
+    layoutChanged();
+}
+
+void FleetState::truncate(std::size_t count) {
+    if (count >= size()) {
+        return;
+    }
+    ids.resize(count);
+    latitude.resize(count);
+    longitude.resize(count);
+    altitude.resize(count);
+    heading.resize(count);
+    speed.resize(count);
+    battery.resize(count);
+    gpsStatus.resize(count);
+    layoutChanged();
+}
+
+std::size_t FleetState::addDrone(const DroneData& data) {
+    ids.push_back(data.getId());
+    latitude.push_back(data.getLatitude());
+    longitude.push_back(data.getLongitude());
+    altitude.push_back(data.getAltitude());
+    heading.push_back(data.getHeading());
+    speed.push_back(data.getSpeed());
+    battery.push_back(data.getBattery());
+    gpsStatus.push_back(data.getGPSStatus());
+    layoutChanged();
+    return ids.size() - 1;
+}
+
+std::size_t FleetState::addDrones(const DroneId* droneIds, std::size_t count) {
+    const std::size_t first = ids.size();
+    const DroneData defaults;
+    ids.insert(ids.end(), droneIds, droneIds + count);
+    latitude.resize(first + count, defaults.getLatitude());
+    longitude.resize(first + count, defaults.getLongitude());
+    altitude.resize(first + count, defaults.getAltitude());
+    heading.resize(first + count, defaults.getHeading());
+    speed.resize(first + count, defaults.getSpeed());
+    battery.resize(first + count, defaults.getBattery());
+    gpsStatus.resize(first + count, defaults.getGPSStatus());
+    layoutChanged();
+    return first;
+}
+
+DroneData FleetState::view(std::size_t index) const {
+    return DroneData(ids[index], latitude[index], longitude[index], altitude[index],
+                     heading[index], speed[index], battery[index], gpsStatus[index]);
+}
+
+void FleetState::assignFrom(const FleetState& source) {
+    if (layoutVersion != source.layoutVersion) {
+        *this = source;
+        return;
+    }
+
+    latitude.assign(source.latitude.begin(), source.latitude.end());
+    longitude.assign(source.longitude.begin(), source.longitude.end());
+    altitude.assign(source.altitude.begin(), source.altitude.end());
+    heading.assign(source.heading.begin(), source.heading.end());
+    speed.assign(source.speed.begin(), source.speed.end());
+    battery.assign(source.battery.begin(), source.battery.end());
+    gpsStatus.assign(source.gpsStatus.begin(), source.gpsStatus.end());
+    tick = source.tick;
+    simulationTime = source.simulationTime;
+}
+
+QString FleetState::nameAt(std::size_t index) const {
+    return DroneIdRegistry::getInstance().nameOf(ids[index]);
+}
+
+void FleetState::layoutChanged() {
+    layoutVersion = nextLayoutVersion.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FleetState::setClock(quint64 tickNumber, double time) {
+    tick = tickNumber;
+    simulationTime = time;
+}
+
+void FleetState::store(std::size_t index, const DroneData& data) {
+    // The ID column is owned by the fleet; views only write back telemetry
+    latitude[index] = data.getLatitude();
+    longitude[index] = data.getLongitude();
+    altitude[index] = data.getAltitude();
+    heading[index] = data.getHeading();
+    speed[index] = data.getSpeed();
+    battery[index] = data.getBattery();
+    gpsStatus[index] = data.getGPSStatus();
+}
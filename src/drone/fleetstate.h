@@ -0,0 +1,81 @@
+#ifndef FLEETSTATE_H
+#define FLEETSTATE_H
+
+#include <QString>
+#include <QtGlobal>
+#include <cstddef>
+#include <vector>
+#include "dronedata.h"
+
+// Struct-of-arrays telemetry store for a whole fleet.
+// Every field lives in its own contiguous column so a tick walks memory
+// linearly; DroneData is only materialized as a per-drone view.
+class FleetState {
+public:
+    FleetState();
+
+    std::size_t size() const { return ids.size(); }
+    bool isEmpty() const { return ids.empty(); }
+    void reserve(std::size_t count);
+    void clear();
+    void truncate(std::size_t count);
+
+    // Copies another fleet's state; the ID column is only copied when the
+    // layouts differ, so refreshing a same-layout copy is a few memcpy calls
+    void assignFrom(const FleetState& source);
+
+    // Row access
+    std::size_t addDrone(const DroneData& data);
+    // Appends `count` drones with DroneData() defaults in one layout change;
+    // bulk loaders then fill the columns directly. Returns the first index.
+    std::size_t addDrones(const DroneId* droneIds, std::size_t count);
+    DroneData view(std::size_t index) const;
+    void store(std::size_t index, const DroneData& data);
+
+    // Clock of the tick that produced the current values
+    quint64 getTick() const { return tick; }
+    double getSimulationTime() const { return simulationTime; }
+    void setClock(quint64 tickNumber, double time);
+
+    // Changes whenever drones are added or removed, so consumers can cache
+    // per-drone data such as the ID list until it moves. Versions are unique
+    // across all fleets; a copy shares its source's version (same drone list).
+    quint64 getLayoutVersion() const { return layoutVersion; }
+
+    // Column access
+    DroneId idAt(std::size_t index) const { return ids[index]; }
+    QString nameAt(std::size_t index) const;
+    double* latitudes() { return latitude.data(); }
+    double* longitudes() { return longitude.data(); }
+    double* altitudes() { return altitude.data(); }
+    double* headings() { return heading.data(); }
+    double* speeds() { return speed.data(); }
+    double* batteries() { return battery.data(); }
+    GPSFixStatus* gpsStatuses() { return gpsStatus.data(); }
+
+    const double* latitudes() const { return latitude.data(); }
+    const double* longitudes() const { return longitude.data(); }
+    const double* altitudes() const { return altitude.data(); }
+    const double* headings() const { return heading.data(); }
+    const double* speeds() const { return speed.data(); }
+    const double* batteries() const { return battery.data(); }
+    const GPSFixStatus* gpsStatuses() const { return gpsStatus.data(); }
+
+private:
+    std::vector<DroneId> ids;
+    std::vector<double> latitude;
+    std::vector<double> longitude;
+    std::vector<double> altitude;
+    std::vector<double> heading;
+    std::vector<double> speed;
+    std::vector<double> battery;
+    std::vector<GPSFixStatus> gpsStatus;
+
+    void layoutChanged();
+
+    quint64 tick;
+    double simulationTime;
+    quint64 layoutVersion;
+};
+
+#endif // FLEETSTATE_H
@@ -0,0 +1,35 @@
+#include "constantdrainmodel.h"
+#include "energykernels.h"
+#include "fleetstate.h"
+#include "simulationcheckpoint.h"
+#include <algorithm>
+
+ConstantDrainModel::ConstantDrainModel()
+    : drainRate(0.2)
+    , failureDrainRate(4.0)
+{
+}
+
+QString ConstantDrainModel::getModelName() const {
+    return "Constant Drain";
+}
+
+void ConstantDrainModel::updateBatteries(FleetState& fleet, std::size_t begin, std::size_t end,
+                                         const EnergyContext& context) {
+    double drain[EnergyKernels::BLOCK_SIZE];
+    std::fill(drain, drain + EnergyKernels::BLOCK_SIZE,
+              (context.failureMode ? failureDrainRate : drainRate) * context.dt);
+    for (std::size_t block = begin; block < end; block += EnergyKernels::BLOCK_SIZE) {
+        const std::size_t count = std::min(EnergyKernels::BLOCK_SIZE, end - block);
+        EnergyKernels::discharge(drain, fleet.batteries() + block, count);
+    }
+}
+
+void ConstantDrainModel::saveState(CheckpointWriter& writer) const {
+    writer.write(drainRate);
+    writer.write(failureDrainRate);
+}
+
+bool ConstantDrainModel::restoreState(CheckpointReader& reader) {
+    return reader.read(drainRate) && reader.read(failureDrainRate);
+}
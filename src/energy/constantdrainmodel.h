@@ -0,0 +1,22 @@
+#ifndef CONSTANTDRAINMODEL_H
+#define CONSTANTDRAINMODEL_H
+
+#include "energymodel.h"
+
+// The original model: a fixed percentage per simulated second, much faster
+// in failure mode, whatever the drone is doing
+class ConstantDrainModel : public EnergyModel {
+public:
+    ConstantDrainModel();
+    QString getModelName() const override;
+    void updateBatteries(FleetState& fleet, std::size_t begin, std::size_t end,
+                         const EnergyContext& context) override;
+    void saveState(CheckpointWriter& writer) const override;
+    bool restoreState(CheckpointReader& reader) override;
+
+private:
+    double drainRate;         // percent per simulated second
+    double failureDrainRate;  // percent per simulated second in failure mode
+};
+
+#endif // CONSTANTDRAINMODEL_H
@@ -0,0 +1,180 @@
+#include "energykernels.h"
+#include "movementkernels.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ENERGY_KERNELS_X86 1
+#define KERNEL_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define ENERGY_KERNELS_X86 1
+#define KERNEL_TARGET(isa)
+#include <immintrin.h>
+#endif
+
+namespace EnergyKernels {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Scalar reference. Every vector path below mirrors these operations exactly.
+// ---------------------------------------------------------------------------
+
+inline void powerDrainScalar(const PowerParams& params, const PowerLanes& lanes,
+                             double* drainOut, std::size_t count, std::size_t begin) {
+    const double inverseDt = 1.0 / params.dt;
+    for (std::size_t i = begin; i < count; ++i) {
+        double filtered = lanes.filteredAltitude[i];
+        double delta = (lanes.altitude[i] - filtered) * params.smoothing;
+        lanes.filteredAltitude[i] = filtered + delta;
+        double climbRate = delta * inverseDt;
+
+        double speed = lanes.speed[i];
+        double power = params.hoverPowerW + params.parasiticCoefficient * (speed * speed * speed);
+        power = power + params.climbCoefficient * std::max(climbRate, 0.0);
+        power = power + params.descentCoefficient * std::min(climbRate, 0.0);
+        power = std::max(power, params.minimumPowerW) * params.loadFactor;
+        drainOut[i] = power * params.dt * lanes.percentPerJoule[i];
+    }
+}
+
+inline void dischargeScalar(const double* drain, double* battery, std::size_t count, std::size_t begin) {
+    for (std::size_t i = begin; i < count; ++i) {
+        battery[i] = std::max(0.0, battery[i] - drain[i]);
+    }
+}
+
+#ifdef ENERGY_KERNELS_X86
+
+// ---------------------------------------------------------------------------
+// SSE2: two drones per instruction
+// ---------------------------------------------------------------------------
+
+KERNEL_TARGET("sse2")
+void powerDrainSse2(const PowerParams& params, const PowerLanes& lanes,
+                    double* drainOut, std::size_t count) {
+    const __m128d smoothing = _mm_set1_pd(params.smoothing);
+    const __m128d inverseDt = _mm_set1_pd(1.0 / params.dt);
+    const __m128d hoverPower = _mm_set1_pd(params.hoverPowerW);
+    const __m128d parasitic = _mm_set1_pd(params.parasiticCoefficient);
+    const __m128d climbCoefficient = _mm_set1_pd(params.climbCoefficient);
+    const __m128d descentCoefficient = _mm_set1_pd(params.descentCoefficient);
+    const __m128d minimumPower = _mm_set1_pd(params.minimumPowerW);
+    const __m128d loadFactor = _mm_set1_pd(params.loadFactor);
+    const __m128d dt = _mm_set1_pd(params.dt);
+    const __m128d zero = _mm_setzero_pd();
+
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d filtered = _mm_loadu_pd(lanes.filteredAltitude + i);
+        __m128d delta = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(lanes.altitude + i), filtered), smoothing);
+        _mm_storeu_pd(lanes.filteredAltitude + i, _mm_add_pd(filtered, delta));
+        __m128d climbRate = _mm_mul_pd(delta, inverseDt);
+
+        __m128d speed = _mm_loadu_pd(lanes.speed + i);
+        __m128d power = _mm_add_pd(hoverPower,
+                                   _mm_mul_pd(parasitic, _mm_mul_pd(_mm_mul_pd(speed, speed), speed)));
+        power = _mm_add_pd(power, _mm_mul_pd(climbCoefficient, _mm_max_pd(climbRate, zero)));
+        power = _mm_add_pd(power, _mm_mul_pd(descentCoefficient, _mm_min_pd(climbRate, zero)));
+        power = _mm_mul_pd(_mm_max_pd(power, minimumPower), loadFactor);
+        _mm_storeu_pd(drainOut + i, _mm_mul_pd(_mm_mul_pd(power, dt), _mm_loadu_pd(lanes.percentPerJoule + i)));
+    }
+    powerDrainScalar(params, lanes, drainOut, count, i);
+}
+
+KERNEL_TARGET("sse2")
+void dischargeSse2(const double* drain, double* battery, std::size_t count) {
+    const __m128d zero = _mm_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(battery + i, _mm_max_pd(_mm_sub_pd(_mm_loadu_pd(battery + i), _mm_loadu_pd(drain + i)), zero));
+    }
+    dischargeScalar(drain, battery, count, i);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2: four drones per instruction
+// ---------------------------------------------------------------------------
+
+KERNEL_TARGET("avx2")
+void powerDrainAvx2(const PowerParams& params, const PowerLanes& lanes,
+                    double* drainOut, std::size_t count) {
+    const __m256d smoothing = _mm256_set1_pd(params.smoothing);
+    const __m256d inverseDt = _mm256_set1_pd(1.0 / params.dt);
+    const __m256d hoverPower = _mm256_set1_pd(params.hoverPowerW);
+    const __m256d parasitic = _mm256_set1_pd(params.parasiticCoefficient);
+    const __m256d climbCoefficient = _mm256_set1_pd(params.climbCoefficient);
+    const __m256d descentCoefficient = _mm256_set1_pd(params.descentCoefficient);
+    const __m256d minimumPower = _mm256_set1_pd(params.minimumPowerW);
+    const __m256d loadFactor = _mm256_set1_pd(params.loadFactor);
+    const __m256d dt = _mm256_set1_pd(params.dt);
+    const __m256d zero = _mm256_setzero_pd();
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d filtered = _mm256_loadu_pd(lanes.filteredAltitude + i);
+        __m256d delta = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(lanes.altitude + i), filtered), smoothing);
+        _mm256_storeu_pd(lanes.filteredAltitude + i, _mm256_add_pd(filtered, delta));
+        __m256d climbRate = _mm256_mul_pd(delta, inverseDt);
+
+        __m256d speed = _mm256_loadu_pd(lanes.speed + i);
+        __m256d power = _mm256_add_pd(hoverPower,
+            _mm256_mul_pd(parasitic, _mm256_mul_pd(_mm256_mul_pd(speed, speed), speed)));
+        power = _mm256_add_pd(power, _mm256_mul_pd(climbCoefficient, _mm256_max_pd(climbRate, zero)));
+        power = _mm256_add_pd(power, _mm256_mul_pd(descentCoefficient, _mm256_min_pd(climbRate, zero)));
+        power = _mm256_mul_pd(_mm256_max_pd(power, minimumPower), loadFactor);
+        _mm256_storeu_pd(drainOut + i,
+                         _mm256_mul_pd(_mm256_mul_pd(power, dt), _mm256_loadu_pd(lanes.percentPerJoule + i)));
+    }
+    powerDrainScalar(params, lanes, drainOut, count, i);
+}
+
+KERNEL_TARGET("avx2")
+void dischargeAvx2(const double* drain, double* battery, std::size_t count) {
+    const __m256d zero = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm256_storeu_pd(battery + i,
+                         _mm256_max_pd(_mm256_sub_pd(_mm256_loadu_pd(battery + i), _mm256_loadu_pd(drain + i)), zero));
+    }
+    dischargeScalar(drain, battery, count, i);
+}
+
+#endif // ENERGY_KERNELS_X86
+
+} // namespace
+
+void powerDrain(const PowerParams& params, const PowerLanes& lanes,
+                double* drainOut, std::size_t count) {
+    switch (MovementKernels::activeInstructionSet()) {
+#ifdef ENERGY_KERNELS_X86
+        case MovementKernels::AVX2:
+            powerDrainAvx2(params, lanes, drainOut, count);
+            return;
+        case MovementKernels::SSE2:
+            powerDrainSse2(params, lanes, drainOut, count);
+            return;
+#endif
+        default:
+            powerDrainScalar(params, lanes, drainOut, count, 0);
+            return;
+    }
+}
+
+void discharge(const double* drain, double* battery, std::size_t count) {
+    switch (MovementKernels::activeInstructionSet()) {
+#ifdef ENERGY_KERNELS_X86
+        case MovementKernels::AVX2:
+            dischargeAvx2(drain, battery, count);
+            return;
+        case MovementKernels::SSE2:
+            dischargeSse2(drain, battery, count);
+            return;
+#endif
+        default:
+            dischargeScalar(drain, battery, count, 0);
+            return;
+    }
+}
+
+} // namespace EnergyKernels
@@ -0,0 +1,44 @@
+#ifndef ENERGYKERNELS_H
+#define ENERGYKERNELS_H
+
+#include <cstddef>
+
+// Vectorized battery kernels shared by the energy models. Like the movement
+// kernels they come in AVX2, SSE2 and scalar variants that perform the same
+// IEEE operations in the same order, dispatch on
+// MovementKernels::activeInstructionSet() and contain no per-drone branches.
+namespace EnergyKernels {
+
+// Drones per kernel call when callers stage drains on the stack
+const std::size_t BLOCK_SIZE = 256;
+
+struct PowerParams {
+    double hoverPowerW;           // electrical power to hold altitude at rest
+    double parasiticCoefficient;  // W per (m/s)^3 of airspeed
+    double climbCoefficient;      // W per m/s of climb (m * g / efficiency)
+    double descentCoefficient;    // W returned per m/s of descent
+    double minimumPowerW;         // floor for steep descents
+    double loadFactor;            // multiplies the total, e.g. under failure
+    double smoothing;             // altitude low-pass weight for this step
+    double dt;                    // seconds covered by the step
+};
+
+struct PowerLanes {
+    const double* altitude;
+    const double* speed;
+    const double* percentPerJoule;  // 100 / usable battery energy
+    double* filteredAltitude;       // low-passed altitude, updated in place
+};
+
+// Battery percentage drained by each drone over one step. Climb rate comes
+// from the low-passed altitude so per-tick altitude noise does not read as
+// climbing and the result does not depend on the tick rate.
+void powerDrain(const PowerParams& params, const PowerLanes& lanes,
+                double* drainOut, std::size_t count);
+
+// battery = max(0, battery - drain)
+void discharge(const double* drain, double* battery, std::size_t count);
+
+} // namespace EnergyKernels
+
+#endif // ENERGYKERNELS_H
@@ -0,0 +1,16 @@
+#include "energymodel.h"
+#include "fleetstate.h"
+
+void EnergyModel::prepare(const FleetState& fleet, const EnergyContext& context) {
+    Q_UNUSED(fleet);
+    Q_UNUSED(context);
+}
+
+void EnergyModel::saveState(CheckpointWriter& writer) const {
+    Q_UNUSED(writer);
+}
+
+bool EnergyModel::restoreState(CheckpointReader& reader) {
+    Q_UNUSED(reader);
+    return true;
+}
@@ -0,0 +1,42 @@
+#ifndef ENERGYMODEL_H
+#define ENERGYMODEL_H
+
+#include <QString>
+#include <QtGlobal>
+#include <cstddef>
+
+class CheckpointReader;
+class CheckpointWriter;
+class FleetState;
+
+// Per-tick inputs shared by every energy model call within one tick.
+// dt is the simulated time covered by the tick, in seconds.
+struct EnergyContext {
+    quint64 tick;
+    quint64 seed;
+    double dt;
+    bool failureMode;
+};
+
+// Strategy for how batteries drain. Models run after movement, so they see
+// this tick's speed and altitude, and work on whole column ranges.
+class EnergyModel {
+public:
+    virtual ~EnergyModel() = default;
+
+    virtual QString getModelName() const = 0;
+
+    // Called once per tick, on one thread, before any updateBatteries() call;
+    // models size their per-drone state here
+    virtual void prepare(const FleetState& fleet, const EnergyContext& context);
+
+    // Drains drones [begin, end); disjoint ranges may run concurrently
+    virtual void updateBatteries(FleetState& fleet, std::size_t begin, std::size_t end,
+                                 const EnergyContext& context) = 0;
+
+    // Checkpoint support, as for movement strategies
+    virtual void saveState(CheckpointWriter& writer) const;
+    virtual bool restoreState(CheckpointReader& reader);
+};
+
+#endif // ENERGYMODEL_H
@@ -0,0 +1,103 @@
+#include "physicsenergymodel.h"
+#include "energykernels.h"
+#include "fleetstate.h"
+#include "philoxrng.h"
+#include "simulationcheckpoint.h"
+#include <QtMath>
+
+namespace {
+const double SECONDS_PER_HOUR = 3600.0;
+}
+
+PhysicsEnergyModel::PhysicsEnergyModel()
+    : capacityWh(77.0)
+    , minimumHealth(0.85)
+    , hoverPowerW(180.0)
+    , parasiticCoefficient(0.15)
+    , climbCoefficient(28.0)  // 2 kg * 9.81 m/s^2 / 0.7 propulsive efficiency
+    , descentCoefficient(10.0)
+    , minimumPowerW(90.0)
+    , failureLoadFactor(10.0)
+    , climbTimeConstant(1.0)
+    , healthSeed(0)
+{
+}
+
+QString PhysicsEnergyModel::getModelName() const {
+    return "Physics";
+}
+
+void PhysicsEnergyModel::prepare(const FleetState& fleet, const EnergyContext& context) {
+    // New drones start level; departed drones drop their state
+    const std::size_t known = filteredAltitude.size();
+    filteredAltitude.resize(fleet.size());
+    for (std::size_t i = known; i < fleet.size(); ++i) {
+        filteredAltitude[i] = fleet.altitudes()[i];
+    }
+
+    if (percentPerJoule.size() != fleet.size() || healthSeed != context.seed) {
+        assignBatteryHealth(fleet.size(), context.seed);
+    }
+}
+
+void PhysicsEnergyModel::assignBatteryHealth(std::size_t count, quint64 seed) {
+    // One ENERGY draw per drone, keyed by its index like the movement streams
+    const PhiloxRng random(seed, PhiloxRng::ENERGY);
+    const double usableJoules = capacityWh * SECONDS_PER_HOUR;
+    percentPerJoule.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const double health = minimumHealth + (1.0 - minimumHealth) * random.uniform(i, 0, 0);
+        percentPerJoule[i] = 100.0 / (usableJoules * health);
+    }
+    healthSeed = seed;
+}
+
+void PhysicsEnergyModel::updateBatteries(FleetState& fleet, std::size_t begin, std::size_t end,
+                                         const EnergyContext& context) {
+    const EnergyKernels::PowerParams params{
+        hoverPowerW,
+        parasiticCoefficient,
+        climbCoefficient,
+        descentCoefficient,
+        minimumPowerW,
+        context.failureMode ? failureLoadFactor : 1.0,
+        1.0 - qExp(-context.dt / climbTimeConstant),
+        context.dt
+    };
+    double drain[EnergyKernels::BLOCK_SIZE];
+
+    for (std::size_t block = begin; block < end; block += EnergyKernels::BLOCK_SIZE) {
+        const std::size_t count = qMin(EnergyKernels::BLOCK_SIZE, end - block);
+        const EnergyKernels::PowerLanes lanes{
+            fleet.altitudes() + block,
+            fleet.speeds() + block,
+            percentPerJoule.data() + block,
+            filteredAltitude.data() + block
+        };
+        EnergyKernels::powerDrain(params, lanes, drain, count);
+        EnergyKernels::discharge(drain, fleet.batteries() + block, count);
+    }
+}
+
+void PhysicsEnergyModel::saveState(CheckpointWriter& writer) const {
+    writer.write(capacityWh);
+    writer.write(minimumHealth);
+    writer.write(hoverPowerW);
+    writer.write(parasiticCoefficient);
+    writer.write(climbCoefficient);
+    writer.write(descentCoefficient);
+    writer.write(minimumPowerW);
+    writer.write(failureLoadFactor);
+    writer.write(climbTimeConstant);
+    writer.writeArray(filteredAltitude);
+}
+
+bool PhysicsEnergyModel::restoreState(CheckpointReader& reader) {
+    // Health factors are rebuilt from the seed on the next prepare()
+    percentPerJoule.clear();
+    return reader.read(capacityWh) && reader.read(minimumHealth) && reader.read(hoverPowerW)
+        && reader.read(parasiticCoefficient) && reader.read(climbCoefficient)
+        && reader.read(descentCoefficient) && reader.read(minimumPowerW)
+        && reader.read(failureLoadFactor) && reader.read(climbTimeConstant)
+        && reader.readArray(filteredAltitude);
+}
@@ -0,0 +1,43 @@
+#ifndef PHYSICSENERGYMODEL_H
+#define PHYSICSENERGYMODEL_H
+
+#include "energymodel.h"
+#include <QtGlobal>
+#include <vector>
+
+// Power-based multirotor model: electrical power is hover load plus a
+// parasitic-drag term in speed^3 and a climb term (descent returns a
+// little), scaled up under failure. Each drone's usable capacity is
+// derated by a seeded battery-health factor, so endurance varies across
+// the fleet and between seeds. Defaults describe a ~2 kg quadcopter with
+// a 77 Wh pack: about 25 minutes in a steady hover.
+class PhysicsEnergyModel : public EnergyModel {
+public:
+    PhysicsEnergyModel();
+    QString getModelName() const override;
+    void prepare(const FleetState& fleet, const EnergyContext& context) override;
+    void updateBatteries(FleetState& fleet, std::size_t begin, std::size_t end,
+                         const EnergyContext& context) override;
+    void saveState(CheckpointWriter& writer) const override;
+    bool restoreState(CheckpointReader& reader) override;
+
+private:
+    void assignBatteryHealth(std::size_t count, quint64 seed);
+
+    double capacityWh;
+    double minimumHealth;          // health is uniform in [minimumHealth, 1]
+    double hoverPowerW;
+    double parasiticCoefficient;   // W per (m/s)^3
+    double climbCoefficient;       // W per m/s climbed
+    double descentCoefficient;     // W returned per m/s descended
+    double minimumPowerW;
+    double failureLoadFactor;
+    double climbTimeConstant;      // seconds; altitude low-pass for climb rate
+
+    // Per drone, indexed by fleet position
+    std::vector<double> filteredAltitude;
+    std::vector<double> percentPerJoule;  // derived from seed and health, not saved
+    quint64 healthSeed;
+};
+
+#endif // PHYSICSENERGYMODEL_H
@@ -0,0 +1,414 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QtMath>
+#include "dronesimulator.h"
+#include "simulationfactory.h"
+#include "movementstrategy.h"
+#include "energymodel.h"
+#include "logger.h"
+#include "telemetryrecorder.h"
+#include "telemetryplayer.h"
+#include "conflictdetector.h"
+#include "ensemblerunner.h"
+#include "alertengine.h"
+#include "geofence.h"
+#include <QTimer>
+#ifdef DRONE_SIM_NETWORK
+#include "telemetrystreamer.h"
+#include "telemetryreceiver.h"
+#endif
+
+// Headless batch runner: steps the simulation faster than real time with
+// no window and no update timer, then reports throughput.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("Drone Telemetry Batch Runner");
+    app.setApplicationVersion("1.0.0");
+    app.setOrganizationName("DroneSimulation");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs a drone scenario for a simulated duration as fast as the CPU allows.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption durationOption("duration", "Simulated seconds to run.", "seconds", "3600");
+    QCommandLineOption dronesOption("drones", "Number of drones in the fleet.", "count", "1");
+    QCommandLineOption strategyOption("strategy", "Movement strategy: hover or randomwalk.", "name", "hover");
+    QCommandLineOption rateOption("rate", "Tick rate in Hz (2 to 1000).", "hz", "2");
+    QCommandLineOption energyOption("energy", "Energy model: physics or constant.", "name", "physics");
+    QCommandLineOption threadsOption("threads", "Tick engine threads (0 = all cores).", "count", "0");
+    QCommandLineOption seedOption("seed", "Random seed for a reproducible run.", "seed");
+    QCommandLineOption failureOption("failure", "Run with failure mode enabled.");
+    QCommandLineOption logOverflowOption("log-overflow",
+        "When the async log buffer is full: block, drop or count.", "policy", "count");
+    QCommandLineOption recordOption("record", "Record every tick to this binary telemetry file.", "path");
+    QCommandLineOption replayOption("replay", "Replay this recording into the observers instead of simulating.", "path");
+    QCommandLineOption replaySpeedOption("replay-speed", "Replay speed factor (0 = as fast as possible).", "factor", "0");
+    QCommandLineOption logFileOption("log-file", "Write the event log to this file.", "path");
+    QCommandLineOption separationOption("separation",
+        "Report drones closer than this many metres (0 = no conflict detection).", "metres", "0");
+    parser.addOption(durationOption);
+    parser.addOption(dronesOption);
+    parser.addOption(strategyOption);
+    parser.addOption(rateOption);
+    parser.addOption(energyOption);
+    parser.addOption(threadsOption);
+    parser.addOption(seedOption);
+    parser.addOption(failureOption);
+    parser.addOption(logOverflowOption);
+    parser.addOption(recordOption);
+    parser.addOption(replayOption);
+    parser.addOption(replaySpeedOption);
+    parser.addOption(logFileOption);
+    parser.addOption(separationOption);
+    QCommandLineOption restoreOption("restore",
+        "Continue from this checkpoint (fleet, strategies and rate come from the file).", "path");
+    QCommandLineOption checkpointOption("checkpoint", "Save a checkpoint to this file when the run ends.", "path");
+    QCommandLineOption ensembleOption("ensemble",
+        "Run this many independent seeded simulations and report endurance statistics.", "runs");
+    QCommandLineOption lowBatteryOption("low-battery",
+        "Battery percentage counted as low in --ensemble statistics.", "percent", "20");
+    QCommandLineOption alertsOption("alerts",
+        "Evaluate the alert rules in this JSON file instead of the built-in battery, GPS and geofence rules.", "path");
+    QCommandLineOption geofenceOption("geofence",
+        "Load inclusion and exclusion zones from this JSON file instead of the built-in operating area.", "path");
+    parser.addOption(restoreOption);
+    parser.addOption(checkpointOption);
+    parser.addOption(ensembleOption);
+    parser.addOption(lowBatteryOption);
+    parser.addOption(alertsOption);
+    parser.addOption(geofenceOption);
+#ifdef DRONE_SIM_NETWORK
+    // Only in builds with DRONE_SIM_NETWORK (Qt Network)
+    QCommandLineOption streamOption("stream", "Stream every tick as UDP datagrams to this address.", "host:port");
+    QCommandLineOption keyframeOption("stream-keyframe",
+        "Ticks between full-state stream frames (1 = no delta encoding).", "ticks",
+        QString::number(TelemetryStreamer::DEFAULT_KEYFRAME_INTERVAL));
+    QCommandLineOption listenOption("listen",
+        "Drive the observers from a UDP telemetry stream on this port for --duration wall seconds.", "port");
+    parser.addOption(streamOption);
+    parser.addOption(keyframeOption);
+    parser.addOption(listenOption);
+#endif
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    bool ok = false;
+    const double duration = parser.value(durationOption).toDouble(&ok);
+    if (!ok || duration <= 0) {
+        err << "Invalid --duration: " << parser.value(durationOption) << Qt::endl;
+        return 1;
+    }
+    const qulonglong droneCount = parser.value(dronesOption).toULongLong(&ok);
+    if (!ok || droneCount == 0) {
+        err << "Invalid --drones: " << parser.value(dronesOption) << Qt::endl;
+        return 1;
+    }
+    const double rate = parser.value(rateOption).toDouble(&ok);
+    if (!ok || rate < TickScheduler::MIN_RATE_HZ || rate > TickScheduler::MAX_RATE_HZ) {
+        err << "Invalid --rate: " << parser.value(rateOption) << Qt::endl;
+        return 1;
+    }
+    const double replaySpeed = parser.value(replaySpeedOption).toDouble(&ok);
+    if (!ok || replaySpeed < 0) {
+        err << "Invalid --replay-speed: " << parser.value(replaySpeedOption) << Qt::endl;
+        return 1;
+    }
+    const double separation = parser.value(separationOption).toDouble(&ok);
+    if (!ok || separation < 0) {
+        err << "Invalid --separation: " << parser.value(separationOption) << Qt::endl;
+        return 1;
+    }
+#ifdef DRONE_SIM_NETWORK
+    const int keyframeInterval = parser.value(keyframeOption).toInt(&ok);
+    if (!ok || keyframeInterval < 1) {
+        err << "Invalid --stream-keyframe: " << parser.value(keyframeOption) << Qt::endl;
+        return 1;
+    }
+    QString streamHost;
+    quint16 streamPort = 0;
+    if (parser.isSet(streamOption)) {
+        const QString target = parser.value(streamOption);
+        const int colon = target.lastIndexOf(':');
+        streamHost = target.left(colon);
+        streamPort = target.mid(colon + 1).toUShort(&ok);
+        if (colon <= 0 || !ok || streamPort == 0) {
+            err << "Invalid --stream: " << target << Qt::endl;
+            return 1;
+        }
+    }
+    const quint16 listenPort = parser.isSet(listenOption) ? parser.value(listenOption).toUShort(&ok) : 0;
+    if (parser.isSet(listenOption) && (!ok || listenPort == 0)) {
+        err << "Invalid --listen: " << parser.value(listenOption) << Qt::endl;
+        return 1;
+    }
+#endif
+    const int threads = parser.value(threadsOption).toInt(&ok);
+    if (!ok || threads < 0) {
+        err << "Invalid --threads: " << parser.value(threadsOption) << Qt::endl;
+        return 1;
+    }
+
+    const quint64 seed = parser.isSet(seedOption) ? parser.value(seedOption).toULongLong(&ok) : 0;
+    if (parser.isSet(seedOption) && !ok) {
+        err << "Invalid --seed: " << parser.value(seedOption) << Qt::endl;
+        return 1;
+    }
+
+    const qulonglong ensembleRuns = parser.isSet(ensembleOption) ? parser.value(ensembleOption).toULongLong(&ok) : 0;
+    if (parser.isSet(ensembleOption) && (!ok || ensembleRuns == 0)) {
+        err << "Invalid --ensemble: " << parser.value(ensembleOption) << Qt::endl;
+        return 1;
+    }
+    const double lowBattery = parser.value(lowBatteryOption).toDouble(&ok);
+    if (!ok || lowBattery < 0 || lowBattery > 100) {
+        err << "Invalid --low-battery: " << parser.value(lowBatteryOption) << Qt::endl;
+        return 1;
+    }
+
+    SimulationFactory::MovementType movementType;
+    const QString strategyName = parser.value(strategyOption).toLower();
+    if (strategyName == "hover") {
+        movementType = SimulationFactory::HOVER_MOVEMENT;
+    } else if (strategyName == "randomwalk") {
+        movementType = SimulationFactory::RANDOM_WALK_MOVEMENT;
+    } else {
+        err << "Unknown --strategy: " << parser.value(strategyOption) << Qt::endl;
+        return 1;
+    }
+
+    SimulationFactory::EnergyModelType energyModelType;
+    const QString energyName = parser.value(energyOption).toLower();
+    if (energyName == "physics") {
+        energyModelType = SimulationFactory::PHYSICS_ENERGY;
+    } else if (energyName == "constant") {
+        energyModelType = SimulationFactory::CONSTANT_DRAIN_ENERGY;
+    } else {
+        err << "Unknown --energy: " << parser.value(energyOption) << Qt::endl;
+        return 1;
+    }
+
+    Logger::OverflowPolicy overflowPolicy;
+    const QString overflowName = parser.value(logOverflowOption).toLower();
+    if (overflowName == "block") {
+        overflowPolicy = Logger::BLOCK;
+    } else if (overflowName == "drop") {
+        overflowPolicy = Logger::DROP;
+    } else if (overflowName == "count") {
+        overflowPolicy = Logger::DROP_AND_COUNT;
+    } else {
+        err << "Unknown --log-overflow: " << parser.value(logOverflowOption) << Qt::endl;
+        return 1;
+    }
+
+    if (parser.isSet(logFileOption)) {
+        Logger::getInstance().setLogFile(parser.value(logFileOption));
+    }
+    // Keep file writes off the tick threads
+    Logger::getInstance().setOverflowPolicy(overflowPolicy);
+    Logger::getInstance().setAsync(true);
+    Logger::getInstance().log(Logger::INFO, "Batch runner starting...");
+
+    if (ensembleRuns > 0) {
+        EnsembleRunner ensemble;
+        ensemble.setRunCount(ensembleRuns);
+        ensemble.setDronesPerRun(droneCount);
+        ensemble.setDuration(duration);
+        ensemble.setTickRate(rate);
+        ensemble.setMovementType(movementType);
+        ensemble.setEnergyModelType(energyModelType);
+        ensemble.setFailureMode(parser.isSet(failureOption));
+        ensemble.setLowBatteryThreshold(lowBattery);
+        ensemble.setThreadCount(threads);
+        if (parser.isSet(seedOption)) {
+            ensemble.setBaseSeed(seed);
+        }
+        // About twenty progress lines per ensemble
+        ensemble.setProgressCallback([&out, ensembleRuns](const EnsembleStatistics& statistics) {
+            out << "Completed runs:    " << statistics.getCompletedRuns() << " / " << ensembleRuns
+                << ", mean final battery " << QString::number(statistics.meanFinalBattery(), 'f', 1) << "%" << Qt::endl;
+        }, qMax<qulonglong>(1, ensembleRuns / 20));
+
+        QElapsedTimer wallClock;
+        wallClock.start();
+        const EnsembleStatistics statistics = ensemble.run();
+        const double wallSeconds = qMax(wallClock.nsecsElapsed() / 1e9, 1e-9);
+
+        out << "Runs:              " << statistics.getCompletedRuns() << Qt::endl;
+        out << "Drones per run:    " << droneCount << Qt::endl;
+        out << "Threads:           " << ensemble.getThreadCount() << Qt::endl;
+        out << "Base seed:         " << ensemble.getBaseSeed() << Qt::endl;
+        out << "Wall time:         " << QString::number(wallSeconds, 'f', 3) << " s" << Qt::endl;
+        out << "Runs/second:       " << QString::number(statistics.getCompletedRuns() / wallSeconds, 'f', 1) << Qt::endl;
+        out << "Mean final battery:" << QString::number(statistics.meanFinalBattery(), 'f', 2) << "%" << Qt::endl;
+        out << "Mean displacement: " << QString::number(statistics.meanDisplacementMeters(), 'f', 1) << " m" << Qt::endl;
+        out << "Max displacement:  " << QString::number(statistics.getMaxDisplacementMeters(), 'f', 1) << " m" << Qt::endl;
+        out << "Never below " << lowBattery << "%:  " << statistics.getNeverLowCount() << " of "
+            << statistics.getDroneSamples() << " drones" << Qt::endl;
+        out << "Below " << lowBattery << "% by (cumulative):" << Qt::endl;
+        const std::vector<quint64>& histogram = statistics.getLowBatteryHistogram();
+        for (std::size_t bin = 0; bin < histogram.size(); ++bin) {
+            if (histogram[bin] == 0) {
+                continue;
+            }
+            const double until = (bin + 1) * statistics.getLowBatteryBinSeconds();
+            out << "  " << QString::number(until, 'f', 0).rightJustified(8) << " s  "
+                << QString::number(100.0 * statistics.fractionLowBefore(until), 'f', 2) << "%" << Qt::endl;
+        }
+        Logger::getInstance().flush();
+        return 0;
+    }
+
+    auto simulator = SimulationFactory::createSimulator(SimulationFactory::BASIC_SIMULATOR);
+    simulator->setThreadCount(threads);
+    simulator->setTickRate(rate);
+    simulator->setFleetSize(droneCount);
+    simulator->setMovementStrategy(SimulationFactory::createMovementStrategy(movementType));
+    simulator->setEnergyModel(SimulationFactory::createEnergyModel(energyModelType));
+    // --seed and --failure still apply on top, so a fork can diverge
+    if (parser.isSet(restoreOption) && !simulator->restoreCheckpoint(parser.value(restoreOption))) {
+        err << "Cannot restore checkpoint " << parser.value(restoreOption) << Qt::endl;
+        return 1;
+    }
+    if (parser.isSet(seedOption)) {
+        simulator->setRandomSeed(seed);
+    }
+    if (parser.isSet(failureOption)) {
+        simulator->setFailureMode(true);
+    }
+    if (parser.isSet(alertsOption) && !simulator->getAlertEngine().loadRules(parser.value(alertsOption))) {
+        err << "Cannot load alert rules " << parser.value(alertsOption) << Qt::endl;
+        return 1;
+    }
+    if (parser.isSet(geofenceOption) && !simulator->loadGeofence(parser.value(geofenceOption))) {
+        err << "Cannot load geofence " << parser.value(geofenceOption) << Qt::endl;
+        return 1;
+    }
+
+    TelemetryRecorder recorder;
+    if (parser.isSet(recordOption)) {
+        if (!recorder.open(parser.value(recordOption))) {
+            err << "Cannot open --record file: " << parser.value(recordOption) << Qt::endl;
+            return 1;
+        }
+        simulator->attach(&recorder);
+    }
+
+#ifdef DRONE_SIM_NETWORK
+    TelemetryStreamer streamer(keyframeInterval);
+    if (parser.isSet(streamOption)) {
+        if (!streamer.open(streamHost, streamPort)) {
+            err << "Cannot stream to " << parser.value(streamOption) << Qt::endl;
+            return 1;
+        }
+        simulator->attach(&streamer);
+    }
+#endif
+
+    ConflictDetector detector(separation, qMin(separation, ConflictDetector::DEFAULT_COLLISION_METERS));
+    if (separation > 0) {
+        simulator->attach(&detector);
+    }
+
+    TelemetryPlayer player(simulator.get());
+    const bool replaying = parser.isSet(replayOption);
+    if (replaying && !player.open(parser.value(replayOption))) {
+        err << "Cannot replay " << parser.value(replayOption) << ": "
+            << player.getReplay().errorString() << Qt::endl;
+        return 1;
+    }
+
+#ifdef DRONE_SIM_NETWORK
+    TelemetryReceiver receiver(simulator.get());
+    const bool listening = parser.isSet(listenOption);
+    if (listening && !receiver.open(listenPort)) {
+        err << "Cannot listen on UDP port " << listenPort << Qt::endl;
+        return 1;
+    }
+#else
+    const bool listening = false;
+#endif
+
+    quint64 ticks = 0;
+    QElapsedTimer wallClock;
+    wallClock.start();
+    if (listening) {
+#ifdef DRONE_SIM_NETWORK
+        // Received ticks are published from the event loop
+        QTimer::singleShot(qRound64(duration * 1000.0), &app, &QCoreApplication::quit);
+        app.exec();
+        receiver.close();
+        ticks = receiver.getPublishedTicks();
+#endif
+    } else if (!replaying) {
+        ticks = static_cast<quint64>(qCeil(duration * simulator->getTickRate()));
+        simulator->runTicks(ticks);
+    } else if (replaySpeed > 0.0) {
+        // Paced replay needs the event loop for its timer
+        QObject::connect(&player, &TelemetryPlayer::finished, &app, &QCoreApplication::quit);
+        player.setSpeed(replaySpeed);
+        player.play();
+        app.exec();
+        ticks = player.getPosition();
+    } else {
+        ticks = player.runToEnd();
+    }
+    const double wallSeconds = qMax(wallClock.nsecsElapsed() / 1e9, 1e-9);
+    simulator->detach(&recorder);
+    simulator->detach(&detector);
+#ifdef DRONE_SIM_NETWORK
+    simulator->detach(&streamer);
+#endif
+    recorder.close();
+
+    if (parser.isSet(checkpointOption) && !simulator->saveCheckpoint(parser.value(checkpointOption))) {
+        err << "Cannot write checkpoint " << parser.value(checkpointOption) << Qt::endl;
+        return 1;
+    }
+
+    const double ticksPerSecond = ticks / wallSeconds;
+    out << "Drones:            " << static_cast<qulonglong>(simulator->droneCount()) << Qt::endl;
+    out << "Threads:           " << simulator->getThreadCount() << Qt::endl;
+    out << "Seed:              " << simulator->getRandomSeed() << Qt::endl;
+    out << "Tick rate:         " << simulator->getTickRate() << " Hz" << Qt::endl;
+    out << "Energy model:      " << simulator->getEnergyModel().getModelName() << Qt::endl;
+    out << "Ticks:             " << ticks << Qt::endl;
+    out << "Simulated time:    " << QString::number(simulator->getSimulationTime(), 'f', 1) << " s" << Qt::endl;
+    out << "Wall time:         " << QString::number(wallSeconds, 'f', 3) << " s" << Qt::endl;
+    out << "Ticks/second:      " << QString::number(ticksPerSecond, 'f', 1) << Qt::endl;
+    out << "Drone updates/s:   " << QString::number(ticksPerSecond * simulator->droneCount(), 'e', 3) << Qt::endl;
+    if (parser.isSet(recordOption)) {
+        out << "Recorded:          " << recorder.getBytesWritten() << " bytes" << Qt::endl;
+    }
+#ifdef DRONE_SIM_NETWORK
+    if (listening) {
+        out << "Received:          " << receiver.getReceivedDatagrams() << " datagrams, "
+            << receiver.getLostDatagrams() << " lost, " << receiver.getRejectedDatagrams() << " rejected" << Qt::endl;
+    }
+    if (parser.isSet(streamOption)) {
+        out << "Streamed:          " << streamer.getSentDatagrams() << " datagrams, "
+            << streamer.getBytesSent() << " bytes, " << streamer.getDroppedDatagrams() << " dropped" << Qt::endl;
+    }
+#endif
+    if (separation > 0) {
+        out << "Conflicts:         " << detector.getTotalConflicts() << Qt::endl;
+    }
+    out << "Alerts raised:     " << simulator->getAlertEngine().getTotalRaised() << " ("
+        << static_cast<qulonglong>(simulator->getAlertEngine().getRules().size()) << " rules)" << Qt::endl;
+    out << "Geofence:          " << static_cast<qulonglong>(simulator->getGeofence().getZones().size()) << " zones, "
+        << static_cast<qulonglong>(simulator->getGeofence().getEdgeCount()) << " edges" << Qt::endl;
+    out << "Real-time factor:  " << QString::number(simulator->getSimulationTime() / wallSeconds, 'f', 1) << "x" << Qt::endl;
+
+    Logger::getInstance().log(Logger::INFO,
+        QString("Batch run finished: %1 ticks in %2 s (%3 ticks/s)")
+        .arg(ticks)
+        .arg(wallSeconds, 0, 'f', 3)
+        .arg(ticksPerSecond, 0, 'f', 1));
+    Logger::getInstance().flush();
+    return 0;
+}
@@ -1,13 +1,30 @@
 #include "logger.h"
+#include "logringbuffer.h"
 #include <QDateTime>
 #include <QDebug>
 #include <QStandardPaths>
 #include <QDir>
+#include <chrono>
+
+namespace {
+// Records the writer formats before flushing the file and checking for stop
+const int WRITER_BATCH_SIZE = 256;
+
+// Upper bound on how long a record can wait when a wake-up is missed
+const std::chrono::milliseconds WRITER_IDLE_WAIT(20);
+}
 
 Logger::Logger() 
     : currentLevel(INFO)
     , logFile(nullptr)
     , logStream(nullptr)
+    , asyncEnabled(false)
+    , stopRequested(false)
+    , writerIdle(false)
+    , overflowPolicy(DROP_AND_COUNT)
+    , enqueuedCount(0)
+    , writtenCount(0)
+    , droppedCount(0)
 {
     // Set default log file in user's documents
     QString logDir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
@@ -16,6 +33,7 @@ Logger::Logger()
 }
 
 Logger::~Logger() {
+    setAsync(false);
     if (logStream) {
         logStream->flush();
     }
@@ -27,20 +45,20 @@ Logger& Logger::getInstance() {
 }
 
 void Logger::log(LogLevel level, const QString& message) {
-    QMutexLocker locker(&mutex);
+    if (!isEnabled(level)) {
+        return;
+    }
 
-    QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz");
-    QString logMessage = QString("[%1] %2: %3")
-                         .arg(timestamp)
-                         .arg(levelToString(level))
-                         .arg(message);
+    LogRecord record{QDateTime::currentMSecsSinceEpoch(), level, message};
 
-    // Output to console
-    qDebug() << logMessage;
+    if (asyncEnabled.load(std::memory_order_acquire)) {
+        enqueue(record);
+        return;
+    }
 
-    // Output to file if available
+    QMutexLocker locker(&mutex);
+    writeRecord(record);
     if (logStream) {
-        *logStream << logMessage << Qt::endl;
         logStream->flush();
     }
 }
@@ -54,6 +72,156 @@ void Logger::setLogFile(const QString& filename) {
     }
 }
 
+void Logger::setAsync(bool enabled, std::size_t bufferCapacity) {
+    if (enabled == asyncEnabled.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    if (enabled) {
+        queue = std::make_unique<LogRingBuffer>(bufferCapacity);
+        stopRequested.store(false, std::memory_order_relaxed);
+        writer = std::thread(&Logger::writerLoop, this);
+        asyncEnabled.store(true, std::memory_order_release);
+    } else {
+        // The writer drains whatever is still queued before it exits
+        asyncEnabled.store(false, std::memory_order_release);
+        stopRequested.store(true, std::memory_order_release);
+        wakeWriter();
+        writer.join();
+        queue.reset();
+    }
+}
+
+void Logger::setLogLevel(LogLevel level) {
+    currentLevel.store(level, std::memory_order_relaxed);
+}
+
+Logger::LogLevel Logger::getLogLevel() const {
+    return static_cast<LogLevel>(currentLevel.load(std::memory_order_relaxed));
+}
+
+bool Logger::isAsync() const {
+    return asyncEnabled.load(std::memory_order_acquire);
+}
+
+void Logger::setOverflowPolicy(OverflowPolicy policy) {
+    overflowPolicy.store(policy, std::memory_order_relaxed);
+}
+
+Logger::OverflowPolicy Logger::getOverflowPolicy() const {
+    return static_cast<OverflowPolicy>(overflowPolicy.load(std::memory_order_relaxed));
+}
+
+void Logger::flush() {
+    if (asyncEnabled.load(std::memory_order_acquire)) {
+        const quint64 target = enqueuedCount.load(std::memory_order_acquire);
+        while (writtenCount.load(std::memory_order_acquire) < target) {
+            wakeWriter();
+            std::this_thread::yield();
+        }
+        return;
+    }
+
+    QMutexLocker locker(&mutex);
+    if (logStream) {
+        logStream->flush();
+    }
+}
+
+quint64 Logger::droppedMessages() const {
+    return droppedCount.load(std::memory_order_relaxed);
+}
+
+void Logger::enqueue(LogRecord& record) {
+    while (!queue->tryPush(record)) {
+        switch (overflowPolicy.load(std::memory_order_relaxed)) {
+            case BLOCK:
+                wakeWriter();
+                std::this_thread::yield();
+                break;
+            case DROP_AND_COUNT:
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            default:
+                return;
+        }
+    }
+
+    enqueuedCount.fetch_add(1, std::memory_order_release);
+    // Producers never take a lock; they only poke the writer when it sleeps
+    if (writerIdle.load(std::memory_order_acquire)) {
+        wakeWriter();
+    }
+}
+
+void Logger::wakeWriter() {
+    wakeCondition.notify_one();
+}
+
+void Logger::writerLoop() {
+    LogRecord record;
+    quint64 reportedDrops = droppedCount.load(std::memory_order_relaxed);
+
+    for (;;) {
+        const bool stopping = stopRequested.load(std::memory_order_acquire);
+
+        // Format and write one batch under the file mutex, then flush once
+        quint64 batch = 0;
+        {
+            QMutexLocker locker(&mutex);
+            while (batch < WRITER_BATCH_SIZE && queue->tryPop(record)) {
+                writeRecord(record);
+                ++batch;
+            }
+
+            const quint64 drops = droppedCount.load(std::memory_order_relaxed);
+            if (drops != reportedDrops) {
+                writeRecord(LogRecord{QDateTime::currentMSecsSinceEpoch(), WARNING,
+                    QString("Log buffer full, dropped %1 messages").arg(drops - reportedDrops)});
+                reportedDrops = drops;
+            }
+
+            if (batch > 0 && logStream) {
+                logStream->flush();
+            }
+        }
+        writtenCount.fetch_add(batch, std::memory_order_release);
+
+        if (batch == WRITER_BATCH_SIZE) {
+            continue;
+        }
+        if (stopping) {
+            // Stop was seen before this drain, so nothing queued earlier is lost
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        writerIdle.store(true, std::memory_order_release);
+        wakeCondition.wait_for(lock, WRITER_IDLE_WAIT, [this] {
+            return stopRequested.load(std::memory_order_acquire) || queue->hasPending();
+        });
+        writerIdle.store(false, std::memory_order_release);
+    }
+}
+
+void Logger::writeRecord(const LogRecord& record) {
+    QString timestamp = QDateTime::fromMSecsSinceEpoch(record.timestampMs)
+                        .toString("yyyy-MM-dd hh:mm:ss.zzz");
+    QString logMessage = QString("[%1] %2: %3")
+                         .arg(timestamp)
+                         .arg(levelToString(static_cast<LogLevel>(record.level)))
+                         .arg(record.message);
+
+    // Output to console
+    qDebug() << logMessage;
+
+    // Output to file if available
+    if (logStream) {
+        // No Qt::endl here: callers flush once per record or per batch
+        *logStream << logMessage << '\n';
+    }
+}
+
 QString Logger::levelToString(LogLevel level) const {
     switch (level) {
         case DEBUG: return "DEBUG";
@@ -5,7 +5,15 @@
 #include <QMutex>
 #include <QTextStream>
 #include <QFile>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
 #include <memory>
+#include <mutex>
+#include <thread>
+
+class LogRingBuffer;
+struct LogRecord;
 
 // Singleton Pattern Implementation
 class Logger {
@@ -17,10 +25,40 @@ public:
         ERROR = 3
     };
 
+    // What an asynchronous log() does when the ring buffer is full
+    enum OverflowPolicy {
+        BLOCK = 0,           // wait for the writer thread to make room
+        DROP = 1,            // discard the message
+        DROP_AND_COUNT = 2   // discard it, count it and report the count in the log
+    };
+
     static Logger& getInstance();
     void log(LogLevel level, const QString& message);
     void setLogFile(const QString& filename);
 
+    // Messages below the current level are discarded (default INFO)
+    void setLogLevel(LogLevel level);
+    LogLevel getLogLevel() const;
+
+    // Cheap pre-check so callers can skip building a message; see LOG_DEBUG below
+    bool isEnabled(LogLevel level) const {
+        return level >= currentLevel.load(std::memory_order_relaxed);
+    }
+
+    // In asynchronous mode log() only queues the record; a background thread
+    // formats and writes queued records in batches with one flush per batch.
+    // Switch modes at startup or shutdown, not while other threads are logging.
+    void setAsync(bool enabled, std::size_t bufferCapacity = 8192);
+    bool isAsync() const;
+    void setOverflowPolicy(OverflowPolicy policy);
+    OverflowPolicy getOverflowPolicy() const;
+
+    // Blocks until everything logged so far is written and flushed
+    void flush();
+
+    // Messages discarded under DROP_AND_COUNT
+    quint64 droppedMessages() const;
+
     // Delete copy constructor and assignment operator
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
@@ -29,11 +67,50 @@ private:
     Logger();
     ~Logger();
 
-    LogLevel currentLevel;
+    void enqueue(LogRecord& record);
+    void writerLoop();
+    void wakeWriter();
+    void writeRecord(const LogRecord& record);
+
+    std::atomic<int> currentLevel;
     QMutex mutex;
     std::unique_ptr<QFile> logFile;
     std::unique_ptr<QTextStream> logStream;
     QString levelToString(LogLevel level) const;
+
+    // Asynchronous backend
+    std::unique_ptr<LogRingBuffer> queue;
+    std::thread writer;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<bool> asyncEnabled;
+    std::atomic<bool> stopRequested;
+    std::atomic<bool> writerIdle;
+    std::atomic<int> overflowPolicy;
+    std::atomic<quint64> enqueuedCount;
+    std::atomic<quint64> writtenCount;
+    std::atomic<quint64> droppedCount;
 };
 
+// Level-gated logging. The message expression is only evaluated when the
+// level is enabled, so a disabled call costs one relaxed load and a compare:
+//   LOG_DEBUG(QString("Drone %1 updated").arg(id));
+#define LOG_AT_LEVEL(level, message) \
+    do { \
+        Logger& levelLogger = Logger::getInstance(); \
+        if (levelLogger.isEnabled(level)) { \
+            levelLogger.log(level, message); \
+        } \
+    } while (0)
+
+// Configure with -DDRONE_SIM_NO_DEBUG_LOG=ON to drop DEBUG calls at compile time
+#ifdef DRONE_SIM_NO_DEBUG_LOG
+#define LOG_DEBUG(message) do { } while (0)
+#else
+#define LOG_DEBUG(message) LOG_AT_LEVEL(Logger::DEBUG, message)
+#endif
+#define LOG_INFO(message) LOG_AT_LEVEL(Logger::INFO, message)
+#define LOG_WARNING(message) LOG_AT_LEVEL(Logger::WARNING, message)
+#define LOG_ERROR(message) LOG_AT_LEVEL(Logger::ERROR, message)
+
 #endif // LOGGER_H
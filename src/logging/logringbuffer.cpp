@@ -0,0 +1,70 @@
+#include "logringbuffer.h"
+#include <utility>
+
+LogRingBuffer::LogRingBuffer(std::size_t capacity)
+    : mask(0)
+    , enqueuePosition(0)
+    , dequeuePosition(0)
+{
+    std::size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    mask = size - 1;
+
+    cells = std::make_unique<Cell[]>(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+std::size_t LogRingBuffer::capacity() const {
+    return mask + 1;
+}
+
+bool LogRingBuffer::tryPush(LogRecord& record) {
+    std::size_t position = enqueuePosition.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells[position & mask];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t difference =
+            static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+        if (difference == 0) {
+            // Cell is free for this lap; claim it
+            if (enqueuePosition.compare_exchange_weak(position, position + 1,
+                                                      std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // Consumer has not released this cell yet: the buffer is full
+            return false;
+        } else {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->record = std::move(record);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogRingBuffer::tryPop(LogRecord& record) {
+    const std::size_t position = dequeuePosition.load(std::memory_order_relaxed);
+    Cell& cell = cells[position & mask];
+    if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
+    }
+
+    dequeuePosition.store(position + 1, std::memory_order_relaxed);
+    record = std::move(cell.record);
+    // Hand the cell to the producer one lap ahead
+    cell.sequence.store(position + mask + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogRingBuffer::hasPending() const {
+    const std::size_t position = dequeuePosition.load(std::memory_order_relaxed);
+    return cells[position & mask].sequence.load(std::memory_order_acquire) == position + 1;
+}
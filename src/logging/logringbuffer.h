@@ -0,0 +1,55 @@
+#ifndef LOGRINGBUFFER_H
+#define LOGRINGBUFFER_H
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// One queued log call; formatting is left to the writer thread
+struct LogRecord {
+    qint64 timestampMs;
+    int level;
+    QString message;
+};
+
+// Bounded lock-free queue for many producers and one consumer, after
+// Dmitry Vyukov's bounded MPMC queue. Each cell carries a sequence number
+// telling producers and the consumer whose turn it is, so a push is one
+// CAS on the enqueue position plus a release store, and never waits.
+class LogRingBuffer {
+public:
+    // Capacity is rounded up to a power of two (at least 2)
+    explicit LogRingBuffer(std::size_t capacity);
+
+    LogRingBuffer(const LogRingBuffer&) = delete;
+    LogRingBuffer& operator=(const LogRingBuffer&) = delete;
+
+    std::size_t capacity() const;
+
+    // Moves the record in and returns true, or returns false when full.
+    // Safe from any number of threads.
+    bool tryPush(LogRecord& record);
+
+    // Consumer only: moves the oldest record out, or returns false when empty
+    bool tryPop(LogRecord& record);
+
+    // Consumer only: true when tryPop() would succeed
+    bool hasPending() const;
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        LogRecord record;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    std::size_t mask;
+
+    // Producers and the consumer each own a cache line
+    alignas(64) std::atomic<std::size_t> enqueuePosition;
+    alignas(64) std::atomic<std::size_t> dequeuePosition;
+};
+
+#endif // LOGRINGBUFFER_H
@@ -13,7 +13,8 @@ int main(int argc, char *argv[])
     app.setApplicationVersion("1.0.0");
     app.setOrganizationName("DroneSimulation");
 
-    // Initialize logger
+    // Initialize logger; file writes happen on its background thread
+    Logger::getInstance().setAsync(true);
     Logger::getInstance().log(Logger::INFO, "Application starting...");
 
     // Create and show main window
@@ -25,5 +26,6 @@ int main(int argc, char *argv[])
     int result = app.exec();
 
     Logger::getInstance().log(Logger::INFO, "Application exiting...");
+    Logger::getInstance().flush();
     return result;
 }
\ No newline at end of file
@@ -1,20 +1,69 @@
 #include "mainwindow.h"
+#include "alertengine.h"
 #include "dronesimulator.h"
 #include "simulationfactory.h"
 #include "movementstrategy.h"
 #include "logger.h"
+#include "telemetryplayer.h"
+#ifdef DRONE_SIM_NETWORK
+#include "telemetryreceiver.h"
+#endif
 #include <QApplication>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QInputDialog>
 #include <QMessageBox>
+#include <QScreen>
 #include <QStatusBar>
+#include <QtMath>
+
+namespace {
+// Used when the screen does not report a refresh rate
+const double DEFAULT_DISPLAY_REFRESH_HZ = 60.0;
+const double MIN_DISPLAY_REFRESH_HZ = 1.0;
+const double MAX_DISPLAY_REFRESH_HZ = 240.0;
+const qint64 FRAME_STATS_INTERVAL_NS = 1000000000LL;
+#ifdef DRONE_SIM_NETWORK
+// Offered in the listen dialog; matches the batch runner's streaming examples
+const int DEFAULT_LISTEN_PORT = 14550;
+#endif
+
+// Skips the relayout when the formatted value has not changed
+void setLabelText(QLabel* label, const QString& text) {
+    if (label->text() != text) {
+        label->setText(text);
+    }
+}
+}
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , centralWidget(nullptr)
     , currentlyHovering(true)
+    , refreshTimer(new QTimer(this))
+    , displayRefreshRate(DEFAULT_DISPLAY_REFRESH_HZ)
+    , pendingTicks(0)
+    , pendingAlertSeverity(-1)
+    , renderedFrames(0)
+    , coalescedFrames(0)
+    , droppedFrames(0)
+    , lastRefreshNs(0)
+    , lastStatsNs(0)
+    , shownGpsStyle(-1)
+    , shownBatteryStyle(-1)
 {
     setupUI();
     connectSignals();
 
+    // Paint at the screen's refresh rate, independent of the tick rate
+    refreshTimer->setTimerType(Qt::PreciseTimer);
+    connect(refreshTimer, &QTimer::timeout, this, &MainWindow::onDisplayRefresh);
+    QScreen* display = screen();
+    setDisplayRefreshRate(display && display->refreshRate() > 0 ? display->refreshRate()
+                                                                 : DEFAULT_DISPLAY_REFRESH_HZ);
+    refreshClock.start();
+    refreshTimer->start();
+
     // Create simulator using factory pattern
     simulator = SimulationFactory::createSimulator(SimulationFactory::BASIC_SIMULATOR);
 
@@ -22,12 +71,10 @@ MainWindow::MainWindow(QWidget *parent)
     auto hoverStrategy = SimulationFactory::createMovementStrategy(SimulationFactory::HOVER_MOVEMENT);
     simulator->setMovementStrategy(std::move(hoverStrategy));
 
-    // Attach this window as an observer
+    // Attach this window as an observer; ticks reach the display only through it
     simulator->attach(this);
-
-    // Connect simulator signals
-    connect(simulator.get(), &DroneSimulator::telemetryUpdated,
-            this, &MainWindow::onTelemetryUpdated);
+    simulator->attach(fleetMap);
+    simulator->getAlertEngine().addListener(this);
 
     Logger::getInstance().log(Logger::INFO, "MainWindow initialized.");
 }
@@ -35,6 +82,8 @@ MainWindow::MainWindow(QWidget *parent)
 MainWindow::~MainWindow() {
     if (simulator) {
         simulator->detach(this);
+        simulator->detach(fleetMap);
+        simulator->getAlertEngine().removeListener(this);
         simulator->stopSimulation();
     }
     Logger::getInstance().log(Logger::INFO, "MainWindow destroyed");
@@ -42,7 +91,7 @@ MainWindow::~MainWindow() {
 
 void MainWindow::setupUI() {
     setWindowTitle("Real-Time Drone Telemetry Simulator");
-    setMinimumSize(800, 625);
+    setMinimumSize(800, 825);
 
     centralWidget = new QWidget(this);
     setCentralWidget(centralWidget);
@@ -143,6 +192,10 @@ void MainWindow::setupTelemetrySection() {
     telemetryLayout->addWidget(batteryFrame, 5, 2, 1, 2);
 
     mainLayout->addWidget(telemetryGroup);
+
+    fleetMap = new FleetMapWidget(this);
+    fleetMap->setObjectName("fleetMap");
+    mainLayout->addWidget(fleetMap, 1);
 }
 
 void MainWindow::setupControlsSection() {
@@ -167,7 +220,19 @@ void MainWindow::setupControlsSection() {
 
     controlsLayout->addWidget(startStopButton);
     controlsLayout->addWidget(failureModeButton);
+    replayButton = new QPushButton("⏪ Replay Recording", this);
+    replayButton->setObjectName("replayButton");
+    replayButton->setMinimumHeight(50);
+
     controlsLayout->addWidget(movementStrategyButton);
+    controlsLayout->addWidget(replayButton);
+
+#ifdef DRONE_SIM_NETWORK
+    listenButton = new QPushButton("📡 Listen on UDP", this);
+    listenButton->setObjectName("listenButton");
+    listenButton->setMinimumHeight(50);
+    controlsLayout->addWidget(listenButton);
+#endif
 
     mainLayout->addWidget(controlsGroup);
 }
@@ -214,12 +279,17 @@ void MainWindow::setupStatusBarSection() {
     statusLabel = new QLabel("Ready to start simulation", this);
     statusLabel->setStyleSheet("color: black;");
 
+    frameStatsLabel = new QLabel(this);
+    frameStatsLabel->setStyleSheet("color: #4a5568;");
+    frameStatsLabel->setAlignment(Qt::AlignCenter);
+
     // Copyright Label
     copyrightLabel = new QLabel("©2025 Brijesh Markandey", this);
     copyrightLabel->setStyleSheet("color: black; font-weight: bold;");
     copyrightLabel->setAlignment(Qt::AlignRight);
 
     statusMessageLayout->addWidget(statusLabel);
+    statusMessageLayout->addWidget(frameStatsLabel);
     statusMessageLayout->addWidget(copyrightLabel);
 
     mainLayout->addWidget(statusMessage);
@@ -395,6 +465,38 @@ void MainWindow::applyStyles() {
                 stop:0 #63b3ed, stop:1 #4299e1);
         }
 
+        #replayButton {
+            background: qlineargradient(x1:0, y1:0, x2:0, y2:1,
+                stop:0 #9f7aea, stop:1 #805ad5);
+            color: white;
+            border: none;
+            border-radius: 8px;
+            font-size: 14px;
+            font-weight: bold;
+            padding: 12px 20px;
+        }
+
+        #replayButton:hover {
+            background: qlineargradient(x1:0, y1:0, x2:0, y2:1,
+                stop:0 #b794f4, stop:1 #9f7aea);
+        }
+
+        #listenButton {
+            background: qlineargradient(x1:0, y1:0, x2:0, y2:1,
+                stop:0 #38b2ac, stop:1 #319795);
+            color: white;
+            border: none;
+            border-radius: 8px;
+            font-size: 14px;
+            font-weight: bold;
+            padding: 12px 20px;
+        }
+
+        #listenButton:hover {
+            background: qlineargradient(x1:0, y1:0, x2:0, y2:1,
+                stop:0 #4fd1c5, stop:1 #38b2ac);
+        }
+
         /* Toggle frame */
         #toggleFrame {
             background: qlineargradient(x1:0, y1:0, x2:1, y2:0,
@@ -429,63 +531,167 @@ void MainWindow::connectSignals() {
     connect(startStopButton, &QPushButton::clicked, this, &MainWindow::onStartStopClicked);
     connect(failureModeButton, &QPushButton::clicked, this, &MainWindow::onFailureModeToggled);
     connect(movementStrategyButton, &QPushButton::clicked, this, &MainWindow::onMovementStrategyChanged);
+    connect(replayButton, &QPushButton::clicked, this, &MainWindow::onReplayClicked);
+#ifdef DRONE_SIM_NETWORK
+    connect(listenButton, &QPushButton::clicked, this, &MainWindow::onListenClicked);
+#endif
 }
 
 void MainWindow::update(const DroneData& data) {
-    updateDisplayLabels(data);
+    pendingSnapshot.reset();
+    pendingData = data;
+    ++pendingTicks;
+}
+
+void MainWindow::updateFleet(const FleetSnapshotPtr& snapshot) {
+    if (!snapshot || snapshot->isEmpty()) {
+        return;
+    }
+    // Keep a reference to the latest tick only; older ones are released
+    pendingSnapshot = snapshot;
+    ++pendingTicks;
+}
+
+void MainWindow::setDisplayRefreshRate(double rateHz) {
+    displayRefreshRate = qBound(MIN_DISPLAY_REFRESH_HZ, rateHz, MAX_DISPLAY_REFRESH_HZ);
+    refreshTimer->setInterval(qMax(1, qFloor(1000.0 / displayRefreshRate)));
+    lastRefreshNs = 0;
+}
+
+double MainWindow::getDisplayRefreshRate() const {
+    return displayRefreshRate;
+}
+
+quint64 MainWindow::getRenderedFrames() const {
+    return renderedFrames;
+}
+
+quint64 MainWindow::getCoalescedFrames() const {
+    return coalescedFrames;
+}
+
+quint64 MainWindow::getDroppedFrames() const {
+    return droppedFrames;
+}
+
+void MainWindow::onDisplayRefresh() {
+    // Refreshes that should have happened while the event loop was busy
+    const qint64 nowNs = refreshClock.nsecsElapsed();
+    const qint64 intervalNs = static_cast<qint64>(1e9 / displayRefreshRate);
+    if (lastRefreshNs > 0 && nowNs - lastRefreshNs > intervalNs + intervalNs / 2) {
+        droppedFrames += static_cast<quint64>((nowNs - lastRefreshNs) / intervalNs - 1);
+    }
+    lastRefreshNs = nowNs;
+
+    if (pendingTicks > 0) {
+        coalescedFrames += pendingTicks - 1;
+        pendingTicks = 0;
+        ++renderedFrames;
+        updateDisplayLabels(pendingSnapshot ? pendingSnapshot->view(0) : pendingData);
+    }
+
+    if (pendingAlertSeverity >= 0) {
+        statusBar()->showMessage(pendingAlert);
+        pendingAlert.clear();
+        pendingAlertSeverity = -1;
+    }
+
+    if (nowNs - lastStatsNs >= FRAME_STATS_INTERVAL_NS) {
+        lastStatsNs = nowNs;
+        updateFrameStats();
+    }
+}
+
+void MainWindow::updateAlerts(const std::vector<AlertEvent>& alerts) {
+    const std::vector<AlertRule>& rules = simulator->getAlertEngine().getRules();
+    const AlertEvent* shown = nullptr;
+    for (const AlertEvent& alert : alerts) {
+        if (alert.transition == AlertEvent::RAISED
+            && (!shown || rules[alert.rule].severity > rules[shown->rule].severity)) {
+            shown = &alert;
+        }
+    }
+    // A later alert of the same severity replaces the pending one
+    if (!shown || rules[shown->rule].severity < pendingAlertSeverity) {
+        return;
+    }
+    pendingAlert = QString("Alert %1: %2").arg(rules[shown->rule].name, simulator->getFleet().nameAt(shown->index));
+    pendingAlertSeverity = rules[shown->rule].severity;
+}
+
+void MainWindow::updateFrameStats() {
+    setLabelText(frameStatsLabel, QString("Display %1 Hz | %2 frames, %3 coalesced, %4 dropped")
+                 .arg(displayRefreshRate, 0, 'f', 0)
+                 .arg(renderedFrames)
+                 .arg(coalescedFrames)
+                 .arg(droppedFrames));
 }
 
 void MainWindow::updateDisplayLabels(const DroneData& data) {
     // Update drone ID
-    droneIdLabel->setText(data.getId());
+    setLabelText(droneIdLabel, data.getName());
 
     // Update position data (left side)
-    latitudeLabel->setText(QString("Latitude: %1°").arg(data.getLatitude(), 0, 'f', 6));
-    longitudeLabel->setText(QString("Longitude: %1°").arg(data.getLongitude(), 0, 'f', 6));
-    altitudeLabel->setText(QString("Altitude: %1 m").arg(data.getAltitude(), 0, 'f', 1));
+    setLabelText(latitudeLabel, QString("Latitude: %1°").arg(data.getLatitude(), 0, 'f', 6));
+    setLabelText(longitudeLabel, QString("Longitude: %1°").arg(data.getLongitude(), 0, 'f', 6));
+    setLabelText(altitudeLabel, QString("Altitude: %1 m").arg(data.getAltitude(), 0, 'f', 1));
 
     // Update motion data (right side)
-    headingLabel->setText(QString("Heading: %1°").arg(data.getHeading(), 0, 'f', 1));
-    speedLabel->setText(QString("Speed: %1 m/s").arg(data.getSpeed(), 0, 'f', 2));
+    setLabelText(headingLabel, QString("Heading: %1°").arg(data.getHeading(), 0, 'f', 1));
+    setLabelText(speedLabel, QString("Speed: %1 m/s").arg(data.getSpeed(), 0, 'f', 2));
 
     // Update GPS status (left bottom) with color coding
-    QString gpsText = QString("GPS: %1").arg(data.gpsStatusString());
-    gpsStatusLabel->setText(gpsText);
-
-    if (data.getGPSStatus() == GPSFixStatus::FIX_3D) {
-        gpsStatusLabel->setStyleSheet("#gpsStatusLabel { background: #f0fff4; border: 1px solid #9ae6b4; color: #22543d; }");
-    } else {
-        gpsStatusLabel->setStyleSheet("#gpsStatusLabel { background: #fed7d7; border: 1px solid #fc8181; color: #742a2a; }");
+    setLabelText(gpsStatusLabel, QString("GPS: %1").arg(data.gpsStatusString()));
+
+    // Style sheets restyle the whole widget; apply them only when the state changes
+    const bool hasFix = data.getGPSStatus() == GPSFixStatus::FIX_3D;
+    if (shownGpsStyle != static_cast<int>(hasFix)) {
+        shownGpsStyle = static_cast<int>(hasFix);
+        if (hasFix) {
+            gpsStatusLabel->setStyleSheet("#gpsStatusLabel { background: #f0fff4; border: 1px solid #9ae6b4; color: #22543d; }");
+        } else {
+            gpsStatusLabel->setStyleSheet("#gpsStatusLabel { background: #fed7d7; border: 1px solid #fc8181; color: #742a2a; }");
+        }
+        // Update toggle icons based on status
+        toggleIcon2->setText(hasFix ? "📡" : "📵");  // Good signal / no signal
     }
 
     // Update battery (right bottom) with progress bar and color coding
     int batteryValue = static_cast<int>(data.getBattery());
     batteryProgressBar->setValue(batteryValue);
-    batteryPercentLabel->setText(QString("%1%").arg(batteryValue));
+    setLabelText(batteryPercentLabel, QString("%1%").arg(batteryValue));
 
     // Color-code battery progress bar based on level
-    QString batteryStyle;
+    enum BatteryStyle { BATTERY_HIGH, BATTERY_MEDIUM, BATTERY_LOW };
+    BatteryStyle batteryStyle;
     if (batteryValue > 50) {
-        batteryStyle = "#batteryProgressBar::chunk { background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #48bb78, stop:1 #38a169); }";
+        batteryStyle = BATTERY_HIGH;
     } else if (batteryValue > 20) {
-        batteryStyle = "#batteryProgressBar::chunk { background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #ed8936, stop:1 #dd6b20); }";
-    } else if (batteryValue == 0) {
-        batteryStyle = "#batteryProgressBar::chunk { background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #f56565, stop:1 #e53e3e); }";
+        batteryStyle = BATTERY_MEDIUM;
+    } else {
+        batteryStyle = BATTERY_LOW;
+    }
+    if (shownBatteryStyle != batteryStyle) {
+        shownBatteryStyle = batteryStyle;
+        switch (batteryStyle) {
+            case BATTERY_HIGH:
+                batteryProgressBar->setStyleSheet("#batteryProgressBar::chunk { background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #48bb78, stop:1 #38a169); }");
+                break;
+            case BATTERY_MEDIUM:
+                batteryProgressBar->setStyleSheet("#batteryProgressBar::chunk { background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #ed8936, stop:1 #dd6b20); }");
+                break;
+            case BATTERY_LOW:
+                batteryProgressBar->setStyleSheet("#batteryProgressBar::chunk { background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #f56565, stop:1 #e53e3e); }");
+                break;
+        }
+    }
+
+    if (batteryValue == 0 && simulator->isRunning()) {
         simulator->stopSimulation();
         startStopButton->setText("▶️ Start Simulation");
         statusLabel->setText("Simulation stopped due to low battery");
         statusBar()->showMessage("Simulation stopped due to low battery");
         toggleIcon1->setText("⏸️");  // Paused
-    } else {
-        batteryStyle = "#batteryProgressBar::chunk { background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #f56565, stop:1 #e53e3e); }";
-    }
-    batteryProgressBar->setStyleSheet(batteryStyle);
-
-    // Update toggle icons based on status
-    if (data.getGPSStatus() == GPSFixStatus::FIX_3D) {
-        toggleIcon2->setText("📡");  // Good signal
-    } else {
-        toggleIcon2->setText("📵");  // No signal
     }
 }
 
@@ -499,6 +705,17 @@ void MainWindow::onStartStopClicked() {
         statusBar()->showMessage("Simulation stopped");
         toggleIcon1->setText("⏸️");  // Paused
     } else {
+#ifdef DRONE_SIM_NETWORK
+        // The local simulation replaces a monitored stream
+        if (receiver && receiver->isOpen()) {
+            receiver->close();
+            listenButton->setText("📡 Listen on UDP");
+        }
+#endif
+        // ... and a replay, which would otherwise keep publishing into the simulator
+        if (player && player->isPlaying()) {
+            onReplayClicked();
+        }
         simulator->startSimulation();
         startStopButton->setText("⏹️ Stop Simulation");
         statusLabel->setText("Simulation running");
@@ -547,6 +764,90 @@ void MainWindow::onMovementStrategyChanged() {
     }
 }
 
-void MainWindow::onTelemetryUpdated(const DroneData& data) {
-    updateDisplayLabels(data);
+void MainWindow::onReplayClicked() {
+    if (!simulator) return;
+
+    if (player && player->isPlaying()) {
+        player->pause();
+        replayButton->setText("⏪ Replay Recording");
+        statusLabel->setText("Replay stopped");
+        statusBar()->showMessage("Replay stopped");
+        return;
+    }
+
+    QString filename = QFileDialog::getOpenFileName(this, "Open Telemetry Recording", QString(),
+                                                    "Telemetry recordings (*.dtr);;All files (*)");
+    if (filename.isEmpty()) return;
+
+    if (!player) {
+        player = std::make_unique<TelemetryPlayer>(simulator.get());
+        connect(player.get(), &TelemetryPlayer::finished, this, &MainWindow::onReplayFinished);
+    }
+    if (!player->open(filename)) {
+        QMessageBox::warning(this, "Replay Recording",
+                             QString("Cannot open %1:\n%2").arg(filename, player->getReplay().errorString()));
+        return;
+    }
+
+    // Replay takes over the display; the live simulation is stopped
+#ifdef DRONE_SIM_NETWORK
+    if (receiver && receiver->isOpen()) {
+        onListenClicked();
+    }
+#endif
+    player->play();
+    startStopButton->setText("▶️ Start Simulation");
+    replayButton->setText("⏹️ Stop Replay");
+    statusLabel->setText(QString("Replaying %1").arg(QFileInfo(filename).fileName()));
+    statusBar()->showMessage(QString("Replaying %1 ticks (%2 s) in real time")
+                             .arg(player->getReplay().getTickCount())
+                             .arg(player->getReplay().getEndTime() - player->getReplay().getStartTime(), 0, 'f', 1));
+    toggleIcon1->setText("⏪");
+}
+
+void MainWindow::onReplayFinished() {
+    replayButton->setText("⏪ Replay Recording");
+    statusLabel->setText("Replay finished");
+    statusBar()->showMessage("Replay finished");
+    toggleIcon1->setText("⏸️");
+}
+
+#ifdef DRONE_SIM_NETWORK
+void MainWindow::onListenClicked() {
+    if (!simulator) return;
+
+    if (receiver && receiver->isOpen()) {
+        receiver->close();
+        listenButton->setText("📡 Listen on UDP");
+        statusLabel->setText("Stopped listening");
+        statusBar()->showMessage(QString("Stopped listening: %1 ticks received, %2 datagrams lost")
+                                 .arg(receiver->getPublishedTicks())
+                                 .arg(receiver->getLostDatagrams()));
+        toggleIcon1->setText("⏸️");
+        return;
+    }
+
+    bool ok = false;
+    const int port = QInputDialog::getInt(this, "Listen on UDP", "Telemetry stream port:",
+                                          DEFAULT_LISTEN_PORT, 1, 65535, 1, &ok);
+    if (!ok) return;
+
+    if (player && player->isPlaying()) {
+        onReplayClicked();
+    }
+    if (!receiver) {
+        receiver = std::make_unique<TelemetryReceiver>(simulator.get());
+    }
+    if (!receiver->open(static_cast<quint16>(port))) {
+        QMessageBox::warning(this, "Listen on UDP", QString("Cannot listen on UDP port %1.").arg(port));
+        return;
+    }
+
+    // The external stream takes over the display; the live simulation is stopped
+    startStopButton->setText("▶️ Start Simulation");
+    listenButton->setText("⏹️ Stop Listening");
+    statusLabel->setText(QString("Listening on UDP port %1").arg(port));
+    statusBar()->showMessage(QString("Monitoring telemetry streamed to UDP port %1").arg(port));
+    toggleIcon1->setText("📡");
 }
+#endif
@@ -9,12 +9,15 @@
 #include <QGridLayout>
 #include <QGroupBox>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QProgressBar>
 #include <QFrame>
 #include <QSizePolicy>
 #include <memory>
 #include "observer.h"
+#include "alertengine.h"
 #include "dronedata.h"
+#include "fleetmapwidget.h"
 
 QT_BEGIN_NAMESPACE
 class QLabel;
@@ -25,23 +28,47 @@ class QFrame;
 QT_END_NAMESPACE
 
 class DroneSimulator;
+#ifdef DRONE_SIM_NETWORK
+class TelemetryReceiver;
+#endif
 class MovementStrategy;
+class TelemetryPlayer;
 
-class MainWindow : public QMainWindow, public Observer {
+class MainWindow : public QMainWindow, public Observer, public AlertListener {
     Q_OBJECT
 
 public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
-    // Observer pattern implementation
+    // Observer pattern implementation. Ticks only keep the latest data;
+    // the display refresh timer renders it, so the simulation never waits
+    // for the GUI and a burst of ticks costs one repaint.
     void update(const DroneData& data) override;
+    void updateFleet(const FleetSnapshotPtr& snapshot) override;
+    // Keeps the most severe alert raised since the last paint for the status bar
+    void updateAlerts(const std::vector<AlertEvent>& alerts) override;
+
+    // Display refresh rate in Hz; defaults to the screen's refresh rate
+    void setDisplayRefreshRate(double rateHz);
+    double getDisplayRefreshRate() const;
+
+    // Frames painted, ticks superseded before they were painted, and
+    // refreshes missed because the event loop was busy
+    quint64 getRenderedFrames() const;
+    quint64 getCoalescedFrames() const;
+    quint64 getDroppedFrames() const;
 
 private slots:
     void onStartStopClicked();
     void onFailureModeToggled();
     void onMovementStrategyChanged();
-    void onTelemetryUpdated(const DroneData& data);
+    void onReplayClicked();
+    void onReplayFinished();
+#ifdef DRONE_SIM_NETWORK
+    void onListenClicked();
+#endif
+    void onDisplayRefresh();
 
 private:
     void setupUI();
@@ -50,6 +77,7 @@ private:
     void setupToggleSection();
     void setupStatusBarSection();
     void updateDisplayLabels(const DroneData& data);
+    void updateFrameStats();
     void connectSignals();
     void applyStyles();
 
@@ -81,6 +109,9 @@ private:
     QProgressBar* batteryProgressBar;
     QLabel* batteryPercentLabel;
 
+    // Whole-fleet map, rasterized off the GUI thread
+    FleetMapWidget* fleetMap;
+
     // Toggle section (center bottom)
     QFrame* toggleFrame;
     QHBoxLayout* toggleLayout;
@@ -93,13 +124,39 @@ private:
     QPushButton* startStopButton;
     QPushButton* failureModeButton;
     QPushButton* movementStrategyButton;
+    QPushButton* replayButton;
+#ifdef DRONE_SIM_NETWORK
+    QPushButton* listenButton;
+#endif
 
     QLabel* statusLabel;
+    QLabel* frameStatsLabel;
     QLabel* copyrightLabel;
 
     // Simulation components
     std::unique_ptr<DroneSimulator> simulator;
+    std::unique_ptr<TelemetryPlayer> player;  // created on first replay
+#ifdef DRONE_SIM_NETWORK
+    std::unique_ptr<TelemetryReceiver> receiver;  // created on first listen
+#endif
     bool currentlyHovering;
+
+    // Display coalescing
+    QTimer* refreshTimer;
+    QElapsedTimer refreshClock;
+    double displayRefreshRate;
+    FleetSnapshotPtr pendingSnapshot;
+    DroneData pendingData;
+    quint64 pendingTicks;        // ticks received since the last paint
+    QString pendingAlert;
+    int pendingAlertSeverity;    // AlertRule::Severity of pendingAlert, -1 when none
+    quint64 renderedFrames;
+    quint64 coalescedFrames;
+    quint64 droppedFrames;
+    qint64 lastRefreshNs;
+    qint64 lastStatsNs;
+    int shownGpsStyle;           // style sheets applied last, -1 before the first paint
+    int shownBatteryStyle;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,210 @@
+#include "fleetmaprasterizer.h"
+#include "fleetstate.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const QRgb BACKGROUND_COLOR = qRgb(0x1a, 0x20, 0x2c);
+const QRgb BATTERY_HIGH_COLOR = qRgb(0x48, 0xbb, 0x78);
+const QRgb BATTERY_MEDIUM_COLOR = qRgb(0xed, 0x89, 0x36);
+const QRgb BATTERY_LOW_COLOR = qRgb(0xf5, 0x65, 0x65);
+const QRgb NO_FIX_COLOR = qRgb(0xa0, 0xae, 0xc0);
+
+const int DENSITY_RAMP_SIZE = 256;
+const int SPRITE_RADIUS = 1;  // 3x3 pixels
+
+// Zoom used when the fleet has no extent (a single drone or all co-located)
+const double DEFAULT_PIXELS_PER_DEGREE = 20000.0;
+const double FIT_MARGIN = 1.1;
+
+QRgb spriteColor(double battery, GPSFixStatus gpsStatus) {
+    if (gpsStatus == GPSFixStatus::NO_FIX) {
+        return NO_FIX_COLOR;
+    }
+    if (battery > 50.0) {
+        return BATTERY_HIGH_COLOR;
+    }
+    return battery > 20.0 ? BATTERY_MEDIUM_COLOR : BATTERY_LOW_COLOR;
+}
+
+// Pixel column/row of a drone, or false when it is off screen
+struct Projection {
+    double originX;
+    double originY;
+    double scaleX;
+    double scaleY;
+
+    bool project(double latitude, double longitude, int width, int height, int& x, int& y) const {
+        const double px = originX + longitude * scaleX;
+        const double py = originY - latitude * scaleY;
+        if (!(px >= 0.0 && px < width && py >= 0.0 && py < height)) {
+            return false;  // also rejects NaN
+        }
+        x = static_cast<int>(px);
+        y = static_cast<int>(py);
+        return true;
+    }
+};
+
+Projection projectionFor(const MapViewport& viewport) {
+    Projection projection;
+    projection.scaleY = viewport.pixelsPerDegree;
+    projection.scaleX = viewport.pixelsPerDegree * std::cos(qDegreesToRadians(viewport.centerLatitude));
+    projection.originX = 0.5 * viewport.width - viewport.centerLongitude * projection.scaleX;
+    projection.originY = 0.5 * viewport.height + viewport.centerLatitude * projection.scaleY;
+    return projection;
+}
+}
+
+FleetMapRasterizer::FleetMapRasterizer()
+    : lastMode(SPRITES)
+    , lastVisibleCount(0)
+{
+    // Dark blue through orange to near white, like a heat map
+    densityRamp.resize(DENSITY_RAMP_SIZE);
+    for (int i = 0; i < DENSITY_RAMP_SIZE; ++i) {
+        const double t = static_cast<double>(i) / (DENSITY_RAMP_SIZE - 1);
+        const int red = qBound(0, qRound(40 + 215 * qMin(1.0, 1.6 * t)), 255);
+        const int green = qBound(0, qRound(60 + 195 * t * t), 255);
+        const int blue = qBound(0, qRound(110 + 120 * (t - 0.6) * (t - 0.6)), 255);
+        densityRamp[i] = qRgb(red, green, blue);
+    }
+}
+
+void FleetMapRasterizer::render(const FleetState& fleet, const MapViewport& viewport, QImage& image) {
+    const int width = qMax(1, viewport.width);
+    const int height = qMax(1, viewport.height);
+    if (image.width() != width || image.height() != height || image.format() != QImage::Format_RGB32) {
+        image = QImage(width, height, QImage::Format_RGB32);
+    }
+
+    // Pass 1: project every drone once into the density buffer
+    const std::size_t pixels = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+    density.assign(pixels, 0);
+    const Projection projection = projectionFor(viewport);
+    const double* latitude = fleet.latitudes();
+    const double* longitude = fleet.longitudes();
+    std::size_t visible = 0;
+    quint32 maxCount = 0;
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        int x, y;
+        if (projection.project(latitude[i], longitude[i], width, height, x, y)) {
+            quint32& count = density[static_cast<std::size_t>(y) * width + x];
+            maxCount = qMax(maxCount, ++count);
+            ++visible;
+        }
+    }
+    lastVisibleCount = visible;
+
+    if (static_cast<double>(visible) > DENSITY_THRESHOLD * static_cast<double>(pixels)) {
+        lastMode = DENSITY;
+        drawDensity(image, maxCount);
+    } else {
+        lastMode = SPRITES;
+        image.fill(BACKGROUND_COLOR);
+        drawSprites(fleet, viewport, image);
+    }
+}
+
+FleetMapRasterizer::Mode FleetMapRasterizer::getLastMode() const {
+    return lastMode;
+}
+
+std::size_t FleetMapRasterizer::getLastVisibleCount() const {
+    return lastVisibleCount;
+}
+
+MapViewport FleetMapRasterizer::fitToFleet(const FleetState& fleet, int width, int height) {
+    MapViewport viewport{28.4595, 77.0266, DEFAULT_PIXELS_PER_DEGREE, qMax(1, width), qMax(1, height)};
+    if (fleet.isEmpty()) {
+        return viewport;
+    }
+
+    const double* latitude = fleet.latitudes();
+    const double* longitude = fleet.longitudes();
+    double minLatitude = latitude[0], maxLatitude = latitude[0];
+    double minLongitude = longitude[0], maxLongitude = longitude[0];
+    for (std::size_t i = 1; i < fleet.size(); ++i) {
+        minLatitude = qMin(minLatitude, latitude[i]);
+        maxLatitude = qMax(maxLatitude, latitude[i]);
+        minLongitude = qMin(minLongitude, longitude[i]);
+        maxLongitude = qMax(maxLongitude, longitude[i]);
+    }
+    viewport.centerLatitude = 0.5 * (minLatitude + maxLatitude);
+    viewport.centerLongitude = 0.5 * (minLongitude + maxLongitude);
+
+    const double spanLatitude = (maxLatitude - minLatitude) * FIT_MARGIN;
+    const double spanLongitude = (maxLongitude - minLongitude) * FIT_MARGIN
+                                 * std::cos(qDegreesToRadians(viewport.centerLatitude));
+    double pixelsPerDegree = DEFAULT_PIXELS_PER_DEGREE;
+    if (spanLatitude > 0.0) {
+        pixelsPerDegree = qMin(pixelsPerDegree, viewport.height / spanLatitude);
+    }
+    if (spanLongitude > 0.0) {
+        pixelsPerDegree = qMin(pixelsPerDegree, viewport.width / spanLongitude);
+    }
+    viewport.pixelsPerDegree = pixelsPerDegree;
+    return viewport;
+}
+
+void FleetMapRasterizer::drawSprites(const FleetState& fleet, const MapViewport& viewport, QImage& image) {
+    const int width = image.width();
+    const int height = image.height();
+    const Projection projection = projectionFor(viewport);
+    const double* latitude = fleet.latitudes();
+    const double* longitude = fleet.longitudes();
+    const double* battery = fleet.batteries();
+    const GPSFixStatus* gpsStatus = fleet.gpsStatuses();
+    uchar* bits = image.bits();
+    const qsizetype stride = image.bytesPerLine();
+
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        int x, y;
+        if (!projection.project(latitude[i], longitude[i], width, height, x, y)) {
+            continue;
+        }
+        const QRgb color = spriteColor(battery[i], gpsStatus[i]);
+        const int top = qMax(0, y - SPRITE_RADIUS);
+        const int bottom = qMin(height - 1, y + SPRITE_RADIUS);
+        const int left = qMax(0, x - SPRITE_RADIUS);
+        const int right = qMin(width - 1, x + SPRITE_RADIUS);
+        for (int row = top; row <= bottom; ++row) {
+            QRgb* line = reinterpret_cast<QRgb*>(bits + row * stride);
+            std::fill(line + left, line + right + 1, color);
+        }
+    }
+}
+
+void FleetMapRasterizer::drawDensity(QImage& image, quint32 maxCount) {
+    const int width = image.width();
+    const int height = image.height();
+
+    // Log scale so a few dense clusters do not wash out the rest
+    std::vector<QRgb> countColor;
+    const double scale = (DENSITY_RAMP_SIZE - 1) / std::log1p(static_cast<double>(qMax<quint32>(maxCount, 1)));
+    auto colorFor = [&](quint32 count) {
+        if (count == 0) {
+            return BACKGROUND_COLOR;
+        }
+        if (count < countColor.size()) {
+            return countColor[count];
+        }
+        return densityRamp[qMin(DENSITY_RAMP_SIZE - 1, qRound(std::log1p(static_cast<double>(count)) * scale))];
+    };
+    // Small counts dominate; look them up instead of taking a log per pixel
+    const quint32 cachedCounts = qMin<quint32>(maxCount + 1, 1024);
+    countColor.resize(cachedCounts);
+    countColor[0] = BACKGROUND_COLOR;
+    for (quint32 count = 1; count < cachedCounts; ++count) {
+        countColor[count] = densityRamp[qMin(DENSITY_RAMP_SIZE - 1, qRound(std::log1p(static_cast<double>(count)) * scale))];
+    }
+
+    for (int row = 0; row < height; ++row) {
+        QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(row));
+        const quint32* counts = density.data() + static_cast<std::size_t>(row) * width;
+        for (int column = 0; column < width; ++column) {
+            line[column] = colorFor(counts[column]);
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef FLEETMAPRASTERIZER_H
+#define FLEETMAPRASTERIZER_H
+
+#include <QImage>
+#include <QtGlobal>
+#include <cstddef>
+#include <vector>
+
+class FleetState;
+
+// Visible map area: an equirectangular view centred on a point
+struct MapViewport {
+    double centerLatitude;
+    double centerLongitude;
+    double pixelsPerDegree;  // along latitude; longitude is scaled by cos(latitude)
+    int width;
+    int height;
+};
+
+// Draws a whole fleet into a QImage by writing scanline memory directly,
+// with no QPainter call per drone. Every drone is projected once and
+// counted into a per-pixel density buffer. When the view holds only a few
+// drones per pixel, each is drawn as a small sprite coloured by battery
+// level. Otherwise the density buffer is tone-mapped instead, so zoomed-out
+// views of large swarms show where the drones are concentrated at a cost
+// that does not grow with overdraw.
+class FleetMapRasterizer {
+public:
+    enum Mode {
+        SPRITES = 0,
+        DENSITY = 1
+    };
+
+    // Visible drones per pixel above which the density view is used
+    static constexpr double DENSITY_THRESHOLD = 0.02;
+
+    FleetMapRasterizer();
+
+    // Resizes `image` to the viewport when needed and redraws it
+    void render(const FleetState& fleet, const MapViewport& viewport, QImage& image);
+
+    Mode getLastMode() const;
+    std::size_t getLastVisibleCount() const;
+
+    // Fits the fleet's bounding box (plus a margin) into a viewport of the given size
+    static MapViewport fitToFleet(const FleetState& fleet, int width, int height);
+
+private:
+    void drawSprites(const FleetState& fleet, const MapViewport& viewport, QImage& image);
+    void drawDensity(QImage& image, quint32 maxCount);
+
+    std::vector<quint32> density;
+    std::vector<QRgb> densityRamp;
+    Mode lastMode;
+    std::size_t lastVisibleCount;
+};
+
+#endif // FLEETMAPRASTERIZER_H
@@ -0,0 +1,117 @@
+#include "fleetmaprenderer.h"
+#include "fleetstate.h"
+
+FleetMapRenderer::FleetMapRenderer(QObject* parent)
+    : QObject(parent)
+    , stopping(false)
+    , hasRequest(false)
+    , requestViewport{0.0, 0.0, 1.0, 1, 1}
+    , front(0)
+    , backReady(false)
+    , backViewport{0.0, 0.0, 1.0, 1, 1}
+    , backMode(FleetMapRasterizer::SPRITES)
+    , frontViewport{0.0, 0.0, 1.0, 1, 1}
+    , frontMode(FleetMapRasterizer::SPRITES)
+    , renderedFrames(0)
+    , skippedRequests(0)
+{
+    worker = std::thread(&FleetMapRenderer::renderLoop, this);
+}
+
+FleetMapRenderer::~FleetMapRenderer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorker.notify_one();
+    worker.join();
+}
+
+void FleetMapRenderer::requestFrame(const FleetSnapshotPtr& snapshot, const MapViewport& viewport) {
+    if (!snapshot) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (hasRequest) {
+            skippedRequests.fetch_add(1, std::memory_order_relaxed);
+        }
+        requestSnapshot = snapshot;
+        requestViewport = viewport;
+        hasRequest = true;
+    }
+    wakeWorker.notify_one();
+}
+
+const QImage& FleetMapRenderer::takeFrame(MapViewport* viewport, FleetMapRasterizer::Mode* mode) {
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (backReady) {
+            // The old front becomes the worker's next canvas
+            front = 1 - front;
+            frontViewport = backViewport;
+            frontMode = backMode;
+            backReady = false;
+            wake = hasRequest;
+        }
+        if (viewport) {
+            *viewport = frontViewport;
+        }
+        if (mode) {
+            *mode = frontMode;
+        }
+    }
+    if (wake) {
+        wakeWorker.notify_one();
+    }
+    return buffers[front];
+}
+
+const QImage& FleetMapRenderer::getFrame() const {
+    // front only changes in takeFrame(), on the same thread as this
+    return buffers[front];
+}
+
+quint64 FleetMapRenderer::getRenderedFrames() const {
+    return renderedFrames.load(std::memory_order_relaxed);
+}
+
+quint64 FleetMapRenderer::getSkippedRequests() const {
+    return skippedRequests.load(std::memory_order_relaxed);
+}
+
+void FleetMapRenderer::renderLoop() {
+    FleetMapRasterizer rasterizer;
+
+    for (;;) {
+        FleetSnapshotPtr snapshot;
+        MapViewport viewport;
+        QImage* canvas = nullptr;
+        {
+            // A finished frame the GUI has not taken yet occupies the back buffer
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeWorker.wait(lock, [this] { return stopping || (hasRequest && !backReady); });
+            if (stopping) {
+                return;
+            }
+            snapshot = std::move(requestSnapshot);
+            requestSnapshot.reset();
+            viewport = requestViewport;
+            hasRequest = false;
+            canvas = &buffers[1 - front];
+        }
+
+        rasterizer.render(*snapshot, viewport, *canvas);
+        snapshot.reset();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            backReady = true;
+            backViewport = viewport;
+            backMode = rasterizer.getLastMode();
+        }
+        renderedFrames.fetch_add(1, std::memory_order_relaxed);
+        emit frameReady();
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef FLEETMAPRENDERER_H
+#define FLEETMAPRENDERER_H
+
+#include <QImage>
+#include <QObject>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "fleetmaprasterizer.h"
+#include "fleetsnapshot.h"
+
+// Rasterizes fleet maps on a worker thread. requestFrame() only records
+// the newest (snapshot, viewport) pair and wakes the worker, so requests
+// arriving faster than frames can be drawn collapse into one. When a
+// frame is done, frameReady() is emitted from the worker thread (connect
+// it queued) and takeFrame() hands the finished image to the GUI thread.
+// The renderer owns two buffers: the GUI reads the front one, the worker
+// draws into the back one, and takeFrame() swaps them. The worker waits
+// for that swap before drawing again, so neither buffer is ever shared
+// with the other thread (and so never detached and copied).
+class FleetMapRenderer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit FleetMapRenderer(QObject* parent = nullptr);
+    ~FleetMapRenderer() override;
+
+    FleetMapRenderer(const FleetMapRenderer&) = delete;
+    FleetMapRenderer& operator=(const FleetMapRenderer&) = delete;
+
+    void requestFrame(const FleetSnapshotPtr& snapshot, const MapViewport& viewport);
+
+    // Newest finished frame, the viewport it was drawn for and its draw mode.
+    // GUI thread only; the image stays valid until the next takeFrame().
+    const QImage& takeFrame(MapViewport* viewport = nullptr, FleetMapRasterizer::Mode* mode = nullptr);
+    // The frame the last takeFrame() returned
+    const QImage& getFrame() const;
+
+    quint64 getRenderedFrames() const;
+    // Requests replaced by a newer one before the worker picked them up
+    quint64 getSkippedRequests() const;
+
+signals:
+    void frameReady();
+
+private:
+    void renderLoop();
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeWorker;
+    bool stopping;
+
+    // Latest request, guarded by mutex
+    bool hasRequest;
+    FleetSnapshotPtr requestSnapshot;
+    MapViewport requestViewport;
+
+    // buffers[front] is read by the GUI thread, the other is drawn by the
+    // worker; front and the back* fields are guarded by mutex
+    QImage buffers[2];
+    int front;
+    bool backReady;  // the back buffer holds a frame not yet taken
+    MapViewport backViewport;
+    FleetMapRasterizer::Mode backMode;
+    MapViewport frontViewport;
+    FleetMapRasterizer::Mode frontMode;
+
+    std::atomic<quint64> renderedFrames;
+    std::atomic<quint64> skippedRequests;
+};
+
+#endif // FLEETMAPRENDERER_H
@@ -0,0 +1,176 @@
+#include "fleetmapwidget.h"
+#include "fleetstate.h"
+#include <QMouseEvent>
+#include <QPainter>
+#include <QWheelEvent>
+#include <QtMath>
+
+namespace {
+const double ZOOM_STEP = 1.25;  // per wheel notch
+const double MIN_PIXELS_PER_DEGREE = 1.0;
+const double MAX_PIXELS_PER_DEGREE = 1.0e7;
+}
+
+FleetMapWidget::FleetMapWidget(QWidget* parent)
+    : QWidget(parent)
+    , viewport(FleetMapRasterizer::fitToFleet(FleetState(), 1, 1))
+    , fitted(false)
+    , frameViewport(viewport)
+    , frameMode(FleetMapRasterizer::SPRITES)
+    , dragging(false)
+{
+    setMinimumHeight(200);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setCursor(Qt::OpenHandCursor);
+    connect(&renderer, &FleetMapRenderer::frameReady, this, &FleetMapWidget::onFrameReady,
+            Qt::QueuedConnection);
+}
+
+void FleetMapWidget::updateFleet(const FleetSnapshotPtr& snapshot) {
+    if (!snapshot) {
+        return;
+    }
+    latestSnapshot = snapshot;
+    if (!fitted && !snapshot->isEmpty()) {
+        fitToFleet();
+        return;
+    }
+    requestRender();
+}
+
+void FleetMapWidget::fitToFleet() {
+    if (!latestSnapshot) {
+        return;
+    }
+    viewport = FleetMapRasterizer::fitToFleet(*latestSnapshot, width(), height());
+    fitted = true;
+    requestRender();
+}
+
+MapViewport FleetMapWidget::getViewport() const {
+    return viewport;
+}
+
+void FleetMapWidget::paintEvent(QPaintEvent* event) {
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(0x1a, 0x20, 0x2c));
+    const QImage& frame = renderer.getFrame();
+    if (frame.isNull()) {
+        return;
+    }
+
+    // Blit the newest frame (device pixels 1:1); while a pan is still being
+    // rendered, shift the previous frame by the distance moved so far
+    const MapViewport current = deviceViewport();
+    const qreal ratio = devicePixelRatioF();
+    if (qFuzzyCompare(current.pixelsPerDegree, frameViewport.pixelsPerDegree)) {
+        const double cosLatitude = qCos(qDegreesToRadians(current.centerLatitude));
+        const double dx = (frameViewport.centerLongitude - current.centerLongitude)
+                          * current.pixelsPerDegree * cosLatitude;
+        const double dy = (current.centerLatitude - frameViewport.centerLatitude) * current.pixelsPerDegree;
+        painter.drawImage(QRectF((dx + 0.5 * (current.width - frame.width())) / ratio,
+                                 (dy + 0.5 * (current.height - frame.height())) / ratio,
+                                 frame.width() / ratio, frame.height() / ratio), frame);
+    } else {
+        painter.drawImage(QRectF(rect()), frame);
+    }
+
+    const char* mode = frameMode == FleetMapRasterizer::DENSITY ? "density" : "drones";
+    painter.setPen(QColor(0xe2, 0xe8, 0xf0));
+    painter.drawText(rect().adjusted(8, 4, -8, -4), Qt::AlignTop | Qt::AlignLeft,
+                     QString("%1 drones (%2 view)")
+                     .arg(static_cast<qulonglong>(latestSnapshot ? latestSnapshot->size() : 0))
+                     .arg(mode));
+}
+
+void FleetMapWidget::resizeEvent(QResizeEvent* event) {
+    QWidget::resizeEvent(event);
+    viewport.width = width();
+    viewport.height = height();
+    requestRender();
+}
+
+void FleetMapWidget::showEvent(QShowEvent* event) {
+    QWidget::showEvent(event);
+    // Ticks that arrived while hidden were not rendered
+    requestRender();
+}
+
+void FleetMapWidget::mousePressEvent(QMouseEvent* event) {
+    if (event->button() == Qt::LeftButton) {
+        dragging = true;
+        lastDragPosition = event->position().toPoint();
+        setCursor(Qt::ClosedHandCursor);
+    }
+}
+
+void FleetMapWidget::mouseMoveEvent(QMouseEvent* event) {
+    if (!dragging) {
+        return;
+    }
+    const QPoint position = event->position().toPoint();
+    const QPoint delta = position - lastDragPosition;
+    lastDragPosition = position;
+
+    const double cosLatitude = qCos(qDegreesToRadians(viewport.centerLatitude));
+    viewport.centerLongitude -= delta.x() / (viewport.pixelsPerDegree * cosLatitude);
+    viewport.centerLatitude += delta.y() / viewport.pixelsPerDegree;
+    requestRender();
+    QWidget::update();
+}
+
+void FleetMapWidget::mouseReleaseEvent(QMouseEvent* event) {
+    if (event->button() == Qt::LeftButton) {
+        dragging = false;
+        setCursor(Qt::OpenHandCursor);
+    }
+}
+
+void FleetMapWidget::mouseDoubleClickEvent(QMouseEvent* event) {
+    Q_UNUSED(event);
+    fitToFleet();
+}
+
+void FleetMapWidget::wheelEvent(QWheelEvent* event) {
+    const double notches = event->angleDelta().y() / 120.0;
+    if (notches == 0.0) {
+        return;
+    }
+
+    // Keep the point under the cursor fixed while zooming
+    const QPointF cursor = event->position();
+    const double cosLatitude = qCos(qDegreesToRadians(viewport.centerLatitude));
+    const double offsetX = cursor.x() - 0.5 * width();
+    const double offsetY = cursor.y() - 0.5 * height();
+    const double cursorLongitude = viewport.centerLongitude + offsetX / (viewport.pixelsPerDegree * cosLatitude);
+    const double cursorLatitude = viewport.centerLatitude - offsetY / viewport.pixelsPerDegree;
+
+    viewport.pixelsPerDegree = qBound(MIN_PIXELS_PER_DEGREE,
+                                      viewport.pixelsPerDegree * qPow(ZOOM_STEP, notches),
+                                      MAX_PIXELS_PER_DEGREE);
+    viewport.centerLongitude = cursorLongitude - offsetX / (viewport.pixelsPerDegree * cosLatitude);
+    viewport.centerLatitude = cursorLatitude + offsetY / viewport.pixelsPerDegree;
+    requestRender();
+    event->accept();
+}
+
+void FleetMapWidget::onFrameReady() {
+    renderer.takeFrame(&frameViewport, &frameMode);
+    QWidget::update();
+}
+
+void FleetMapWidget::requestRender() {
+    if (latestSnapshot && isVisible()) {
+        renderer.requestFrame(latestSnapshot, deviceViewport());
+    }
+}
+
+MapViewport FleetMapWidget::deviceViewport() const {
+    const qreal ratio = devicePixelRatioF();
+    MapViewport device = viewport;
+    device.width = qMax(1, qRound(width() * ratio));
+    device.height = qMax(1, qRound(height() * ratio));
+    device.pixelsPerDegree = viewport.pixelsPerDegree * ratio;
+    return device;
+}
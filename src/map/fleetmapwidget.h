@@ -0,0 +1,56 @@
+#ifndef FLEETMAPWIDGET_H
+#define FLEETMAPWIDGET_H
+
+#include <QPoint>
+#include <QWidget>
+#include "fleetmaprenderer.h"
+#include "observer.h"
+
+// Map of the whole fleet. As an observer it forwards each tick's snapshot
+// to a FleetMapRenderer and the GUI thread only blits finished frames, so
+// painting stays cheap whatever the fleet size. Drag to pan, wheel to
+// zoom about the cursor, double-click to fit the fleet again.
+class FleetMapWidget : public QWidget, public Observer {
+    Q_OBJECT
+
+public:
+    explicit FleetMapWidget(QWidget* parent = nullptr);
+
+    // Observer pattern implementation; only whole-fleet updates are drawn
+    void updateFleet(const FleetSnapshotPtr& snapshot) override;
+
+    void fitToFleet();
+    MapViewport getViewport() const;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+
+private slots:
+    void onFrameReady();
+
+private:
+    void requestRender();
+    // Viewport in device pixels, as rendered
+    MapViewport deviceViewport() const;
+
+    FleetMapRenderer renderer;
+    FleetSnapshotPtr latestSnapshot;
+    MapViewport viewport;  // logical pixels
+    bool fitted;
+
+    // Of renderer.getFrame()
+    MapViewport frameViewport;
+    FleetMapRasterizer::Mode frameMode;
+
+    bool dragging;
+    QPoint lastDragPosition;
+};
+
+#endif // FLEETMAPWIDGET_H
@@ -1,5 +1,8 @@
 #include "hoverstrategy.h"
 #include "dronedata.h"
+#include "fleetstate.h"
+#include "movementkernels.h"
+#include "simulationcheckpoint.h"
 #include <QtMath>
 #include <QRandomGenerator>
 
@@ -8,6 +11,8 @@ HoverStrategy::HoverStrategy()
     , centerLat(28.4595)
     , centerLon(77.0266)
     , angle(0.0)
+    , random(QRandomGenerator::global()->generate64())
+    , updateCalls(0)
 {
 }
 
@@ -19,7 +24,7 @@ void HoverStrategy::updatePosition(DroneData& drone) {
     }
 
     // Add small random variations
-    double randomFactor = 0.5 + QRandomGenerator::global()->generateDouble();
+    double randomFactor = 0.5 + random.uniform(0, updateCalls, 0);
     double currentRadius = hoverRadius * randomFactor;
 
     double newLat = centerLat + currentRadius * qCos(angle);
@@ -29,16 +34,100 @@ void HoverStrategy::updatePosition(DroneData& drone) {
     drone.setLongitude(newLon);
 
     // Slight altitude variation
-    double altVariation = -2.0 + QRandomGenerator::global()->generateDouble();
+    double altVariation = -2.0 + random.uniform(0, updateCalls, 1);
     drone.setAltitude(100.0 + altVariation);
 
     // Update heading to face movement direction
     drone.setHeading(qRadiansToDegrees(angle));
 
     // Low speed for hovering
-    drone.setSpeed(0.5 + QRandomGenerator::global()->generateDouble());
+    drone.setSpeed(0.5 + random.uniform(0, updateCalls, 2));
+    ++updateCalls;
+}
+
+bool HoverStrategy::supportsParallelUpdates() const {
+    return true;
+}
+
+void HoverStrategy::prepare(const FleetState& fleet, const TickContext& context) {
+    ensureDroneState(fleet, fleet.size(), context);
+}
+
+void HoverStrategy::updatePositions(FleetState& fleet, std::size_t begin, std::size_t end,
+                                   const TickContext& context) {
+    if (begin >= end) {
+        return;
+    }
+    ensureDroneState(fleet, end, context);
+
+    // Same 0.1 rad per 2 Hz tick as updatePosition(), expressed per dt
+    const double stepScale = context.dt / REFERENCE_STEP_SECONDS;
+    const MovementKernels::HoverParams params{hoverRadius, 0.1 * stepScale, 100.0};
+    const PhiloxRng rangeRandom(context.seed, PhiloxRng::MOVEMENT);
+    quint64 randomBits[MovementKernels::BLOCK_SIZE * MovementKernels::HOVER_DRAWS];
+
+    for (std::size_t block = begin; block < end; block += MovementKernels::BLOCK_SIZE) {
+        // Draw the block's random numbers up front so the kernel stays branch-free.
+        // The drone index is the stream, so a drone sees the same draws whatever chunk it is in.
+        const std::size_t count = qMin(MovementKernels::BLOCK_SIZE, end - block);
+        rangeRandom.fillBitPlanes(block, context.tick, count, MovementKernels::HOVER_DRAWS, randomBits);
+
+        MovementKernels::HoverLanes lanes{
+            droneCenterLat.data() + block,
+            droneCenterLon.data() + block,
+            droneAngle.data() + block,
+            fleet.latitudes() + block,
+            fleet.longitudes() + block,
+            fleet.altitudes() + block,
+            fleet.headings() + block,
+            fleet.speeds() + block
+        };
+        MovementKernels::hover(params, lanes, randomBits, count);
+    }
+}
+
+void HoverStrategy::ensureDroneState(const FleetState& fleet, std::size_t end,
+                                    const TickContext& context) {
+    Q_UNUSED(context);
+
+    // Drop state for drones that have left the fleet
+    if (droneAngle.size() > fleet.size()) {
+        droneCenterLat.resize(fleet.size());
+        droneCenterLon.resize(fleet.size());
+        droneAngle.resize(fleet.size());
+    }
+
+    for (std::size_t i = droneAngle.size(); i < end; ++i) {
+        droneCenterLat.push_back(fleet.latitudes()[i]);
+        droneCenterLon.push_back(fleet.longitudes()[i]);
+        droneAngle.push_back(angle);
+    }
 }
 
 QString HoverStrategy::getStrategyName() const {
     return "Hover Mode";
 }
+
+void HoverStrategy::saveState(CheckpointWriter& writer) const {
+    writer.write(hoverRadius);
+    writer.write(centerLat);
+    writer.write(centerLon);
+    writer.write(angle);
+    writer.write(random.seed());
+    writer.write(updateCalls);
+    writer.writeArray(droneCenterLat);
+    writer.writeArray(droneCenterLon);
+    writer.writeArray(droneAngle);
+}
+
+bool HoverStrategy::restoreState(CheckpointReader& reader) {
+    quint64 seed = 0;
+    if (!reader.read(hoverRadius) || !reader.read(centerLat) || !reader.read(centerLon)
+        || !reader.read(angle) || !reader.read(seed) || !reader.read(updateCalls)
+        || !reader.readArray(droneCenterLat) || !reader.readArray(droneCenterLon)
+        || !reader.readArray(droneAngle)) {
+        return false;
+    }
+    random.setSeed(seed);
+    return droneCenterLat.size() == droneAngle.size() && droneCenterLon.size() == droneAngle.size();
+}
@@ -2,19 +2,40 @@
 #define HOVERSTRATEGY_H
 
 #include "movementstrategy.h"
+#include "philoxrng.h"
 #include <QString>
+#include <QtGlobal>
+#include <vector>
 
 class HoverStrategy : public MovementStrategy {
 public:
     HoverStrategy();
     void updatePosition(DroneData& drone) override;
+    bool supportsParallelUpdates() const override;
+    void prepare(const FleetState& fleet, const TickContext& context) override;
+    void updatePositions(FleetState& fleet, std::size_t begin, std::size_t end,
+                         const TickContext& context) override;
     QString getStrategyName() const override;
+    void saveState(CheckpointWriter& writer) const override;
+    bool restoreState(CheckpointReader& reader) override;
 
 private:
+    void ensureDroneState(const FleetState& fleet, std::size_t end, const TickContext& context);
+
     double hoverRadius;
     double centerLat;
     double centerLon;
     double angle;
+
+    // Single-drone path draws from its own stream, one tick per call
+    PhiloxRng random;
+    quint64 updateCalls;
+
+    // Per-drone state for the batch path, indexed by fleet position.
+    // Each drone hovers around where it was when it joined the strategy.
+    std::vector<double> droneCenterLat;
+    std::vector<double> droneCenterLon;
+    std::vector<double> droneAngle;
 };
 
 #endif // HOVERSTRATEGY_H
\ No newline at end of file
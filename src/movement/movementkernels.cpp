@@ -0,0 +1,543 @@
+#include "movementkernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MOVEMENT_KERNELS_X86 1
+#define KERNEL_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define MOVEMENT_KERNELS_X86 1
+#define KERNEL_TARGET(isa)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace MovementKernels {
+
+namespace {
+
+const double TWO_PI = 6.28318530717958647692;
+const double RAD_TO_DEG = 180.0 / 3.14159265358979323846;
+const double TWO_OVER_PI = 0.63661977236758134308;
+
+// Adding 1.5 * 2^52 rounds to the nearest integer and leaves it in the low
+// mantissa bits, which gives the quadrant without a float->int conversion
+const double ROUND_MAGIC = 6755399441055744.0;
+
+// pi/2 split into three parts for Cody-Waite reduction
+const double PIO2_1 = 1.57079625129699707031e+00;
+const double PIO2_2 = 7.54978941586159635336e-08;
+const double PIO2_3 = 5.39030285815811905290e-15;
+
+// Cephes sin/cos minimax coefficients on [-pi/4, pi/4]
+const double SIN_0 = 1.58962301576546568060e-10;
+const double SIN_1 = -2.50507477628578072866e-8;
+const double SIN_2 = 2.75573136213857245213e-6;
+const double SIN_3 = -1.98412698295895385996e-4;
+const double SIN_4 = 8.33333333332211858878e-3;
+const double SIN_5 = -1.66666666666666307295e-1;
+
+const double COS_0 = -1.13585365213876817300e-11;
+const double COS_1 = 2.08757008419747316778e-9;
+const double COS_2 = -2.75573141792967388112e-7;
+const double COS_3 = 2.48015872888517045348e-5;
+const double COS_4 = -1.38888888888730564116e-3;
+const double COS_5 = 4.16666666666665929218e-2;
+
+const std::uint64_t EXPONENT_ONE = 0x3FF0000000000000ULL;
+
+std::atomic<int> activeSet(-1);
+
+// ---------------------------------------------------------------------------
+// Scalar reference. Every vector path below mirrors these operations exactly.
+// ---------------------------------------------------------------------------
+
+inline double bitsToUnit(std::uint64_t bits) {
+    // 52 random mantissa bits under exponent 0 give [1, 2); shift to [0, 1)
+    std::uint64_t mantissa = (bits >> 12) | EXPONENT_ONE;
+    double value;
+    std::memcpy(&value, &mantissa, sizeof(value));
+    return value - 1.0;
+}
+
+inline double flipSign(double value, std::uint64_t signBit) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits ^= signBit;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline void sinCosScalar(double x, double& sinOut, double& cosOut) {
+    double t = x * TWO_OVER_PI + ROUND_MAGIC;
+    double q = t - ROUND_MAGIC;
+    std::uint64_t quadrant;
+    std::memcpy(&quadrant, &t, sizeof(quadrant));
+
+    double r = ((x - q * PIO2_1) - q * PIO2_2) - q * PIO2_3;
+    double z = r * r;
+
+    double sinPoly = ((((SIN_0 * z + SIN_1) * z + SIN_2) * z + SIN_3) * z + SIN_4) * z + SIN_5;
+    sinPoly = r + r * z * sinPoly;
+    double cosPoly = ((((COS_0 * z + COS_1) * z + COS_2) * z + COS_3) * z + COS_4) * z + COS_5;
+    cosPoly = (1.0 - 0.5 * z) + z * z * cosPoly;
+
+    bool swap = (quadrant & 1) != 0;
+    sinOut = flipSign(swap ? cosPoly : sinPoly, (quadrant & 2) << 62);
+    cosOut = flipSign(swap ? sinPoly : cosPoly, ((quadrant + 1) & 2) << 62);
+}
+
+inline void hoverScalar(const HoverParams& params, const HoverLanes& lanes,
+                        const std::uint64_t* randomBits, std::size_t count,
+                        std::size_t begin) {
+    for (std::size_t i = begin; i < count; ++i) {
+        double angle = lanes.angle[i] + params.angleStep;
+        angle = (angle >= TWO_PI) ? 0.0 : angle;
+        lanes.angle[i] = angle;
+
+        double s, c;
+        sinCosScalar(angle, s, c);
+
+        double radius = params.hoverRadius * (0.5 + bitsToUnit(randomBits[i]));
+        lanes.latitude[i] = lanes.centerLat[i] + radius * c;
+        lanes.longitude[i] = lanes.centerLon[i] + radius * s;
+        lanes.altitude[i] = params.baseAltitude + (-2.0 + bitsToUnit(randomBits[count + i]));
+        lanes.heading[i] = angle * RAD_TO_DEG;
+        lanes.speed[i] = 0.5 + bitsToUnit(randomBits[2 * count + i]);
+    }
+}
+
+inline void randomWalkScalar(const RandomWalkParams& params, const RandomWalkLanes& lanes,
+                             const std::uint64_t* randomBits, std::size_t count,
+                             std::size_t begin) {
+    for (std::size_t i = begin; i < count; ++i) {
+        double roll = bitsToUnit(randomBits[i]);
+        double newDirection = bitsToUnit(randomBits[count + i]) * TWO_PI;
+        double direction = (roll < params.directionChangeChance) ? newDirection : lanes.direction[i];
+        lanes.direction[i] = direction;
+
+        double s, c;
+        sinCosScalar(direction, s, c);
+
+        double stepSize = bitsToUnit(randomBits[2 * count + i]) * params.maxStepSize;
+        double latitude = lanes.latitude[i] + stepSize * c;
+        double longitude = lanes.longitude[i] + stepSize * s;
+        double altitude = lanes.altitude[i] + (bitsToUnit(randomBits[3 * count + i]) - 0.5) * params.climbRange;
+
+        lanes.latitude[i] = std::max(params.minLatitude, std::min(params.maxLatitude, latitude));
+        lanes.longitude[i] = std::max(params.minLongitude, std::min(params.maxLongitude, longitude));
+        lanes.altitude[i] = std::max(params.minAltitude, std::min(params.maxAltitude, altitude));
+        lanes.heading[i] = direction * RAD_TO_DEG;
+        lanes.speed[i] = stepSize * params.speedScale;
+    }
+}
+
+#ifdef MOVEMENT_KERNELS_X86
+
+// ---------------------------------------------------------------------------
+// SSE2: two drones per instruction
+// ---------------------------------------------------------------------------
+
+KERNEL_TARGET("sse2")
+inline __m128d bitsToUnitSse2(__m128i bits) {
+    __m128i mantissa = _mm_or_si128(_mm_srli_epi64(bits, 12),
+                                    _mm_set1_epi64x(static_cast<long long>(EXPONENT_ONE)));
+    return _mm_sub_pd(_mm_castsi128_pd(mantissa), _mm_set1_pd(1.0));
+}
+
+KERNEL_TARGET("sse2")
+inline __m128d selectSse2(__m128d mask, __m128d ifTrue, __m128d ifFalse) {
+    return _mm_or_pd(_mm_and_pd(mask, ifTrue), _mm_andnot_pd(mask, ifFalse));
+}
+
+KERNEL_TARGET("sse2")
+inline __m128d polySse2(__m128d z, double c0, double c1, double c2, double c3, double c4, double c5) {
+    __m128d p = _mm_add_pd(_mm_mul_pd(_mm_set1_pd(c0), z), _mm_set1_pd(c1));
+    p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(c2));
+    p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(c3));
+    p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(c4));
+    return _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(c5));
+}
+
+KERNEL_TARGET("sse2")
+inline void sinCosSse2(__m128d x, __m128d& sinOut, __m128d& cosOut) {
+    const __m128d magic = _mm_set1_pd(ROUND_MAGIC);
+    __m128d t = _mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(TWO_OVER_PI)), magic);
+    __m128d q = _mm_sub_pd(t, magic);
+    __m128i quadrant = _mm_castpd_si128(t);
+
+    __m128d r = _mm_sub_pd(x, _mm_mul_pd(q, _mm_set1_pd(PIO2_1)));
+    r = _mm_sub_pd(r, _mm_mul_pd(q, _mm_set1_pd(PIO2_2)));
+    r = _mm_sub_pd(r, _mm_mul_pd(q, _mm_set1_pd(PIO2_3)));
+    __m128d z = _mm_mul_pd(r, r);
+
+    __m128d sinPoly = polySse2(z, SIN_0, SIN_1, SIN_2, SIN_3, SIN_4, SIN_5);
+    sinPoly = _mm_add_pd(r, _mm_mul_pd(_mm_mul_pd(r, z), sinPoly));
+    __m128d cosPoly = polySse2(z, COS_0, COS_1, COS_2, COS_3, COS_4, COS_5);
+    cosPoly = _mm_add_pd(_mm_sub_pd(_mm_set1_pd(1.0), _mm_mul_pd(_mm_set1_pd(0.5), z)),
+                         _mm_mul_pd(_mm_mul_pd(z, z), cosPoly));
+
+    // Low two bits of the quadrant. SSE2 has no 64-bit compare, so the swap
+    // mask is built as 0 - (quadrant & 1), which is all ones or all zeros
+    const __m128i one = _mm_set1_epi64x(1);
+    const __m128i two = _mm_set1_epi64x(2);
+    __m128d swap = _mm_castsi128_pd(
+        _mm_sub_epi64(_mm_setzero_si128(), _mm_and_si128(quadrant, one)));
+    __m128d sinSign = _mm_castsi128_pd(_mm_slli_epi64(_mm_and_si128(quadrant, two), 62));
+    __m128d cosSign = _mm_castsi128_pd(
+        _mm_slli_epi64(_mm_and_si128(_mm_add_epi64(quadrant, one), two), 62));
+
+    sinOut = _mm_xor_pd(selectSse2(swap, cosPoly, sinPoly), sinSign);
+    cosOut = _mm_xor_pd(selectSse2(swap, sinPoly, cosPoly), cosSign);
+}
+
+KERNEL_TARGET("sse2")
+inline __m128i loadBitsSse2(const std::uint64_t* bits) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bits));
+}
+
+KERNEL_TARGET("sse2")
+void sinCosSse2Loop(const double* angle, double* sinOut, double* cosOut, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d s, c;
+        sinCosSse2(_mm_loadu_pd(angle + i), s, c);
+        _mm_storeu_pd(sinOut + i, s);
+        _mm_storeu_pd(cosOut + i, c);
+    }
+    for (; i < count; ++i) {
+        sinCosScalar(angle[i], sinOut[i], cosOut[i]);
+    }
+}
+
+KERNEL_TARGET("sse2")
+void hoverSse2(const HoverParams& params, const HoverLanes& lanes,
+               const std::uint64_t* randomBits, std::size_t count) {
+    const __m128d angleStep = _mm_set1_pd(params.angleStep);
+    const __m128d twoPi = _mm_set1_pd(TWO_PI);
+    const __m128d hoverRadius = _mm_set1_pd(params.hoverRadius);
+    const __m128d baseAltitude = _mm_set1_pd(params.baseAltitude);
+    const __m128d half = _mm_set1_pd(0.5);
+    const __m128d minusTwo = _mm_set1_pd(-2.0);
+    const __m128d radToDeg = _mm_set1_pd(RAD_TO_DEG);
+
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d angle = _mm_add_pd(_mm_loadu_pd(lanes.angle + i), angleStep);
+        angle = _mm_andnot_pd(_mm_cmpge_pd(angle, twoPi), angle);
+        _mm_storeu_pd(lanes.angle + i, angle);
+
+        __m128d s, c;
+        sinCosSse2(angle, s, c);
+
+        __m128d radius = _mm_mul_pd(hoverRadius,
+            _mm_add_pd(half, bitsToUnitSse2(loadBitsSse2(randomBits + i))));
+        _mm_storeu_pd(lanes.latitude + i,
+            _mm_add_pd(_mm_loadu_pd(lanes.centerLat + i), _mm_mul_pd(radius, c)));
+        _mm_storeu_pd(lanes.longitude + i,
+            _mm_add_pd(_mm_loadu_pd(lanes.centerLon + i), _mm_mul_pd(radius, s)));
+        _mm_storeu_pd(lanes.altitude + i, _mm_add_pd(baseAltitude,
+            _mm_add_pd(minusTwo, bitsToUnitSse2(loadBitsSse2(randomBits + count + i)))));
+        _mm_storeu_pd(lanes.heading + i, _mm_mul_pd(angle, radToDeg));
+        _mm_storeu_pd(lanes.speed + i,
+            _mm_add_pd(half, bitsToUnitSse2(loadBitsSse2(randomBits + 2 * count + i))));
+    }
+    hoverScalar(params, lanes, randomBits, count, i);
+}
+
+KERNEL_TARGET("sse2")
+void randomWalkSse2(const RandomWalkParams& params, const RandomWalkLanes& lanes,
+                    const std::uint64_t* randomBits, std::size_t count) {
+    const __m128d changeChance = _mm_set1_pd(params.directionChangeChance);
+    const __m128d twoPi = _mm_set1_pd(TWO_PI);
+    const __m128d maxStep = _mm_set1_pd(params.maxStepSize);
+    const __m128d half = _mm_set1_pd(0.5);
+    const __m128d climbRange = _mm_set1_pd(params.climbRange);
+    const __m128d speedScale = _mm_set1_pd(params.speedScale);
+    const __m128d radToDeg = _mm_set1_pd(RAD_TO_DEG);
+    const __m128d minLat = _mm_set1_pd(params.minLatitude);
+    const __m128d maxLat = _mm_set1_pd(params.maxLatitude);
+    const __m128d minLon = _mm_set1_pd(params.minLongitude);
+    const __m128d maxLon = _mm_set1_pd(params.maxLongitude);
+    const __m128d minAlt = _mm_set1_pd(params.minAltitude);
+    const __m128d maxAlt = _mm_set1_pd(params.maxAltitude);
+
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d roll = bitsToUnitSse2(loadBitsSse2(randomBits + i));
+        __m128d newDirection = _mm_mul_pd(bitsToUnitSse2(loadBitsSse2(randomBits + count + i)), twoPi);
+        __m128d direction = selectSse2(_mm_cmplt_pd(roll, changeChance),
+                                       newDirection, _mm_loadu_pd(lanes.direction + i));
+        _mm_storeu_pd(lanes.direction + i, direction);
+
+        __m128d s, c;
+        sinCosSse2(direction, s, c);
+
+        __m128d stepSize = _mm_mul_pd(bitsToUnitSse2(loadBitsSse2(randomBits + 2 * count + i)), maxStep);
+        __m128d latitude = _mm_add_pd(_mm_loadu_pd(lanes.latitude + i), _mm_mul_pd(stepSize, c));
+        __m128d longitude = _mm_add_pd(_mm_loadu_pd(lanes.longitude + i), _mm_mul_pd(stepSize, s));
+        __m128d climb = _mm_mul_pd(
+            _mm_sub_pd(bitsToUnitSse2(loadBitsSse2(randomBits + 3 * count + i)), half), climbRange);
+        __m128d altitude = _mm_add_pd(_mm_loadu_pd(lanes.altitude + i), climb);
+
+        _mm_storeu_pd(lanes.latitude + i, _mm_max_pd(_mm_min_pd(latitude, maxLat), minLat));
+        _mm_storeu_pd(lanes.longitude + i, _mm_max_pd(_mm_min_pd(longitude, maxLon), minLon));
+        _mm_storeu_pd(lanes.altitude + i, _mm_max_pd(_mm_min_pd(altitude, maxAlt), minAlt));
+        _mm_storeu_pd(lanes.heading + i, _mm_mul_pd(direction, radToDeg));
+        _mm_storeu_pd(lanes.speed + i, _mm_mul_pd(stepSize, speedScale));
+    }
+    randomWalkScalar(params, lanes, randomBits, count, i);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2: four drones per instruction
+// ---------------------------------------------------------------------------
+
+KERNEL_TARGET("avx2")
+inline __m256d bitsToUnitAvx2(__m256i bits) {
+    __m256i mantissa = _mm256_or_si256(_mm256_srli_epi64(bits, 12),
+                                       _mm256_set1_epi64x(static_cast<long long>(EXPONENT_ONE)));
+    return _mm256_sub_pd(_mm256_castsi256_pd(mantissa), _mm256_set1_pd(1.0));
+}
+
+KERNEL_TARGET("avx2")
+inline __m256d polyAvx2(__m256d z, double c0, double c1, double c2, double c3, double c4, double c5) {
+    __m256d p = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(c0), z), _mm256_set1_pd(c1));
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(c2));
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(c3));
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(c4));
+    return _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(c5));
+}
+
+KERNEL_TARGET("avx2")
+inline void sinCosAvx2(__m256d x, __m256d& sinOut, __m256d& cosOut) {
+    const __m256d magic = _mm256_set1_pd(ROUND_MAGIC);
+    __m256d t = _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(TWO_OVER_PI)), magic);
+    __m256d q = _mm256_sub_pd(t, magic);
+    __m256i quadrant = _mm256_castpd_si256(t);
+
+    __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(q, _mm256_set1_pd(PIO2_1)));
+    r = _mm256_sub_pd(r, _mm256_mul_pd(q, _mm256_set1_pd(PIO2_2)));
+    r = _mm256_sub_pd(r, _mm256_mul_pd(q, _mm256_set1_pd(PIO2_3)));
+    __m256d z = _mm256_mul_pd(r, r);
+
+    __m256d sinPoly = polyAvx2(z, SIN_0, SIN_1, SIN_2, SIN_3, SIN_4, SIN_5);
+    sinPoly = _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(r, z), sinPoly));
+    __m256d cosPoly = polyAvx2(z, COS_0, COS_1, COS_2, COS_3, COS_4, COS_5);
+    cosPoly = _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(_mm256_set1_pd(0.5), z)),
+                            _mm256_mul_pd(_mm256_mul_pd(z, z), cosPoly));
+
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i two = _mm256_set1_epi64x(2);
+    __m256d swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(quadrant, one), one));
+    __m256d sinSign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(quadrant, two), 62));
+    __m256d cosSign = _mm256_castsi256_pd(
+        _mm256_slli_epi64(_mm256_and_si256(_mm256_add_epi64(quadrant, one), two), 62));
+
+    sinOut = _mm256_xor_pd(_mm256_blendv_pd(sinPoly, cosPoly, swap), sinSign);
+    cosOut = _mm256_xor_pd(_mm256_blendv_pd(cosPoly, sinPoly, swap), cosSign);
+}
+
+KERNEL_TARGET("avx2")
+inline __m256i loadBitsAvx2(const std::uint64_t* bits) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits));
+}
+
+KERNEL_TARGET("avx2")
+void sinCosAvx2Loop(const double* angle, double* sinOut, double* cosOut, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d s, c;
+        sinCosAvx2(_mm256_loadu_pd(angle + i), s, c);
+        _mm256_storeu_pd(sinOut + i, s);
+        _mm256_storeu_pd(cosOut + i, c);
+    }
+    for (; i < count; ++i) {
+        sinCosScalar(angle[i], sinOut[i], cosOut[i]);
+    }
+}
+
+KERNEL_TARGET("avx2")
+void hoverAvx2(const HoverParams& params, const HoverLanes& lanes,
+               const std::uint64_t* randomBits, std::size_t count) {
+    const __m256d angleStep = _mm256_set1_pd(params.angleStep);
+    const __m256d twoPi = _mm256_set1_pd(TWO_PI);
+    const __m256d hoverRadius = _mm256_set1_pd(params.hoverRadius);
+    const __m256d baseAltitude = _mm256_set1_pd(params.baseAltitude);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d minusTwo = _mm256_set1_pd(-2.0);
+    const __m256d radToDeg = _mm256_set1_pd(RAD_TO_DEG);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d angle = _mm256_add_pd(_mm256_loadu_pd(lanes.angle + i), angleStep);
+        angle = _mm256_andnot_pd(_mm256_cmp_pd(angle, twoPi, _CMP_GE_OQ), angle);
+        _mm256_storeu_pd(lanes.angle + i, angle);
+
+        __m256d s, c;
+        sinCosAvx2(angle, s, c);
+
+        __m256d radius = _mm256_mul_pd(hoverRadius,
+            _mm256_add_pd(half, bitsToUnitAvx2(loadBitsAvx2(randomBits + i))));
+        _mm256_storeu_pd(lanes.latitude + i,
+            _mm256_add_pd(_mm256_loadu_pd(lanes.centerLat + i), _mm256_mul_pd(radius, c)));
+        _mm256_storeu_pd(lanes.longitude + i,
+            _mm256_add_pd(_mm256_loadu_pd(lanes.centerLon + i), _mm256_mul_pd(radius, s)));
+        _mm256_storeu_pd(lanes.altitude + i, _mm256_add_pd(baseAltitude,
+            _mm256_add_pd(minusTwo, bitsToUnitAvx2(loadBitsAvx2(randomBits + count + i)))));
+        _mm256_storeu_pd(lanes.heading + i, _mm256_mul_pd(angle, radToDeg));
+        _mm256_storeu_pd(lanes.speed + i,
+            _mm256_add_pd(half, bitsToUnitAvx2(loadBitsAvx2(randomBits + 2 * count + i))));
+    }
+    hoverScalar(params, lanes, randomBits, count, i);
+}
+
+KERNEL_TARGET("avx2")
+void randomWalkAvx2(const RandomWalkParams& params, const RandomWalkLanes& lanes,
+                    const std::uint64_t* randomBits, std::size_t count) {
+    const __m256d changeChance = _mm256_set1_pd(params.directionChangeChance);
+    const __m256d twoPi = _mm256_set1_pd(TWO_PI);
+    const __m256d maxStep = _mm256_set1_pd(params.maxStepSize);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d climbRange = _mm256_set1_pd(params.climbRange);
+    const __m256d speedScale = _mm256_set1_pd(params.speedScale);
+    const __m256d radToDeg = _mm256_set1_pd(RAD_TO_DEG);
+    const __m256d minLat = _mm256_set1_pd(params.minLatitude);
+    const __m256d maxLat = _mm256_set1_pd(params.maxLatitude);
+    const __m256d minLon = _mm256_set1_pd(params.minLongitude);
+    const __m256d maxLon = _mm256_set1_pd(params.maxLongitude);
+    const __m256d minAlt = _mm256_set1_pd(params.minAltitude);
+    const __m256d maxAlt = _mm256_set1_pd(params.maxAltitude);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d roll = bitsToUnitAvx2(loadBitsAvx2(randomBits + i));
+        __m256d newDirection = _mm256_mul_pd(bitsToUnitAvx2(loadBitsAvx2(randomBits + count + i)), twoPi);
+        __m256d direction = _mm256_blendv_pd(_mm256_loadu_pd(lanes.direction + i), newDirection,
+                                             _mm256_cmp_pd(roll, changeChance, _CMP_LT_OQ));
+        _mm256_storeu_pd(lanes.direction + i, direction);
+
+        __m256d s, c;
+        sinCosAvx2(direction, s, c);
+
+        __m256d stepSize = _mm256_mul_pd(bitsToUnitAvx2(loadBitsAvx2(randomBits + 2 * count + i)), maxStep);
+        __m256d latitude = _mm256_add_pd(_mm256_loadu_pd(lanes.latitude + i), _mm256_mul_pd(stepSize, c));
+        __m256d longitude = _mm256_add_pd(_mm256_loadu_pd(lanes.longitude + i), _mm256_mul_pd(stepSize, s));
+        __m256d climb = _mm256_mul_pd(
+            _mm256_sub_pd(bitsToUnitAvx2(loadBitsAvx2(randomBits + 3 * count + i)), half), climbRange);
+        __m256d altitude = _mm256_add_pd(_mm256_loadu_pd(lanes.altitude + i), climb);
+
+        _mm256_storeu_pd(lanes.latitude + i, _mm256_max_pd(_mm256_min_pd(latitude, maxLat), minLat));
+        _mm256_storeu_pd(lanes.longitude + i, _mm256_max_pd(_mm256_min_pd(longitude, maxLon), minLon));
+        _mm256_storeu_pd(lanes.altitude + i, _mm256_max_pd(_mm256_min_pd(altitude, maxAlt), minAlt));
+        _mm256_storeu_pd(lanes.heading + i, _mm256_mul_pd(direction, radToDeg));
+        _mm256_storeu_pd(lanes.speed + i, _mm256_mul_pd(stepSize, speedScale));
+    }
+    randomWalkScalar(params, lanes, randomBits, count, i);
+}
+
+bool cpuSupportsAvx2() {
+#if defined(__GNUC__)
+    return __builtin_cpu_supports("avx2");
+#else
+    int info[4];
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) && ((_xgetbv(0) & 0x6) == 0x6);
+    if (!osSavesYmm) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#endif
+}
+
+#endif // MOVEMENT_KERNELS_X86
+
+} // namespace
+
+InstructionSet detectedInstructionSet() {
+#ifdef MOVEMENT_KERNELS_X86
+    static const InstructionSet detected = cpuSupportsAvx2() ? AVX2 : SSE2;
+    return detected;
+#else
+    return SCALAR;
+#endif
+}
+
+InstructionSet activeInstructionSet() {
+    int set = activeSet.load(std::memory_order_relaxed);
+    if (set < 0) {
+        set = detectedInstructionSet();
+        activeSet.store(set, std::memory_order_relaxed);
+    }
+    return static_cast<InstructionSet>(set);
+}
+
+void setInstructionSet(InstructionSet set) {
+    activeSet.store(std::min(set, detectedInstructionSet()), std::memory_order_relaxed);
+}
+
+const char* instructionSetName(InstructionSet set) {
+    switch (set) {
+        case SCALAR: return "scalar";
+        case SSE2: return "SSE2";
+        case AVX2: return "AVX2";
+        default: return "unknown";
+    }
+}
+
+void sinCos(const double* angle, double* sinOut, double* cosOut, std::size_t count) {
+    switch (activeInstructionSet()) {
+#ifdef MOVEMENT_KERNELS_X86
+        case AVX2:
+            sinCosAvx2Loop(angle, sinOut, cosOut, count);
+            return;
+        case SSE2:
+            sinCosSse2Loop(angle, sinOut, cosOut, count);
+            return;
+#endif
+        default:
+            for (std::size_t i = 0; i < count; ++i) {
+                sinCosScalar(angle[i], sinOut[i], cosOut[i]);
+            }
+            return;
+    }
+}
+
+void hover(const HoverParams& params, const HoverLanes& lanes,
+           const std::uint64_t* randomBits, std::size_t count) {
+    switch (activeInstructionSet()) {
+#ifdef MOVEMENT_KERNELS_X86
+        case AVX2:
+            hoverAvx2(params, lanes, randomBits, count);
+            return;
+        case SSE2:
+            hoverSse2(params, lanes, randomBits, count);
+            return;
+#endif
+        default:
+            hoverScalar(params, lanes, randomBits, count, 0);
+            return;
+    }
+}
+
+void randomWalk(const RandomWalkParams& params, const RandomWalkLanes& lanes,
+                const std::uint64_t* randomBits, std::size_t count) {
+    switch (activeInstructionSet()) {
+#ifdef MOVEMENT_KERNELS_X86
+        case AVX2:
+            randomWalkAvx2(params, lanes, randomBits, count);
+            return;
+        case SSE2:
+            randomWalkSse2(params, lanes, randomBits, count);
+            return;
+#endif
+        default:
+            randomWalkScalar(params, lanes, randomBits, count, 0);
+            return;
+    }
+}
+
+} // namespace MovementKernels
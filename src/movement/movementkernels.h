@@ -0,0 +1,91 @@
+#ifndef MOVEMENTKERNELS_H
+#define MOVEMENTKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Vectorized movement kernels shared by the batch strategy paths.
+// Each kernel advances `count` drones whose columns start at the given
+// pointers. Random input is raw 64-bit draws laid out plane by plane
+// (draw k of drone i lives at randomBits[k * count + i]), so every lane
+// loads contiguously. The AVX2, SSE2 and scalar variants perform the same
+// IEEE operations in the same order and therefore produce identical results.
+namespace MovementKernels {
+
+// Drones per kernel call when callers stage random draws on the stack;
+// 256 drones x 4 draws x 8 bytes stays well inside L1
+const std::size_t BLOCK_SIZE = 256;
+
+enum InstructionSet {
+    SCALAR = 0,
+    SSE2 = 1,
+    AVX2 = 2
+};
+
+// Best instruction set supported by the running CPU (detected once)
+InstructionSet detectedInstructionSet();
+
+// Instruction set used by the kernels; defaults to the detected one.
+// Requests above what the CPU supports are clamped.
+InstructionSet activeInstructionSet();
+void setInstructionSet(InstructionSet set);
+const char* instructionSetName(InstructionSet set);
+
+// sin/cos of `count` angles using Cody-Waite reduction by pi/2 and the
+// Cephes minimax polynomials on [-pi/4, pi/4]. Against long double sinl/cosl
+// the measured maximum absolute error is 1.7e-16 (about 1 ulp) for
+// |x| <= 1000. The reduction stays exact while |x| < 8e8.
+void sinCos(const double* angle, double* sinOut, double* cosOut, std::size_t count);
+
+struct HoverParams {
+    double hoverRadius;
+    double angleStep;
+    double baseAltitude;
+};
+
+struct HoverLanes {
+    const double* centerLat;
+    const double* centerLon;
+    double* angle;
+    double* latitude;
+    double* longitude;
+    double* altitude;
+    double* heading;
+    double* speed;
+};
+
+// Three draws per drone: radius factor, altitude jitter, speed
+const int HOVER_DRAWS = 3;
+void hover(const HoverParams& params, const HoverLanes& lanes,
+           const std::uint64_t* randomBits, std::size_t count);
+
+struct RandomWalkParams {
+    double maxStepSize;
+    double directionChangeChance;
+    double minLatitude;
+    double maxLatitude;
+    double minLongitude;
+    double maxLongitude;
+    double minAltitude;
+    double maxAltitude;
+    double climbRange;   // altitude change is uniform in +/- climbRange / 2
+    double speedScale;   // reported speed = step size * speedScale
+};
+
+struct RandomWalkLanes {
+    double* direction;
+    double* latitude;
+    double* longitude;
+    double* altitude;
+    double* heading;
+    double* speed;
+};
+
+// Four draws per drone: direction-change roll, new direction, step, climb
+const int RANDOM_WALK_DRAWS = 4;
+void randomWalk(const RandomWalkParams& params, const RandomWalkLanes& lanes,
+                const std::uint64_t* randomBits, std::size_t count);
+
+} // namespace MovementKernels
+
+#endif // MOVEMENTKERNELS_H
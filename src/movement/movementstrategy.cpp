@@ -1,3 +1,31 @@
 #include "movementstrategy.h"
-// Implementation file for MovementStrategy interface
-// No implementation needed for pure virtual class
\ No newline at end of file
+#include "dronedata.h"
+#include "fleetstate.h"
+
+bool MovementStrategy::supportsParallelUpdates() const {
+    return false;
+}
+
+void MovementStrategy::prepare(const FleetState& fleet, const TickContext& context) {
+    Q_UNUSED(fleet);
+    Q_UNUSED(context);
+}
+
+void MovementStrategy::updatePositions(FleetState& fleet, std::size_t begin, std::size_t end,
+                                       const TickContext& context) {
+    Q_UNUSED(context);
+    for (std::size_t i = begin; i < end; ++i) {
+        DroneData drone = fleet.view(i);
+        updatePosition(drone);
+        fleet.store(i, drone);
+    }
+}
+
+void MovementStrategy::saveState(CheckpointWriter& writer) const {
+    Q_UNUSED(writer);
+}
+
+bool MovementStrategy::restoreState(CheckpointReader& reader) {
+    Q_UNUSED(reader);
+    return true;
+}
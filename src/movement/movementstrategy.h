@@ -2,15 +2,60 @@
 #define MOVEMENTSTRATEGY_H
 
 #include <QString>
+#include <QtGlobal>
+#include <cstddef>
 
+class CheckpointReader;
+class CheckpointWriter;
 class DroneData;
+class FleetState;
+class Geofence;
+
+// Per-tick inputs shared by every strategy call within one tick.
+// Random draws are keyed by (seed, drone, tick), so a run replays exactly.
+// dt is the simulated time covered by the tick, in seconds. Strategies keep
+// drones out of geofence breaches; without a geofence they use the built-in
+// operating area (Geofence::operatingArea()).
+struct TickContext {
+    quint64 tick;
+    quint64 seed;
+    double dt;
+    const Geofence* geofence = nullptr;
+};
 
 // Strategy Pattern Implementation
 class MovementStrategy {
 public:
     virtual ~MovementStrategy() = default;
+
+    // Per-update constants in the strategies were tuned for the original
+    // 2 Hz tick; batch updates scale them by dt / REFERENCE_STEP_SECONDS
+    static constexpr double REFERENCE_STEP_SECONDS = 0.5;
+
     virtual void updatePosition(DroneData& drone) = 0;
     virtual QString getStrategyName() const = 0;
+
+    // True when updatePositions() on disjoint ranges may run on several
+    // threads at once. The per-drone fallback below is not, so the default
+    // is false and such strategies are advanced serially.
+    virtual bool supportsParallelUpdates() const;
+
+    // Called once per tick, on one thread, before any updatePositions() call.
+    // Strategies size their per-drone state here so that updatePositions()
+    // on disjoint ranges can then run concurrently.
+    virtual void prepare(const FleetState& fleet, const TickContext& context);
+
+    // Batch entry point: advances drones [begin, end) of the fleet in one call.
+    // The default falls back to updatePosition() through per-drone views;
+    // concrete strategies override it to work on the columns directly.
+    virtual void updatePositions(FleetState& fleet, std::size_t begin, std::size_t end,
+                                 const TickContext& context);
+
+    // Checkpoint support: everything that affects future ticks, including
+    // per-drone arrays and RNG counters. restoreState() reads exactly what
+    // saveState() wrote; the default strategy is stateless.
+    virtual void saveState(CheckpointWriter& writer) const;
+    virtual bool restoreState(CheckpointReader& reader);
 };
 
 #endif // MOVEMENTSTRATEGY_H
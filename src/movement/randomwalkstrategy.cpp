@@ -1,25 +1,32 @@
 #include "randomwalkstrategy.h"
 #include "dronedata.h"
+#include "fleetstate.h"
+#include "geofence.h"
+#include "movementkernels.h"
+#include "simulationcheckpoint.h"
 #include <QtMath>
 #include <QRandomGenerator>
+#include <algorithm>
 
 RandomWalkStrategy::RandomWalkStrategy()
     : maxStepSize(0.0005)  // Maximum step size in degrees
     , directionChangeChance(0.1)  // 10% chance to change direction each update
     , currentDirection(0.0)
+    , random(QRandomGenerator::global()->generate64())
+    , updateCalls(0)
 {
     // Initialize with random direction
-    currentDirection = QRandomGenerator::global()->generateDouble() * 2 * M_PI;
+    currentDirection = PhiloxRng(random.seed(), PhiloxRng::INITIALIZATION).uniform(0, 0, 0) * 2 * M_PI;
 }
 
 void RandomWalkStrategy::updatePosition(DroneData& drone) {
     // Randomly change direction occasionally
-    if (QRandomGenerator::global()->generateDouble() < directionChangeChance) {
-        currentDirection = QRandomGenerator::global()->generateDouble() * 2 * M_PI;
+    if (random.uniform(0, updateCalls, 0) < directionChangeChance) {
+        currentDirection = random.uniform(0, updateCalls, 1) * 2 * M_PI;
     }
 
     // Calculate step size (random between 0 and maxStepSize)
-    double stepSize = QRandomGenerator::global()->generateDouble() * maxStepSize;
+    double stepSize = random.uniform(0, updateCalls, 2) * maxStepSize;
 
     // Calculate new position
     double latStep = stepSize * qCos(currentDirection);
@@ -28,23 +35,148 @@ void RandomWalkStrategy::updatePosition(DroneData& drone) {
     double newLat = drone.getLatitude() + latStep;
     double newLon = drone.getLongitude() + lonStep;
 
-    // Keep within reasonable bounds
-    newLat = qBound(28.4, newLat, 29.0);
-    newLon = qBound(77.0, newLon, 78.0);
+    // Keep within the built-in operating area
+    const GeofenceBounds bounds = Geofence::operatingArea().getPermittedBounds();
+    newLat = qBound(bounds.minLatitude, newLat, bounds.maxLatitude);
+    newLon = qBound(bounds.minLongitude, newLon, bounds.maxLongitude);
 
     drone.setLatitude(newLat);
     drone.setLongitude(newLon);
 
     // Random altitude changes (-5.0 to +5.0)
-    double altitudeChange = (QRandomGenerator::global()->generateDouble() - 0.5) * 10.0;
+    double altitudeChange = (random.uniform(0, updateCalls, 3) - 0.5) * 10.0;
     double newAltitude = qBound(50.0, drone.getAltitude() + altitudeChange, 200.0);
     drone.setAltitude(newAltitude);
 
     // Update heading and speed
     drone.setHeading(qRadiansToDegrees(currentDirection));
     drone.setSpeed(stepSize * 10000);
+    ++updateCalls;
+}
+
+bool RandomWalkStrategy::supportsParallelUpdates() const {
+    return true;
+}
+
+void RandomWalkStrategy::prepare(const FleetState& fleet, const TickContext& context) {
+    ensureDroneState(fleet, fleet.size(), context);
+}
+
+void RandomWalkStrategy::updatePositions(FleetState& fleet, std::size_t begin, std::size_t end,
+                                         const TickContext& context) {
+    if (begin >= end) {
+        return;
+    }
+    ensureDroneState(fleet, end, context);
+
+    // Same per-second rates as updatePosition() at 2 Hz. Steps and climbs
+    // scale with dt; the direction-change chance compounds over dt so the
+    // expected number of turns per second does not depend on the tick rate.
+    // The kernel clamps to the geofence's permitted box; anything finer is
+    // checked after it.
+    const Geofence& geofence = context.geofence ? *context.geofence : Geofence::operatingArea();
+    const GeofenceBounds bounds = geofence.getPermittedBounds();
+    const double stepScale = context.dt / REFERENCE_STEP_SECONDS;
+    const MovementKernels::RandomWalkParams params{
+        maxStepSize * stepScale,
+        1.0 - qPow(1.0 - directionChangeChance, stepScale),
+        bounds.minLatitude, bounds.maxLatitude,
+        bounds.minLongitude, bounds.maxLongitude,
+        50.0, 200.0,
+        10.0 * stepScale,
+        stepScale > 0.0 ? 10000.0 / stepScale : 0.0
+    };
+    const PhiloxRng rangeRandom(context.seed, PhiloxRng::MOVEMENT);
+    quint64 randomBits[MovementKernels::BLOCK_SIZE * MovementKernels::RANDOM_WALK_DRAWS];
+    double previousLatitude[MovementKernels::BLOCK_SIZE];
+    double previousLongitude[MovementKernels::BLOCK_SIZE];
+    quint8 status[MovementKernels::BLOCK_SIZE];
+
+    for (std::size_t block = begin; block < end; block += MovementKernels::BLOCK_SIZE) {
+        // Draw the block's random numbers up front so the kernel stays branch-free.
+        // The drone index is the stream, so a drone sees the same draws whatever chunk it is in.
+        const std::size_t count = qMin(MovementKernels::BLOCK_SIZE, end - block);
+        rangeRandom.fillBitPlanes(block, context.tick, count, MovementKernels::RANDOM_WALK_DRAWS, randomBits);
+
+        double* latitudes = fleet.latitudes() + block;
+        double* longitudes = fleet.longitudes() + block;
+        if (!geofence.isBox()) {
+            std::copy(latitudes, latitudes + count, previousLatitude);
+            std::copy(longitudes, longitudes + count, previousLongitude);
+        }
+
+        MovementKernels::RandomWalkLanes lanes{
+            droneDirection.data() + block,
+            latitudes,
+            longitudes,
+            fleet.altitudes() + block,
+            fleet.headings() + block,
+            fleet.speeds() + block
+        };
+        MovementKernels::randomWalk(params, lanes, randomBits, count);
+
+        if (!geofence.isBox()) {
+            keepOutOfBreach(geofence, fleet, block, count, previousLatitude, previousLongitude, status);
+        }
+    }
+}
+
+void RandomWalkStrategy::keepOutOfBreach(const Geofence& geofence, FleetState& fleet, std::size_t block,
+                                         std::size_t count, const double* previousLatitude,
+                                         const double* previousLongitude, quint8* status) {
+    // A step that would breach the geofence is not taken: the drone holds
+    // its position and turns back. Drones already in breach move freely so
+    // they can find their way out.
+    geofence.classify(fleet.latitudes() + block, fleet.longitudes() + block, count, status);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (status[i] == Geofence::CLEAR
+            || geofence.classify(previousLatitude[i], previousLongitude[i]) != Geofence::CLEAR) {
+            continue;
+        }
+        const std::size_t index = block + i;
+        fleet.latitudes()[index] = previousLatitude[i];
+        fleet.longitudes()[index] = previousLongitude[i];
+        double& direction = droneDirection[index];
+        direction = direction < M_PI ? direction + M_PI : direction - M_PI;
+        fleet.headings()[index] = qRadiansToDegrees(direction);
+        fleet.speeds()[index] = 0.0;
+    }
+}
+
+void RandomWalkStrategy::ensureDroneState(const FleetState& fleet, std::size_t end,
+                                    const TickContext& context) {
+    // Drop state for drones that have left the fleet
+    if (droneDirection.size() > fleet.size()) {
+        droneDirection.resize(fleet.size());
+    }
+
+    // New drones start with their own random direction
+    PhiloxRng initial(context.seed, PhiloxRng::INITIALIZATION);
+    while (droneDirection.size() < end) {
+        droneDirection.push_back(initial.uniform(droneDirection.size(), 0, 0) * 2 * M_PI);
+    }
 }
 
 QString RandomWalkStrategy::getStrategyName() const {
     return "Random Walk";
 }
+
+void RandomWalkStrategy::saveState(CheckpointWriter& writer) const {
+    writer.write(maxStepSize);
+    writer.write(directionChangeChance);
+    writer.write(currentDirection);
+    writer.write(random.seed());
+    writer.write(updateCalls);
+    writer.writeArray(droneDirection);
+}
+
+bool RandomWalkStrategy::restoreState(CheckpointReader& reader) {
+    quint64 seed = 0;
+    if (!reader.read(maxStepSize) || !reader.read(directionChangeChance)
+        || !reader.read(currentDirection) || !reader.read(seed) || !reader.read(updateCalls)
+        || !reader.readArray(droneDirection)) {
+        return false;
+    }
+    random.setSeed(seed);
+    return true;
+}
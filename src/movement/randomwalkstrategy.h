@@ -2,18 +2,40 @@
 #define RANDOMWALKSTRATEGY_H
 
 #include "movementstrategy.h"
+#include "philoxrng.h"
 #include <QString>
+#include <QtGlobal>
+#include <vector>
+
+class Geofence;
 
 class RandomWalkStrategy : public MovementStrategy {
 public:
     RandomWalkStrategy();
     void updatePosition(DroneData& drone) override;
+    bool supportsParallelUpdates() const override;
+    void prepare(const FleetState& fleet, const TickContext& context) override;
+    void updatePositions(FleetState& fleet, std::size_t begin, std::size_t end,
+                         const TickContext& context) override;
     QString getStrategyName() const override;
+    void saveState(CheckpointWriter& writer) const override;
+    bool restoreState(CheckpointReader& reader) override;
 
 private:
+    void ensureDroneState(const FleetState& fleet, std::size_t end, const TickContext& context);
+    void keepOutOfBreach(const Geofence& geofence, FleetState& fleet, std::size_t block, std::size_t count,
+                         const double* previousLatitude, const double* previousLongitude, quint8* status);
+
     double maxStepSize;
     double directionChangeChance;
     double currentDirection;
+
+    // Single-drone path draws from its own stream, one tick per call
+    PhiloxRng random;
+    quint64 updateCalls;
+
+    // Per-drone heading for the batch path, indexed by fleet position
+    std::vector<double> droneDirection;
 };
 
 #endif // RANDOMWALKSTRATEGY_H
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "telemetrypacket.h"
+#include "fleetstate.h"
+#include "telemetryformat.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace TelemetryPacket {
+
+namespace {
+
+template <typename T>
+void put(char*& out, T value) {
+    std::memcpy(out, &value, sizeof(T));
+    out += sizeof(T);
+}
+
+template <typename T>
+T take(const char*& in) {
+    T value;
+    std::memcpy(&value, in, sizeof(T));
+    in += sizeof(T);
+    return value;
+}
+
+quint16 clampToUnsigned16(double value) {
+    return static_cast<quint16>(qBound(0.0, std::round(value), 65535.0));
+}
+
+bool fitsInt16(qint64 value) {
+    return value >= std::numeric_limits<qint16>::min() && value <= std::numeric_limits<qint16>::max();
+}
+
+} // namespace
+
+StateRecord quantize(const FleetState& fleet, std::size_t index) {
+    double heading = std::fmod(fleet.headings()[index], 360.0);
+    if (heading < 0.0) {
+        heading += 360.0;
+    }
+
+    StateRecord record;
+    record.latitudeE7 = static_cast<qint32>(std::llround(fleet.latitudes()[index] * 1e7));
+    record.longitudeE7 = static_cast<qint32>(std::llround(fleet.longitudes()[index] * 1e7));
+    record.altitudeCm = static_cast<qint32>(qBound(-2.0e9, std::round(fleet.altitudes()[index] * 100.0), 2.0e9));
+    record.headingCdeg = static_cast<quint16>(qMin(35999.0, std::round(heading * 100.0)));
+    record.speedCms = clampToUnsigned16(fleet.speeds()[index] * 100.0);
+    record.batteryCentipercent = static_cast<quint16>(qBound(0.0, std::round(fleet.batteries()[index] * 100.0), 10000.0));
+    record.gpsStatus = static_cast<quint8>(fleet.gpsStatuses()[index]);
+    return record;
+}
+
+void dequantize(const StateRecord& record, DroneData& data) {
+    data.setLatitude(record.latitudeE7 / 1e7);
+    data.setLongitude(record.longitudeE7 / 1e7);
+    data.setAltitude(record.altitudeCm / 100.0);
+    data.setHeading(record.headingCdeg / 100.0);
+    data.setSpeed(record.speedCms / 100.0);
+    data.setBattery(record.batteryCentipercent / 100.0);
+    data.setGPSStatus(static_cast<GPSFixStatus>(record.gpsStatus));
+}
+
+void dequantize(const StateRecord& record, FleetState& fleet, std::size_t index) {
+    fleet.latitudes()[index] = record.latitudeE7 / 1e7;
+    fleet.longitudes()[index] = record.longitudeE7 / 1e7;
+    fleet.altitudes()[index] = record.altitudeCm / 100.0;
+    fleet.headings()[index] = record.headingCdeg / 100.0;
+    fleet.speeds()[index] = record.speedCms / 100.0;
+    fleet.batteries()[index] = record.batteryCentipercent / 100.0;
+    fleet.gpsStatuses()[index] = static_cast<GPSFixStatus>(record.gpsStatus);
+}
+
+void writeFull(char* out, const StateRecord& record) {
+    put(out, record.latitudeE7);
+    put(out, record.longitudeE7);
+    put(out, record.altitudeCm);
+    put(out, record.headingCdeg);
+    put(out, record.speedCms);
+    put(out, record.batteryCentipercent);
+    put(out, record.gpsStatus);
+}
+
+StateRecord readFull(const char* in) {
+    StateRecord record;
+    record.latitudeE7 = take<qint32>(in);
+    record.longitudeE7 = take<qint32>(in);
+    record.altitudeCm = take<qint32>(in);
+    record.headingCdeg = take<quint16>(in);
+    record.speedCms = take<quint16>(in);
+    record.batteryCentipercent = take<quint16>(in);
+    record.gpsStatus = take<quint8>(in);
+    return record;
+}
+
+bool fitsDelta(const StateRecord& base, const StateRecord& record) {
+    return fitsInt16(qint64(record.latitudeE7) - base.latitudeE7)
+        && fitsInt16(qint64(record.longitudeE7) - base.longitudeE7)
+        && fitsInt16(qint64(record.altitudeCm) - base.altitudeCm);
+}
+
+void writeDelta(char* out, const StateRecord& base, const StateRecord& record) {
+    put(out, static_cast<qint16>(record.latitudeE7 - base.latitudeE7));
+    put(out, static_cast<qint16>(record.longitudeE7 - base.longitudeE7));
+    put(out, static_cast<qint16>(record.altitudeCm - base.altitudeCm));
+    put(out, record.headingCdeg);
+    put(out, record.speedCms);
+    put(out, record.batteryCentipercent);
+    put(out, record.gpsStatus);
+}
+
+StateRecord readDelta(const char* in, const StateRecord& base) {
+    StateRecord record;
+    record.latitudeE7 = base.latitudeE7 + take<qint16>(in);
+    record.longitudeE7 = base.longitudeE7 + take<qint16>(in);
+    record.altitudeCm = base.altitudeCm + take<qint16>(in);
+    record.headingCdeg = take<quint16>(in);
+    record.speedCms = take<quint16>(in);
+    record.batteryCentipercent = take<quint16>(in);
+    record.gpsStatus = take<quint8>(in);
+    return record;
+}
+
+std::size_t finishDatagram(char* datagram, const PacketHeader& header) {
+    std::memcpy(datagram, &header, sizeof(header));
+    const std::size_t bodyBytes = sizeof(header) + header.payloadBytes;
+    const quint32 crc = TelemetryFormat::crc32(datagram, bodyBytes);
+    std::memcpy(datagram + bodyBytes, &crc, sizeof(crc));
+    return bodyBytes + CRC_BYTES;
+}
+
+bool parseDatagram(const char* datagram, std::size_t size, PacketHeader* header) {
+    if (size < sizeof(PacketHeader) + CRC_BYTES) {
+        return false;
+    }
+    PacketHeader parsed;
+    std::memcpy(&parsed, datagram, sizeof(parsed));
+    if (parsed.magic != MAGIC || parsed.version != PROTOCOL_VERSION) {
+        return false;
+    }
+    const std::size_t bodyBytes = sizeof(parsed) + parsed.payloadBytes;
+    if (bodyBytes + CRC_BYTES != size) {
+        return false;
+    }
+    quint32 crc;
+    std::memcpy(&crc, datagram + bodyBytes, sizeof(crc));
+    if (crc != TelemetryFormat::crc32(datagram, bodyBytes)) {
+        return false;
+    }
+    if (header) {
+        *header = parsed;
+    }
+    return true;
+}
+
+} // namespace TelemetryPacket
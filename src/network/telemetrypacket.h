@@ -0,0 +1,109 @@
+#ifndef TELEMETRYPACKET_H
+#define TELEMETRYPACKET_H
+
+#include <QtGlobal>
+#include <cstddef>
+#include "dronedata.h"
+
+class FleetState;
+
+// Wire format of the UDP telemetry stream. Like the recording format, all
+// integers are in host byte order (little-endian on every supported target).
+// Every datagram fits one Ethernet MTU and is self-describing:
+//
+//   PacketHeader
+//   payload       recordCount records for fleet indices firstIndex, firstIndex + 1, ...
+//   quint32 crc   CRC-32 of header and payload
+//
+// FULL_STATE record (quantized, see StateRecord):
+//   qint32 latitudeE7, longitudeE7, altitudeCm
+//   quint16 headingCdeg, speedCms, batteryCentipercent
+//   quint8 gpsStatus
+// DELTA_STATE record, relative to the FULL_STATE record of the same drone
+// sent on keyframe tick baseTick:
+//   qint16 latitudeE7, longitudeE7, altitudeCm differences
+//   quint16 headingCdeg, speedCms, batteryCentipercent
+//   quint8 gpsStatus
+// NAME_TABLE record:
+//   quint32 droneId; quint8 utf8Length; char utf8[utf8Length]
+//
+// Deltas refer to a keyframe rather than the previous tick, so a lost
+// datagram only costs the drones it carried until the next keyframe.
+namespace TelemetryPacket {
+
+const quint8 MAGIC = 0xD5;
+const quint8 PROTOCOL_VERSION = 1;
+
+enum MessageType : quint8 {
+    FULL_STATE = 1,
+    DELTA_STATE = 2,
+    NAME_TABLE = 3
+};
+
+enum Flags : quint8 {
+    KEYFRAME = 0x01          // FULL_STATE sent on a keyframe tick; deltas may refer to it
+};
+
+struct PacketHeader {
+    quint8 magic;
+    quint8 version;
+    quint8 type;
+    quint8 flags;            // Flags
+    quint16 payloadBytes;
+    quint16 recordCount;
+    quint32 sequence;        // per stream, one per datagram
+    quint32 layoutVersion;   // low bits of FleetState::getLayoutVersion()
+    quint32 firstIndex;
+    quint32 fleetSize;
+    quint64 tick;
+    double simulationTime;
+    quint64 baseTick;        // DELTA_STATE: keyframe tick; otherwise tick
+};
+
+static_assert(sizeof(PacketHeader) == 48, "PacketHeader layout is part of the wire format");
+
+// Ethernet MTU minus the IPv4 and UDP headers
+const std::size_t MAX_DATAGRAM_BYTES = 1472;
+const std::size_t CRC_BYTES = sizeof(quint32);
+const std::size_t MAX_PAYLOAD_BYTES = MAX_DATAGRAM_BYTES - sizeof(PacketHeader) - CRC_BYTES;
+
+const std::size_t FULL_RECORD_BYTES = 19;
+const std::size_t DELTA_RECORD_BYTES = 13;
+const std::size_t MAX_FULL_RECORDS = MAX_PAYLOAD_BYTES / FULL_RECORD_BYTES;
+const std::size_t MAX_DELTA_RECORDS = MAX_PAYLOAD_BYTES / DELTA_RECORD_BYTES;
+
+// One drone's telemetry in wire units
+struct StateRecord {
+    qint32 latitudeE7;
+    qint32 longitudeE7;
+    qint32 altitudeCm;
+    quint16 headingCdeg;
+    quint16 speedCms;
+    quint16 batteryCentipercent;
+    quint8 gpsStatus;
+};
+
+StateRecord quantize(const FleetState& fleet, std::size_t index);
+// Fills a DroneData (without its ID) from wire units
+void dequantize(const StateRecord& record, DroneData& data);
+// Same, straight into one drone's columns
+void dequantize(const StateRecord& record, FleetState& fleet, std::size_t index);
+
+void writeFull(char* out, const StateRecord& record);
+StateRecord readFull(const char* in);
+
+// False when a difference does not fit the 16-bit delta fields
+bool fitsDelta(const StateRecord& base, const StateRecord& record);
+void writeDelta(char* out, const StateRecord& base, const StateRecord& record);
+StateRecord readDelta(const char* in, const StateRecord& base);
+
+// Writes the header in front of the payload already at datagram +
+// sizeof(PacketHeader) and appends the CRC; returns the datagram size
+std::size_t finishDatagram(char* datagram, const PacketHeader& header);
+
+// Checks magic, version, sizes and CRC; false for anything malformed
+bool parseDatagram(const char* datagram, std::size_t size, PacketHeader* header);
+
+} // namespace TelemetryPacket
+
+#endif // TELEMETRYPACKET_H
@@ -0,0 +1,387 @@
+#include "telemetryreceiver.h"
+#include "dronesimulator.h"
+#include "droneidregistry.h"
+#include "logger.h"
+#include <QHostAddress>
+#include <QUdpSocket>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#ifdef Q_OS_LINUX
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+
+using namespace TelemetryPacket;
+
+namespace {
+// Datagrams drained per recvmmsg() call
+const std::size_t RECEIVE_BATCH = 256;
+// Larger than any valid datagram, so oversized ones show up as such
+const std::size_t SLOT_BYTES = 2048;
+// How often the receive thread checks for close()
+const int POLL_INTERVAL_MS = 100;
+// Absorbs bursts of whole ticks while the receive thread is busy decoding
+const int RECEIVE_BUFFER_BYTES = 16 << 20;
+
+// Jumping back further than this in ticks or datagrams means the sender
+// restarted; reordering and late datagrams stay well within it
+const quint64 RESTART_TICK_GAP = 16;
+const quint32 RESTART_SEQUENCE_GAP = 4096;
+
+const quint64 NO_TICK = std::numeric_limits<quint64>::max();
+}
+
+TelemetryReceiver::TelemetryReceiver(DroneSimulator* simulator, QObject *parent)
+    : QObject(parent)
+    , simulator(simulator)
+    , stopping(false)
+    , publishPending(false)
+    , port(0)
+    , haveLayout(false)
+    , idsChanged(false)
+    , cacheChanged(false)
+    , layoutVersion(0)
+    , currentTick(0)
+    , currentTime(0.0)
+    , recordsThisTick(0)
+    , expectedSequence(0)
+    , haveSequence(false)
+    , receivedDatagrams(0)
+    , rejectedDatagrams(0)
+    , lostDatagrams(0)
+    , staleRecords(0)
+    , publishedTicks(0)
+{
+}
+
+TelemetryReceiver::~TelemetryReceiver() {
+    close();
+}
+
+bool TelemetryReceiver::open(quint16 requestedPort) {
+    close();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        haveLayout = false;
+        cacheChanged = false;
+        haveSequence = false;
+        cache.clear();
+    }
+    receivedDatagrams = 0;
+    rejectedDatagrams = 0;
+    lostDatagrams = 0;
+    staleRecords = 0;
+    publishedTicks = 0;
+    stopping = false;
+
+    // The socket lives on the receive thread; it reports the bound port back
+    std::promise<quint16> bound;
+    std::future<quint16> boundPort = bound.get_future();
+    worker = std::thread(&TelemetryReceiver::receiveLoop, this, std::move(bound), requestedPort);
+    port = boundPort.get();
+    if (port == 0) {
+        worker.join();
+        return false;
+    }
+
+    // Live telemetry replaces the local simulation while it is received
+    simulator->stopSimulation();
+    LOG_INFO(QString("Listening for UDP telemetry on port %1").arg(port));
+    return true;
+}
+
+void TelemetryReceiver::close() {
+    if (!worker.joinable()) {
+        return;
+    }
+    stopping = true;
+    worker.join();
+
+    LOG_INFO(QString("Telemetry listener closed: %1 datagrams, %2 lost, %3 rejected, %4 ticks published")
+             .arg(receivedDatagrams.load())
+             .arg(lostDatagrams.load())
+             .arg(rejectedDatagrams.load())
+             .arg(publishedTicks.load()));
+}
+
+bool TelemetryReceiver::isOpen() const {
+    return worker.joinable();
+}
+
+quint16 TelemetryReceiver::getPort() const {
+    return port;
+}
+
+bool TelemetryReceiver::publish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        publishPending = false;
+        if (!cacheChanged) {
+            return false;
+        }
+        if (idsChanged) {
+            rebuildIds();
+        }
+        cache.setClock(currentTick, currentTime);
+        frame.assignFrom(cache);
+        cacheChanged = false;
+    }
+
+    simulator->publishFleet(frame);
+    ++publishedTicks;
+    return true;
+}
+
+quint64 TelemetryReceiver::getReceivedDatagrams() const {
+    return receivedDatagrams.load();
+}
+
+quint64 TelemetryReceiver::getRejectedDatagrams() const {
+    return rejectedDatagrams.load();
+}
+
+quint64 TelemetryReceiver::getLostDatagrams() const {
+    return lostDatagrams.load();
+}
+
+quint64 TelemetryReceiver::getStaleRecords() const {
+    return staleRecords.load();
+}
+
+quint64 TelemetryReceiver::getPublishedTicks() const {
+    return publishedTicks.load();
+}
+
+void TelemetryReceiver::receiveLoop(std::promise<quint16> bound, quint16 requestedPort) {
+    QUdpSocket socket;
+    if (!socket.bind(QHostAddress(QHostAddress::AnyIPv4), requestedPort)) {
+        LOG_ERROR(QString("Cannot listen for UDP telemetry on port %1: %2")
+                  .arg(requestedPort).arg(socket.errorString()));
+        bound.set_value(0);
+        return;
+    }
+    socket.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, RECEIVE_BUFFER_BYTES);
+    bound.set_value(socket.localPort());
+
+    std::vector<char> buffers(RECEIVE_BATCH * SLOT_BYTES);
+    std::vector<std::size_t> sizes(RECEIVE_BATCH);
+
+#ifdef Q_OS_LINUX
+    const int descriptor = static_cast<int>(socket.socketDescriptor());
+    std::vector<mmsghdr> messages(RECEIVE_BATCH);
+    std::vector<iovec> vectors(RECEIVE_BATCH);
+    for (std::size_t i = 0; i < RECEIVE_BATCH; ++i) {
+        vectors[i].iov_base = buffers.data() + i * SLOT_BYTES;
+        vectors[i].iov_len = SLOT_BYTES;
+        std::memset(&messages[i], 0, sizeof(messages[i]));
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    while (!stopping) {
+        pollfd readable = {descriptor, POLLIN, 0};
+        if (::poll(&readable, 1, POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        const int received = ::recvmmsg(descriptor, messages.data(), RECEIVE_BATCH, MSG_DONTWAIT, nullptr);
+        if (received <= 0) {
+            continue;
+        }
+        for (int i = 0; i < received; ++i) {
+            // Truncated datagrams fail the size check in parseDatagram()
+            sizes[i] = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) ? SLOT_BYTES : messages[i].msg_len;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < received; ++i) {
+            handleDatagram(buffers.data() + i * SLOT_BYTES, sizes[i]);
+        }
+    }
+#else
+    while (!stopping) {
+        if (!socket.waitForReadyRead(POLL_INTERVAL_MS)) {
+            continue;
+        }
+        std::size_t received = 0;
+        while (received < RECEIVE_BATCH && socket.hasPendingDatagrams()) {
+            const qint64 size = socket.readDatagram(buffers.data() + received * SLOT_BYTES, SLOT_BYTES);
+            if (size >= 0) {
+                sizes[received++] = static_cast<std::size_t>(size);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::size_t i = 0; i < received; ++i) {
+            handleDatagram(buffers.data() + i * SLOT_BYTES, sizes[i]);
+        }
+    }
+#endif
+}
+
+void TelemetryReceiver::handleDatagram(const char* data, std::size_t size) {
+    PacketHeader header;
+    if (!parseDatagram(data, size, &header)
+        || header.fleetSize > MAX_FLEET_SIZE
+        || std::size_t(header.firstIndex) + header.recordCount > header.fleetSize) {
+        ++rejectedDatagrams;
+        return;
+    }
+    const char* payload = data + sizeof(PacketHeader);
+    const bool fullState = header.type == FULL_STATE;
+    if ((fullState && header.payloadBytes != header.recordCount * FULL_RECORD_BYTES)
+        || (header.type == DELTA_STATE && header.payloadBytes != header.recordCount * DELTA_RECORD_BYTES)) {
+        ++rejectedDatagrams;
+        return;
+    }
+    ++receivedDatagrams;
+
+    // A restarted sender keeps its layout but starts over from a low tick
+    // and sequence number; its datagrams would otherwise all look late
+    const quint32 gap = header.sequence - expectedSequence;
+    const bool sequenceRestarted = haveSequence && gap >= 0x80000000u
+        && expectedSequence - header.sequence > RESTART_SEQUENCE_GAP;
+    const bool tickRestarted = haveLayout && header.tick + RESTART_TICK_GAP < currentTick;
+    const bool restarted = sequenceRestarted || tickRestarted;
+    if (restarted) {
+        LOG_INFO(QString("Telemetry stream restarted at tick %1").arg(header.tick));
+        haveSequence = false;
+    }
+
+    // Sequence numbers only move forward; anything else arrived late
+    if (!haveSequence || gap < 0x80000000u) {
+        if (haveSequence) {
+            lostDatagrams += gap;
+        }
+        expectedSequence = header.sequence + 1;
+        haveSequence = true;
+    }
+
+    if (restarted || !haveLayout || header.layoutVersion != layoutVersion || header.fleetSize != cache.size()) {
+        resetLayout(header);
+    }
+
+    // The previous tick is as complete as it will get once the next one starts
+    if (header.tick > currentTick) {
+        if (recordsThisTick > 0) {
+            schedulePublish();
+        }
+        currentTick = header.tick;
+        currentTime = header.simulationTime;
+        recordsThisTick = 0;
+    }
+
+    if (header.type == NAME_TABLE) {
+        const char* end = payload + header.payloadBytes;
+        for (std::size_t i = 0; i < header.recordCount; ++i) {
+            if (end - payload < qptrdiff(sizeof(quint32) + 1)) {
+                break;
+            }
+            const int length = static_cast<quint8>(payload[sizeof(quint32)]);
+            const char* name = payload + sizeof(quint32) + 1;
+            if (end - name < length) {
+                break;
+            }
+            // Sender IDs are local to its process; the name is what identifies
+            // the drone. It is interned on publish, and fixed for the layout so
+            // renaming cannot grow the registry.
+            QString& slot = streamNames[header.firstIndex + i];
+            if (slot.isEmpty() && length > 0) {
+                slot = QString::fromUtf8(name, length);
+                idsChanged = true;
+                cacheChanged = true;
+            }
+            payload = name + length;
+        }
+        return;
+    }
+
+    for (std::size_t i = 0; i < header.recordCount; ++i) {
+        const std::size_t index = header.firstIndex + i;
+        if (fullState) {
+            const StateRecord record = readFull(payload + i * FULL_RECORD_BYTES);
+            if (header.flags & KEYFRAME) {
+                keyframes[index] = record;
+                keyframeTicks[index] = header.tick;
+            }
+            storeRecord(index, header.tick, record);
+        } else if (header.type == DELTA_STATE) {
+            if (keyframeTicks[index] != header.baseTick) {
+                ++staleRecords;
+                continue;
+            }
+            storeRecord(index, header.tick, readDelta(payload + i * DELTA_RECORD_BYTES, keyframes[index]));
+        }
+    }
+
+    if (header.tick == currentTick) {
+        recordsThisTick += header.recordCount;
+        if (recordsThisTick >= cache.size()) {
+            recordsThisTick = 0;
+            schedulePublish();
+        }
+    }
+}
+
+void TelemetryReceiver::resetLayout(const PacketHeader& header) {
+    const std::size_t count = header.fleetSize;
+    layoutVersion = header.layoutVersion;
+    haveLayout = true;
+    streamNames.assign(count, QString());
+    recordTicks.assign(count, 0);
+    keyframes.assign(count, StateRecord());
+    keyframeTicks.assign(count, NO_TICK);
+
+    cache.clear();
+    cache.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        cache.addDrone(DroneData());
+    }
+    idsChanged = true;
+    currentTick = 0;
+    recordsThisTick = 0;
+
+    LOG_INFO(QString("Telemetry stream layout changed: %1 drones").arg(count));
+}
+
+void TelemetryReceiver::storeRecord(std::size_t index, quint64 tick, const StateRecord& record) {
+    // A late datagram must not overwrite newer values
+    if (tick < recordTicks[index]) {
+        return;
+    }
+    recordTicks[index] = tick;
+
+    dequantize(record, cache, index);
+    cacheChanged = true;
+}
+
+void TelemetryReceiver::rebuildIds() {
+    // IDs are part of the layout, so newly named drones get a fresh FleetState
+    const std::size_t count = cache.size();
+    std::vector<QString> names(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        names[i] = streamNames[i].isEmpty() ? QString("UDP-%1").arg(i) : streamNames[i];
+    }
+    const std::vector<DroneId> ids = DroneIdRegistry::getInstance().intern(names);
+
+    FleetState rebuilt;
+    rebuilt.addDrones(ids.data(), count);
+    std::copy(cache.latitudes(), cache.latitudes() + count, rebuilt.latitudes());
+    std::copy(cache.longitudes(), cache.longitudes() + count, rebuilt.longitudes());
+    std::copy(cache.altitudes(), cache.altitudes() + count, rebuilt.altitudes());
+    std::copy(cache.headings(), cache.headings() + count, rebuilt.headings());
+    std::copy(cache.speeds(), cache.speeds() + count, rebuilt.speeds());
+    std::copy(cache.batteries(), cache.batteries() + count, rebuilt.batteries());
+    std::copy(cache.gpsStatuses(), cache.gpsStatuses() + count, rebuilt.gpsStatuses());
+    cache = std::move(rebuilt);
+    idsChanged = false;
+}
+
+void TelemetryReceiver::schedulePublish() {
+    // One queued publish at a time; it reads whatever is newest when it runs
+    if (!publishPending.exchange(true)) {
+        QMetaObject::invokeMethod(this, [this]() { publish(); }, Qt::QueuedConnection);
+    }
+}
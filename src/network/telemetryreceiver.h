@@ -0,0 +1,104 @@
+#ifndef TELEMETRYRECEIVER_H
+#define TELEMETRYRECEIVER_H
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "fleetstate.h"
+#include "telemetrypacket.h"
+
+class DroneSimulator;
+
+// Feeds a UDP telemetry stream (see telemetrypacket.h) through a
+// DroneSimulator, the way TelemetryPlayer feeds a recording: every tick is
+// published with DroneSimulator::publishFleet(), so MainWindow, the map and
+// every attached observer monitor the external fleet exactly like a local one.
+//
+// A receive thread drains the socket in batches (recvmmsg() on Linux) and
+// decodes each datagram straight into a per-drone last-value cache. When a
+// tick is complete (all of its drones arrived, or the next tick started) the
+// owner thread is asked to publish; requests collapse while one is pending,
+// so a stream faster than the observers only costs decoding.
+//
+// A datagram that passes the CRC is still untrusted: fleet sizes above
+// MAX_FLEET_SIZE are rejected before anything is sized from them. A sender
+// that restarts with the same layout is recognised by its tick or sequence
+// number jumping back further than reordering explains, and starts a new
+// stream instead of being ignored as late. Drone names are kept per layout
+// and only the first name received for a drone counts, so the process-wide
+// DroneIdRegistry gains at most one name per drone of each layout however
+// often a sender renames them.
+class TelemetryReceiver : public QObject {
+    Q_OBJECT
+
+public:
+    // Largest fleet a stream may announce; larger ones are rejected
+    static constexpr quint32 MAX_FLEET_SIZE = 1u << 22;
+
+    explicit TelemetryReceiver(DroneSimulator* simulator, QObject *parent = nullptr);
+    ~TelemetryReceiver() override;
+
+    // Listens on this UDP port on every IPv4 interface (0 = any free port)
+    bool open(quint16 port);
+    void close();
+    bool isOpen() const;
+    quint16 getPort() const;
+
+    // Publishes the cache if it changed since the last call; the receive
+    // thread schedules this on the owner thread, which needs an event loop
+    bool publish();
+
+    quint64 getReceivedDatagrams() const;
+    quint64 getRejectedDatagrams() const;   // malformed, failed the CRC or over MAX_FLEET_SIZE
+    quint64 getLostDatagrams() const;       // gaps in the sequence numbers
+    quint64 getStaleRecords() const;        // deltas whose keyframe never arrived
+    quint64 getPublishedTicks() const;
+
+private:
+    void receiveLoop(std::promise<quint16> bound, quint16 port);
+    // Called with mutex held
+    void handleDatagram(const char* data, std::size_t size);
+    void resetLayout(const TelemetryPacket::PacketHeader& header);
+    void storeRecord(std::size_t index, quint64 tick, const TelemetryPacket::StateRecord& record);
+    void rebuildIds();
+    void schedulePublish();
+
+    DroneSimulator* simulator;
+    std::thread worker;
+    std::atomic<bool> stopping;
+    std::atomic<bool> publishPending;
+    quint16 port;
+
+    // Last-value cache, shared with the receive thread under mutex
+    std::mutex mutex;
+    FleetState cache;
+    std::vector<QString> streamNames;      // from NAME_TABLE, empty until named
+    std::vector<quint64> recordTicks;      // tick of each drone's cached value
+    std::vector<TelemetryPacket::StateRecord> keyframes;
+    std::vector<quint64> keyframeTicks;
+    bool haveLayout;
+    bool idsChanged;
+    bool cacheChanged;
+    quint32 layoutVersion;
+    quint64 currentTick;
+    double currentTime;
+    std::size_t recordsThisTick;
+    quint32 expectedSequence;
+    bool haveSequence;
+
+    // Owner thread only
+    FleetState frame;
+
+    std::atomic<quint64> receivedDatagrams;
+    std::atomic<quint64> rejectedDatagrams;
+    std::atomic<quint64> lostDatagrams;
+    std::atomic<quint64> staleRecords;
+    std::atomic<quint64> publishedTicks;
+};
+
+#endif // TELEMETRYRECEIVER_H
@@ -0,0 +1,364 @@
+#include "telemetrystreamer.h"
+#include "fleetstate.h"
+#include "logger.h"
+#include <QHostInfo>
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+
+using namespace TelemetryPacket;
+
+namespace {
+// Room for a few ticks of a large fleet before the kernel pushes back
+const int SEND_BUFFER_BYTES = 8 << 20;
+
+#ifdef Q_OS_LINUX
+// Datagrams per sendmmsg() call
+const std::size_t SEND_BATCH = 256;
+
+// When the send buffer is full: wait this long for room, this many times per tick
+const int SEND_WAIT_MS = 2;
+const int MAX_SEND_WAITS = 8;
+
+socklen_t toSocketAddress(const QHostAddress& address, quint16 port, sockaddr_storage* storage) {
+    std::memset(storage, 0, sizeof(*storage));
+    if (address.protocol() == QAbstractSocket::IPv6Protocol) {
+        sockaddr_in6* ipv6 = reinterpret_cast<sockaddr_in6*>(storage);
+        ipv6->sin6_family = AF_INET6;
+        ipv6->sin6_port = htons(port);
+        const Q_IPV6ADDR bytes = address.toIPv6Address();
+        std::memcpy(&ipv6->sin6_addr, bytes.c, sizeof(bytes.c));
+        return sizeof(sockaddr_in6);
+    }
+    sockaddr_in* ipv4 = reinterpret_cast<sockaddr_in*>(storage);
+    ipv4->sin_family = AF_INET;
+    ipv4->sin_port = htons(port);
+    ipv4->sin_addr.s_addr = htonl(address.toIPv4Address());
+    return sizeof(sockaddr_in);
+}
+#endif
+}
+
+TelemetryStreamer::TelemetryStreamer(int keyframeInterval)
+    : destinationPort(0)
+    , keyframeInterval(qMax(1, keyframeInterval))
+    , keyframeTick(0)
+    , layoutVersion(0)
+    , haveKeyframe(false)
+    , ticksSinceKeyframe(0)
+    , keyframesSinceNames(0)
+    , sequence(0)
+    , streamedTicks(0)
+    , sentDatagrams(0)
+    , droppedDatagrams(0)
+    , bytesSent(0)
+{
+}
+
+TelemetryStreamer::~TelemetryStreamer() {
+    close();
+}
+
+bool TelemetryStreamer::open(const QString& host, quint16 port) {
+    close();
+
+    QHostAddress address;
+    if (!address.setAddress(host)) {
+        // Prefer IPv4, which is what most ground stations listen on
+        const QList<QHostAddress> addresses = QHostInfo::fromName(host).addresses();
+        for (const QHostAddress& candidate : addresses) {
+            if (address.isNull() || (candidate.protocol() == QAbstractSocket::IPv4Protocol
+                                     && address.protocol() != QAbstractSocket::IPv4Protocol)) {
+                address = candidate;
+            }
+        }
+        if (address.isNull()) {
+            LOG_ERROR(QString("Cannot resolve telemetry stream host %1").arg(host));
+            return false;
+        }
+    }
+
+    const bool ipv6 = address.protocol() == QAbstractSocket::IPv6Protocol;
+    if (!socket.bind(ipv6 ? QHostAddress(QHostAddress::AnyIPv6) : QHostAddress(QHostAddress::AnyIPv4), 0)) {
+        LOG_ERROR(QString("Cannot open telemetry stream socket: %1").arg(socket.errorString()));
+        return false;
+    }
+    socket.setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, SEND_BUFFER_BYTES);
+
+    destination = address;
+    destinationPort = port;
+    haveKeyframe = false;
+    sequence = 0;
+    streamedTicks = 0;
+    sentDatagrams = 0;
+    droppedDatagrams = 0;
+    bytesSent = 0;
+
+    LOG_INFO(QString("Streaming telemetry to %1:%2").arg(address.toString()).arg(port));
+    return true;
+}
+
+void TelemetryStreamer::close() {
+    if (!isOpen()) {
+        return;
+    }
+    socket.close();
+
+    LOG_INFO(QString("Telemetry stream closed: %1 ticks, %2 datagrams, %3 bytes, %4 dropped")
+             .arg(streamedTicks)
+             .arg(sentDatagrams)
+             .arg(bytesSent)
+             .arg(droppedDatagrams));
+}
+
+bool TelemetryStreamer::isOpen() const {
+    return socket.state() == QAbstractSocket::BoundState;
+}
+
+void TelemetryStreamer::setKeyframeInterval(int ticks) {
+    keyframeInterval = qMax(1, ticks);
+}
+
+int TelemetryStreamer::getKeyframeInterval() const {
+    return keyframeInterval;
+}
+
+void TelemetryStreamer::updateFleet(const FleetSnapshotPtr& snapshot) {
+    if (snapshot) {
+        stream(*snapshot);
+    }
+}
+
+void TelemetryStreamer::stream(const FleetState& fleet) {
+    if (!isOpen()) {
+        return;
+    }
+
+    // A new drone list invalidates the keyframe and the listeners' name tables
+    const bool layoutChanged = !haveKeyframe || fleet.getLayoutVersion() != layoutVersion;
+    const bool isKeyframe = layoutChanged || ++ticksSinceKeyframe >= keyframeInterval;
+    bool sendNames = layoutChanged;
+    if (isKeyframe) {
+        ticksSinceKeyframe = 0;
+        sendNames = sendNames || ++keyframesSinceNames >= NAME_TABLE_KEYFRAMES;
+    }
+    if (sendNames) {
+        keyframesSinceNames = 0;
+    }
+
+    const std::size_t count = fleet.size();
+    current.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        current[i] = quantize(fleet, i);
+    }
+
+    datagramSizes.clear();
+    if (sendNames) {
+        encodeNameTable(fleet);
+    }
+    encodeStates(fleet, isKeyframe);
+    sendPending();
+
+    if (isKeyframe) {
+        keyframe.swap(current);
+        keyframeTick = fleet.getTick();
+        layoutVersion = fleet.getLayoutVersion();
+        haveKeyframe = true;
+    }
+    ++streamedTicks;
+}
+
+quint64 TelemetryStreamer::getStreamedTicks() const {
+    return streamedTicks;
+}
+
+quint64 TelemetryStreamer::getSentDatagrams() const {
+    return sentDatagrams;
+}
+
+quint64 TelemetryStreamer::getDroppedDatagrams() const {
+    return droppedDatagrams;
+}
+
+quint64 TelemetryStreamer::getBytesSent() const {
+    return bytesSent;
+}
+
+void TelemetryStreamer::encodeNameTable(const FleetState& fleet) {
+    PacketHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.type = NAME_TABLE;
+    header.layoutVersion = static_cast<quint32>(fleet.getLayoutVersion());
+    header.fleetSize = static_cast<quint32>(fleet.size());
+    header.tick = fleet.getTick();
+    header.simulationTime = fleet.getSimulationTime();
+    header.baseTick = header.tick;
+
+    const std::size_t count = fleet.size();
+    std::size_t index = 0;
+    while (index < count) {
+        char* datagram = beginDatagram();
+        char* payload = datagram + sizeof(PacketHeader);
+        std::size_t used = 0;
+        header.firstIndex = static_cast<quint32>(index);
+        header.recordCount = 0;
+
+        while (index < count) {
+            const QByteArray name = fleet.nameAt(index).toUtf8().left(255);
+            const std::size_t recordBytes = sizeof(quint32) + 1 + name.size();
+            if (used + recordBytes > MAX_PAYLOAD_BYTES) {
+                break;
+            }
+            const DroneId id = fleet.idAt(index);
+            const quint8 length = static_cast<quint8>(name.size());
+            std::memcpy(payload + used, &id, sizeof(id));
+            payload[used + sizeof(id)] = static_cast<char>(length);
+            std::memcpy(payload + used + sizeof(id) + 1, name.constData(), length);
+            used += recordBytes;
+            ++header.recordCount;
+            ++index;
+        }
+
+        header.payloadBytes = static_cast<quint16>(used);
+        finishDatagram(datagram, header);
+    }
+}
+
+void TelemetryStreamer::encodeStates(const FleetState& fleet, bool isKeyframe) {
+    PacketHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.layoutVersion = static_cast<quint32>(fleet.getLayoutVersion());
+    header.fleetSize = static_cast<quint32>(fleet.size());
+    header.tick = fleet.getTick();
+    header.simulationTime = fleet.getSimulationTime();
+
+    const std::size_t count = current.size();
+    std::size_t index = 0;
+    while (index < count) {
+        const std::size_t remaining = count - index;
+
+        // Deltas until a drone has moved too far from its keyframe; a short
+        // delta run is not worth a datagram, so that stretch goes out in full
+        std::size_t deltaCount = 0;
+        if (!isKeyframe) {
+            const std::size_t limit = qMin(remaining, MAX_DELTA_RECORDS);
+            while (deltaCount < limit && fitsDelta(keyframe[index + deltaCount], current[index + deltaCount])) {
+                ++deltaCount;
+            }
+        }
+        const bool useDelta = deltaCount > 0 && (deltaCount == remaining || deltaCount >= MAX_FULL_RECORDS);
+
+        char* datagram = beginDatagram();
+        char* payload = datagram + sizeof(PacketHeader);
+        header.firstIndex = static_cast<quint32>(index);
+        if (useDelta) {
+            header.type = DELTA_STATE;
+            header.flags = 0;
+            header.baseTick = keyframeTick;
+            header.recordCount = static_cast<quint16>(deltaCount);
+            for (std::size_t i = 0; i < deltaCount; ++i) {
+                writeDelta(payload + i * DELTA_RECORD_BYTES, keyframe[index + i], current[index + i]);
+            }
+            header.payloadBytes = static_cast<quint16>(deltaCount * DELTA_RECORD_BYTES);
+        } else {
+            const std::size_t fullCount = qMin(remaining, MAX_FULL_RECORDS);
+            header.type = FULL_STATE;
+            header.flags = isKeyframe ? KEYFRAME : 0;
+            header.baseTick = header.tick;
+            header.recordCount = static_cast<quint16>(fullCount);
+            for (std::size_t i = 0; i < fullCount; ++i) {
+                writeFull(payload + i * FULL_RECORD_BYTES, current[index + i]);
+            }
+            header.payloadBytes = static_cast<quint16>(fullCount * FULL_RECORD_BYTES);
+        }
+        index += header.recordCount;
+        finishDatagram(datagram, header);
+    }
+}
+
+char* TelemetryStreamer::beginDatagram() {
+    // The buffer only grows, so steady-state ticks never allocate
+    const std::size_t needed = (datagramSizes.size() + 1) * MAX_DATAGRAM_BYTES;
+    if (datagrams.size() < needed) {
+        datagrams.resize(needed);
+    }
+    return datagrams.data() + datagramSizes.size() * MAX_DATAGRAM_BYTES;
+}
+
+void TelemetryStreamer::finishDatagram(char* datagram, PacketHeader& header) {
+    header.magic = MAGIC;
+    header.version = PROTOCOL_VERSION;
+    header.sequence = sequence++;
+    datagramSizes.push_back(TelemetryPacket::finishDatagram(datagram, header));
+}
+
+void TelemetryStreamer::sendPending() {
+    const std::size_t count = datagramSizes.size();
+    std::size_t next = 0;
+
+#ifdef Q_OS_LINUX
+    const int descriptor = static_cast<int>(socket.socketDescriptor());
+    sockaddr_storage address;
+    const socklen_t addressLength = toSocketAddress(destination, destinationPort, &address);
+
+    mmsghdr messages[SEND_BATCH];
+    iovec vectors[SEND_BATCH];
+    int waits = 0;
+    while (next < count) {
+        const std::size_t batch = qMin(SEND_BATCH, count - next);
+        for (std::size_t i = 0; i < batch; ++i) {
+            vectors[i].iov_base = datagrams.data() + (next + i) * MAX_DATAGRAM_BYTES;
+            vectors[i].iov_len = datagramSizes[next + i];
+            std::memset(&messages[i], 0, sizeof(messages[i]));
+            messages[i].msg_hdr.msg_name = &address;
+            messages[i].msg_hdr.msg_namelen = addressLength;
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        const int sent = ::sendmmsg(descriptor, messages, static_cast<unsigned int>(batch), 0);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) && waits < MAX_SEND_WAITS) {
+                pollfd writable = {descriptor, POLLOUT, 0};
+                ::poll(&writable, 1, SEND_WAIT_MS);
+                ++waits;
+                continue;
+            }
+            if (droppedDatagrams == 0) {
+                LOG_WARNING(QString("Telemetry stream send failed: %1").arg(std::strerror(errno)));
+            }
+            break;
+        }
+        for (int i = 0; i < sent; ++i) {
+            bytesSent += messages[i].msg_len;
+        }
+        sentDatagrams += sent;
+        next += sent;
+    }
+#else
+    for (; next < count; ++next) {
+        const qint64 written = socket.writeDatagram(datagrams.data() + next * MAX_DATAGRAM_BYTES,
+                                                    datagramSizes[next], destination, destinationPort);
+        if (written < 0) {
+            if (droppedDatagrams == 0) {
+                LOG_WARNING(QString("Telemetry stream send failed: %1").arg(socket.errorString()));
+            }
+            break;
+        }
+        bytesSent += written;
+        ++sentDatagrams;
+    }
+#endif
+
+    droppedDatagrams += count - next;
+}
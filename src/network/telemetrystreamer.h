@@ -0,0 +1,83 @@
+#ifndef TELEMETRYSTREAMER_H
+#define TELEMETRYSTREAMER_H
+
+#include <QHostAddress>
+#include <QString>
+#include <QUdpSocket>
+#include <cstddef>
+#include <vector>
+#include "observer.h"
+#include "telemetrypacket.h"
+
+// Observer that streams every tick's fleet state to a UDP endpoint (see
+// telemetrypacket.h). A tick is encoded into a run of MTU-sized datagrams
+// in one buffer, then sent in batches: one sendmmsg() call per batch on
+// Linux, one writeDatagram() per datagram elsewhere. Every keyframeInterval
+// ticks (and whenever the fleet layout changes) drones are sent in full;
+// in between they are sent as deltas against that keyframe. The name table
+// follows layout changes and every NAME_TABLE_KEYFRAMES keyframes so late
+// listeners can label drones.
+class TelemetryStreamer : public Observer {
+public:
+    static const int DEFAULT_KEYFRAME_INTERVAL = 10;
+    static const int NAME_TABLE_KEYFRAMES = 10;
+
+    explicit TelemetryStreamer(int keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+    ~TelemetryStreamer() override;
+
+    TelemetryStreamer(const TelemetryStreamer&) = delete;
+    TelemetryStreamer& operator=(const TelemetryStreamer&) = delete;
+
+    // Resolves host (address or name) and opens a socket; false on failure
+    bool open(const QString& host, quint16 port);
+    void close();
+    bool isOpen() const;
+
+    // 1 sends every tick in full
+    void setKeyframeInterval(int ticks);
+    int getKeyframeInterval() const;
+
+    // Streams the tick's snapshot; single-drone updates are ignored
+    void updateFleet(const FleetSnapshotPtr& snapshot) override;
+
+    // Sends one tick directly, e.g. from a fleet that is not published
+    void stream(const FleetState& fleet);
+
+    quint64 getStreamedTicks() const;
+    quint64 getSentDatagrams() const;
+    quint64 getDroppedDatagrams() const;
+    quint64 getBytesSent() const;
+
+private:
+    void encodeNameTable(const FleetState& fleet);
+    void encodeStates(const FleetState& fleet, bool keyframe);
+    char* beginDatagram();
+    void finishDatagram(char* datagram, TelemetryPacket::PacketHeader& header);
+    void sendPending();
+
+    QUdpSocket socket;
+    QHostAddress destination;
+    quint16 destinationPort;
+    int keyframeInterval;
+
+    // Encoded datagrams of the current tick, one MAX_DATAGRAM_BYTES slot each
+    std::vector<char> datagrams;
+    std::vector<std::size_t> datagramSizes;
+
+    // Quantized state of the last keyframe and of the current tick
+    std::vector<TelemetryPacket::StateRecord> keyframe;
+    std::vector<TelemetryPacket::StateRecord> current;
+    quint64 keyframeTick;
+    quint64 layoutVersion;
+    bool haveKeyframe;
+    int ticksSinceKeyframe;
+    int keyframesSinceNames;
+
+    quint32 sequence;
+    quint64 streamedTicks;
+    quint64 sentDatagrams;
+    quint64 droppedDatagrams;
+    quint64 bytesSent;
+};
+
+#endif // TELEMETRYSTREAMER_H
@@ -1,3 +1,12 @@
 #include "observer.h"
-// Implementation file for Observer pattern interfaces
-// No implementation needed for pure virtual classes
\ No newline at end of file
+#include "fleetstate.h"
+
+void Observer::update(const DroneData& data) {
+    Q_UNUSED(data);
+}
+
+void Observer::updateFleet(const FleetSnapshotPtr& snapshot) {
+    for (std::size_t i = 0; i < snapshot->size(); ++i) {
+        update(snapshot->view(i));
+    }
+}
@@ -1,13 +1,21 @@
 #ifndef OBSERVER_H
 #define OBSERVER_H
 
+#include "fleetsnapshot.h"
+
 class DroneData;
 
 // Observer Pattern Implementation
 class Observer {
 public:
     virtual ~Observer() = default;
-    virtual void update(const DroneData& data) = 0;
+    // Called per drone by the default updateFleet(); ignored unless overridden
+    virtual void update(const DroneData& data);
+
+    // Called once per tick with the tick's shared, immutable snapshot. The
+    // default fans out one DroneData view per drone to update(); fleet-aware
+    // observers override it and read the snapshot (or keep it) without copying.
+    virtual void updateFleet(const FleetSnapshotPtr& snapshot);
 };
 
 class Subject {
@@ -18,4 +26,4 @@ public:
     virtual void notify() = 0;
 };
 
-#endif // OBSERVER_H
\ No newline at end of file
+#endif // OBSERVER_H
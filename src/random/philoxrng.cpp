@@ -0,0 +1,116 @@
+#include "philoxrng.h"
+#include <cmath>
+
+namespace {
+
+const quint32 PHILOX_M0 = 0xD2511F53;
+const quint32 PHILOX_M1 = 0xCD9E8D57;
+const quint32 PHILOX_W0 = 0x9E3779B9;
+const quint32 PHILOX_W1 = 0xBB67AE85;
+const int PHILOX_ROUNDS = 10;
+
+inline void mulHiLo(quint32 a, quint32 b, quint32& hi, quint32& lo) {
+    quint64 product = static_cast<quint64>(a) * b;
+    hi = static_cast<quint32>(product >> 32);
+    lo = static_cast<quint32>(product);
+}
+
+inline quint64 combine(quint32 hi, quint32 lo) {
+    return (static_cast<quint64>(hi) << 32) | lo;
+}
+
+} // namespace
+
+PhiloxRng::PhiloxRng(quint64 seed, Domain domain)
+    : seedValue(seed)
+    , domainValue(domain)
+{
+}
+
+void PhiloxRng::setSeed(quint64 seed) {
+    seedValue = seed;
+}
+
+PhiloxRng::Block PhiloxRng::generateBlock(const Block& counter, quint64 key) {
+    quint32 c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    quint32 k0 = static_cast<quint32>(key);
+    quint32 k1 = static_cast<quint32>(key >> 32);
+
+    for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+        quint32 hi0, lo0, hi1, lo1;
+        mulHiLo(PHILOX_M0, c0, hi0, lo0);
+        mulHiLo(PHILOX_M1, c2, hi1, lo1);
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    return Block{{c0, c1, c2, c3}};
+}
+
+PhiloxRng::Block PhiloxRng::counterFor(quint64 stream, quint64 tick, quint32 block) const {
+    // Counter layout: block index, tick, stream, then the domain folded in
+    // with the high halves of tick and stream
+    quint32 upper = (static_cast<quint32>(domainValue) << 24)
+                    ^ static_cast<quint32>(tick >> 32)
+                    ^ (static_cast<quint32>(stream >> 32) << 12);
+    return Block{{block, static_cast<quint32>(tick), static_cast<quint32>(stream), upper}};
+}
+
+quint64 PhiloxRng::bits(quint64 stream, quint64 tick, quint32 index) const {
+    // Each block carries two 64-bit draws
+    Block out = generateBlock(counterFor(stream, tick, index / 2), seedValue);
+    return (index % 2 == 0) ? combine(out[1], out[0]) : combine(out[3], out[2]);
+}
+
+double PhiloxRng::uniform(quint64 stream, quint64 tick, quint32 index) const {
+    return toUnit(bits(stream, tick, index));
+}
+
+void PhiloxRng::fillBitPlanes(quint64 firstStream, quint64 tick, std::size_t count,
+                              int draws, quint64* out) const {
+    const quint32 blocks = static_cast<quint32>((draws + 1) / 2);
+    for (std::size_t i = 0; i < count; ++i) {
+        for (quint32 block = 0; block < blocks; ++block) {
+            Block value = generateBlock(counterFor(firstStream + i, tick, block), seedValue);
+            const int draw = static_cast<int>(block) * 2;
+            out[static_cast<std::size_t>(draw) * count + i] = combine(value[1], value[0]);
+            if (draw + 1 < draws) {
+                out[static_cast<std::size_t>(draw + 1) * count + i] = combine(value[3], value[2]);
+            }
+        }
+    }
+}
+
+void PhiloxRng::fillUniform(quint64 stream, quint64 tick, double* out, std::size_t count) const {
+    for (std::size_t i = 0; i < count; i += 2) {
+        Block value = generateBlock(counterFor(stream, tick, static_cast<quint32>(i / 2)), seedValue);
+        out[i] = toUnit(combine(value[1], value[0]));
+        if (i + 1 < count) {
+            out[i + 1] = toUnit(combine(value[3], value[2]));
+        }
+    }
+}
+
+void PhiloxRng::fillNormal(quint64 stream, quint64 tick, double* out, std::size_t count) const {
+    // Box-Muller: each block's two uniforms become two standard normals
+    const double twoPi = 6.28318530717958647692;
+    for (std::size_t i = 0; i < count; i += 2) {
+        Block value = generateBlock(counterFor(stream, tick, static_cast<quint32>(i / 2)), seedValue);
+        double u1 = 1.0 - toUnit(combine(value[1], value[0]));  // (0, 1], safe for log
+        double u2 = toUnit(combine(value[3], value[2]));
+        double radius = std::sqrt(-2.0 * std::log(u1));
+        out[i] = radius * std::cos(twoPi * u2);
+        if (i + 1 < count) {
+            out[i + 1] = radius * std::sin(twoPi * u2);
+        }
+    }
+}
+
+double PhiloxRng::toUnit(quint64 bits) {
+    // Top 53 bits scaled into [0, 1)
+    return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+}
@@ -0,0 +1,58 @@
+#ifndef PHILOXRNG_H
+#define PHILOXRNG_H
+
+#include <QtGlobal>
+#include <array>
+#include <cstddef>
+
+// Counter-based random number generator (Philox4x32-10, Salmon et al. 2011).
+// Every draw is a pure function of (seed, domain, stream, tick, index): there
+// is no shared mutable state, so parallel ticks never contend and any run is
+// bit-reproducible from its seed. The simulation uses the drone's fleet
+// index as the stream, not its ID, so removing a drone shifts the draws of
+// every drone after it.
+class PhiloxRng {
+public:
+    typedef std::array<quint32, 4> Block;
+
+    // Independent sub-streams so different consumers never reuse draws
+    enum Domain {
+        MOVEMENT = 1,
+        INITIALIZATION = 2,
+        ENERGY = 3,
+        ENSEMBLE = 4
+    };
+
+    explicit PhiloxRng(quint64 seed = 0, Domain domain = MOVEMENT);
+
+    quint64 seed() const { return seedValue; }
+    void setSeed(quint64 seed);
+    Domain domain() const { return domainValue; }
+
+    // Raw Philox4x32-10 bijection
+    static Block generateBlock(const Block& counter, quint64 key);
+
+    // Draw `index` of (stream, tick) as 64 random bits / uniform in [0, 1)
+    quint64 bits(quint64 stream, quint64 tick, quint32 index) const;
+    double uniform(quint64 stream, quint64 tick, quint32 index) const;
+
+    // Batch fill for `count` consecutive streams starting at `firstStream`,
+    // `draws` values each, laid out plane by plane:
+    // out[k * count + i] is draw k of stream firstStream + i
+    void fillBitPlanes(quint64 firstStream, quint64 tick, std::size_t count,
+                       int draws, quint64* out) const;
+
+    // Sequential batches from a single (stream, tick)
+    void fillUniform(quint64 stream, quint64 tick, double* out, std::size_t count) const;
+    void fillNormal(quint64 stream, quint64 tick, double* out, std::size_t count) const;
+
+    static double toUnit(quint64 bits);
+
+private:
+    Block counterFor(quint64 stream, quint64 tick, quint32 block) const;
+
+    quint64 seedValue;
+    Domain domainValue;
+};
+
+#endif // PHILOXRNG_H
@@ -0,0 +1,61 @@
+#include "telemetryformat.h"
+#include <cstring>
+
+namespace TelemetryFormat {
+
+namespace {
+
+// Eight tables of 256 entries: table[k][b] is the CRC of byte b followed by k zero bytes
+struct Crc32Tables {
+    quint32 table[8][256];
+
+    Crc32Tables() {
+        for (quint32 byte = 0; byte < 256; ++byte) {
+            quint32 crc = byte;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+            }
+            table[0][byte] = crc;
+        }
+        for (quint32 byte = 0; byte < 256; ++byte) {
+            for (int k = 1; k < 8; ++k) {
+                table[k][byte] = (table[k - 1][byte] >> 8) ^ table[0][table[k - 1][byte] & 0xFF];
+            }
+        }
+    }
+};
+
+const Crc32Tables& crcTables() {
+    static const Crc32Tables tables;
+    return tables;
+}
+
+} // namespace
+
+quint32 crc32(const void* data, std::size_t size, quint32 crc) {
+    const quint32 (*table)[256] = crcTables().table;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+
+    // Eight bytes per step; the word is read little-endian
+    while (size >= 8) {
+        quint32 low;
+        quint32 high;
+        std::memcpy(&low, bytes, 4);
+        std::memcpy(&high, bytes + 4, 4);
+        low ^= crc;
+        crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF]
+            ^ table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24]
+            ^ table[3][high & 0xFF] ^ table[2][(high >> 8) & 0xFF]
+            ^ table[1][(high >> 16) & 0xFF] ^ table[0][high >> 24];
+        bytes += 8;
+        size -= 8;
+    }
+
+    while (size-- > 0) {
+        crc = (crc >> 8) ^ table[0][(crc ^ *bytes++) & 0xFF];
+    }
+    return ~crc;
+}
+
+} // namespace TelemetryFormat
@@ -0,0 +1,82 @@
+#ifndef TELEMETRYFORMAT_H
+#define TELEMETRYFORMAT_H
+
+#include <QtGlobal>
+#include <cstddef>
+
+// On-disk layout of telemetry recordings (.dtr). All integers and doubles
+// are stored in host byte order (little-endian on every supported target)
+// and every block starts on an 8-byte boundary so a mapped file can be read
+// in place.
+//
+//   FileHeader
+//   block*        each block = BlockHeader + payload (padded to 8 bytes)
+//
+// ID_TABLE payload, written whenever the fleet layout changes:
+//   droneCount x { quint16 utf8Length; char utf8[utf8Length] }
+// TICK_CHUNK payload, tickCount ticks of droneCount drones:
+//   quint64 tick[tickCount]
+//   double  time[tickCount]
+//   double  column[tickCount * droneCount] for each DOUBLE_COLUMN_COUNT column
+//   quint8  gpsStatus[tickCount * droneCount]
+// Within a column, drone d of the chunk's t-th tick is element t * droneCount + d.
+namespace TelemetryFormat {
+
+const char FILE_MAGIC[8] = {'D', 'R', 'O', 'N', 'E', 'T', 'L', 'M'};
+const quint32 FORMAT_VERSION = 1;
+
+enum BlockType : quint32 {
+    ID_TABLE = 0x31444954,    // "TID1"
+    TICK_CHUNK = 0x31484354   // "TCH1"
+};
+
+// Double columns in payload order; GPS status follows as one byte per drone
+enum Column {
+    LATITUDE = 0,
+    LONGITUDE = 1,
+    ALTITUDE = 2,
+    HEADING = 3,
+    SPEED = 4,
+    BATTERY = 5,
+    DOUBLE_COLUMN_COUNT = 6
+};
+
+struct FileHeader {
+    char magic[8];
+    quint32 version;
+    quint32 headerBytes;
+    quint32 doubleColumnCount;
+    quint32 maxTicksPerChunk;
+    qint64 createdMsecsSinceEpoch;
+    quint8 reserved[32];
+};
+
+struct BlockHeader {
+    quint32 type;
+    quint32 tickCount;       // 0 for ID_TABLE
+    quint64 droneCount;
+    quint64 firstTick;       // ID_TABLE: first tick the table applies to
+    double firstTime;
+    double lastTime;
+    quint64 payloadBytes;    // including the padding to 8 bytes
+    quint32 payloadCrc32;    // CRC-32 of the unpadded payload
+    quint32 reserved;
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout is part of the file format");
+static_assert(sizeof(BlockHeader) == 56, "BlockHeader layout is part of the file format");
+
+// Bytes per drone per tick in a TICK_CHUNK
+const std::size_t BYTES_PER_SAMPLE = DOUBLE_COLUMN_COUNT * sizeof(double) + sizeof(quint8);
+
+inline quint64 paddedSize(quint64 bytes) {
+    return (bytes + 7) & ~quint64(7);
+}
+
+// CRC-32 (IEEE 802.3, reflected), slicing-by-8. Pass the previous result
+// as `crc` to checksum a payload written in several pieces.
+quint32 crc32(const void* data, std::size_t size, quint32 crc = 0);
+
+} // namespace TelemetryFormat
+
+#endif // TELEMETRYFORMAT_H
@@ -0,0 +1,129 @@
+#include "telemetryplayer.h"
+#include "dronesimulator.h"
+#include "logger.h"
+
+namespace {
+// Paced playback wakes at 100 Hz and publishes every tick that fell due
+const int PACED_INTERVAL_MS = 10;
+
+// Upper bound on ticks per wake-up so the event loop stays responsive
+const int MAX_TICKS_PER_WAKEUP = 1024;
+}
+
+TelemetryPlayer::TelemetryPlayer(DroneSimulator* simulator, QObject *parent)
+    : QObject(parent)
+    , simulator(simulator)
+    , playbackTimer(new QTimer(this))
+    , speed(1.0)
+    , clockStartTime(0.0)
+    , position(0)
+{
+    playbackTimer->setTimerType(Qt::PreciseTimer);
+    connect(playbackTimer, &QTimer::timeout, this, &TelemetryPlayer::onTimer);
+}
+
+bool TelemetryPlayer::open(const QString& filename) {
+    pause();
+    position = 0;
+    return replay.open(filename);
+}
+
+const TelemetryReplay& TelemetryPlayer::getReplay() const {
+    return replay;
+}
+
+void TelemetryPlayer::setSpeed(double factor) {
+    speed = qMax(0.0, factor);
+    if (isPlaying()) {
+        restartClock();
+        playbackTimer->start(speed > 0.0 ? PACED_INTERVAL_MS : 0);
+    }
+}
+
+double TelemetryPlayer::getSpeed() const {
+    return speed;
+}
+
+void TelemetryPlayer::play() {
+    if (!replay.isOpen() || position >= replay.getTickCount()) {
+        return;
+    }
+
+    // Recorded telemetry replaces the live simulation while it plays
+    simulator->stopSimulation();
+    restartClock();
+    playbackTimer->start(speed > 0.0 ? PACED_INTERVAL_MS : 0);
+    Logger::getInstance().log(Logger::INFO,
+        QString("Replay started at %1 s (speed %2x)").arg(clockStartTime, 0, 'f', 1).arg(speed));
+}
+
+void TelemetryPlayer::pause() {
+    playbackTimer->stop();
+}
+
+bool TelemetryPlayer::isPlaying() const {
+    return playbackTimer->isActive();
+}
+
+void TelemetryPlayer::seek(double time) {
+    position = replay.seek(time);
+    restartClock();
+}
+
+quint64 TelemetryPlayer::getPosition() const {
+    return position;
+}
+
+quint64 TelemetryPlayer::runToEnd() {
+    pause();
+    simulator->stopSimulation();
+
+    quint64 published = 0;
+    while (position < replay.getTickCount() && publishNext()) {
+        ++published;
+    }
+    return published;
+}
+
+void TelemetryPlayer::onTimer() {
+    const quint64 tickCount = replay.getTickCount();
+
+    if (speed <= 0.0) {
+        for (int i = 0; i < MAX_TICKS_PER_WAKEUP && position < tickCount; ++i) {
+            if (!publishNext()) {
+                break;
+            }
+        }
+    } else {
+        // Publish every tick whose recorded time has come, in order
+        const double due = clockStartTime + playbackClock.nsecsElapsed() / 1e9 * speed;
+        for (int i = 0; i < MAX_TICKS_PER_WAKEUP && position < tickCount; ++i) {
+            if (replay.timeAt(position) > due || !publishNext()) {
+                break;
+            }
+        }
+    }
+
+    if (position >= tickCount) {
+        pause();
+        Logger::getInstance().log(Logger::INFO, "Replay finished");
+        emit finished();
+    }
+}
+
+bool TelemetryPlayer::publishNext() {
+    if (!replay.loadTick(position, frame)) {
+        // Corrupt chunk: stop here rather than publish garbage
+        position = replay.getTickCount();
+        return false;
+    }
+
+    simulator->publishFleet(frame);
+    ++position;
+    return true;
+}
+
+void TelemetryPlayer::restartClock() {
+    clockStartTime = replay.timeAt(position);
+    playbackClock.start();
+}
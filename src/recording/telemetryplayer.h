@@ -0,0 +1,61 @@
+#ifndef TELEMETRYPLAYER_H
+#define TELEMETRYPLAYER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+#include "fleetstate.h"
+#include "telemetryreplay.h"
+
+class DroneSimulator;
+
+// Plays a telemetry recording back through a DroneSimulator: each recorded
+// tick is published with DroneSimulator::publishFleet(), so the
+// telemetryUpdated signal and every attached observer (MainWindow, recorders,
+// ground-station consumers) see it exactly as they saw the live run.
+class TelemetryPlayer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TelemetryPlayer(DroneSimulator* simulator, QObject *parent = nullptr);
+
+    bool open(const QString& filename);
+    const TelemetryReplay& getReplay() const;
+
+    // 1.0 plays in real time, N plays N times faster, 0 as fast as possible
+    void setSpeed(double factor);
+    double getSpeed() const;
+
+    void play();
+    void pause();
+    bool isPlaying() const;
+
+    // Continues from the first tick recorded at or after `time`
+    void seek(double time);
+    quint64 getPosition() const;
+
+    // Publishes every remaining tick back to back without the event loop;
+    // returns the number published
+    quint64 runToEnd();
+
+signals:
+    void finished();
+
+private slots:
+    void onTimer();
+
+private:
+    bool publishNext();
+    void restartClock();
+
+    DroneSimulator* simulator;
+    TelemetryReplay replay;
+    FleetState frame;
+    QTimer* playbackTimer;
+    QElapsedTimer playbackClock;
+    double speed;
+    double clockStartTime;
+    quint64 position;
+};
+
+#endif // TELEMETRYPLAYER_H
@@ -0,0 +1,260 @@
+#include "telemetryrecorder.h"
+#include "fleetstate.h"
+#include "logger.h"
+#include <QDateTime>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Staging buffer for headers and small chunks; larger pieces bypass it
+const std::size_t WRITE_BUFFER_BYTES = 1 << 20;
+
+// Large fleets get fewer ticks per chunk so one chunk stays around this size
+const std::size_t CHUNK_BYTE_LIMIT = 16 << 20;
+
+const char PADDING[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+}
+
+TelemetryRecorder::TelemetryRecorder(int maxTicksPerChunk)
+    : maxTicksPerChunk(qMax(1, maxTicksPerChunk))
+    , chunkTickLimit(1)
+    , droneCount(0)
+    , layoutVersion(0)
+    , haveLayout(false)
+    , recordedTicks(0)
+    , bytesWritten(0)
+{
+    writeBuffer.reserve(WRITE_BUFFER_BYTES);
+}
+
+TelemetryRecorder::~TelemetryRecorder() {
+    close();
+}
+
+bool TelemetryRecorder::open(const QString& filename) {
+    close();
+
+    // Unbuffered: writeBuffer already batches small writes
+    file.setFileName(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        Logger::getInstance().log(Logger::ERROR,
+            QString("Cannot open telemetry recording %1: %2").arg(filename, file.errorString()));
+        return false;
+    }
+
+    haveLayout = false;
+    droneCount = 0;
+    recordedTicks = 0;
+    bytesWritten = 0;
+    chunkTicks.clear();
+    chunkTimes.clear();
+
+    TelemetryFormat::FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TelemetryFormat::FILE_MAGIC, sizeof(header.magic));
+    header.version = TelemetryFormat::FORMAT_VERSION;
+    header.headerBytes = sizeof(header);
+    header.doubleColumnCount = TelemetryFormat::DOUBLE_COLUMN_COUNT;
+    header.maxTicksPerChunk = static_cast<quint32>(maxTicksPerChunk);
+    header.createdMsecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+    writeBytes(&header, sizeof(header));
+
+    Logger::getInstance().log(Logger::INFO, QString("Recording telemetry to %1").arg(filename));
+    return file.isOpen();
+}
+
+void TelemetryRecorder::close() {
+    if (!file.isOpen()) {
+        return;
+    }
+
+    flushChunk();
+    flushWriteBuffer();
+    file.close();
+
+    Logger::getInstance().log(Logger::INFO,
+        QString("Telemetry recording closed: %1 ticks, %2 bytes")
+        .arg(recordedTicks)
+        .arg(bytesWritten));
+}
+
+bool TelemetryRecorder::isOpen() const {
+    return file.isOpen();
+}
+
+void TelemetryRecorder::updateFleet(const FleetSnapshotPtr& snapshot) {
+    record(*snapshot);
+}
+
+void TelemetryRecorder::record(const FleetState& fleet) {
+    if (!file.isOpen()) {
+        return;
+    }
+
+    // A new drone list starts a new chunk behind a fresh ID table
+    if (!haveLayout || fleet.getLayoutVersion() != layoutVersion || fleet.size() != droneCount) {
+        flushChunk();
+        writeIdTable(fleet);
+    }
+
+    const std::size_t slot = chunkTicks.size() * droneCount;
+    chunkTicks.push_back(fleet.getTick());
+    chunkTimes.push_back(fleet.getSimulationTime());
+
+    const double* columns[TelemetryFormat::DOUBLE_COLUMN_COUNT] = {
+        fleet.latitudes(), fleet.longitudes(), fleet.altitudes(),
+        fleet.headings(), fleet.speeds(), fleet.batteries()
+    };
+    for (int column = 0; column < TelemetryFormat::DOUBLE_COLUMN_COUNT; ++column) {
+        std::copy(columns[column], columns[column] + droneCount, chunkColumns[column].begin() + slot);
+    }
+    const GPSFixStatus* gpsStatus = fleet.gpsStatuses();
+    for (std::size_t i = 0; i < droneCount; ++i) {
+        chunkGpsStatus[slot + i] = static_cast<quint8>(gpsStatus[i]);
+    }
+
+    ++recordedTicks;
+    if (chunkTicks.size() >= chunkTickLimit) {
+        flushChunk();
+    }
+}
+
+quint64 TelemetryRecorder::getRecordedTicks() const {
+    return recordedTicks;
+}
+
+quint64 TelemetryRecorder::getBytesWritten() const {
+    return bytesWritten;
+}
+
+void TelemetryRecorder::writeIdTable(const FleetState& fleet) {
+    droneCount = fleet.size();
+    layoutVersion = fleet.getLayoutVersion();
+    haveLayout = true;
+
+    QByteArray payload;
+    for (std::size_t i = 0; i < droneCount; ++i) {
+        QByteArray id = fleet.nameAt(i).toUtf8().left(0xFFFF);
+        const quint16 length = static_cast<quint16>(id.size());
+        payload.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        payload.append(id);
+    }
+
+    TelemetryFormat::BlockHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.type = TelemetryFormat::ID_TABLE;
+    header.droneCount = droneCount;
+    header.firstTick = fleet.getTick();
+    header.firstTime = fleet.getSimulationTime();
+    header.lastTime = fleet.getSimulationTime();
+    header.payloadBytes = TelemetryFormat::paddedSize(payload.size());
+    header.payloadCrc32 = TelemetryFormat::crc32(payload.constData(), payload.size());
+
+    writeBytes(&header, sizeof(header));
+    writeBytes(payload.constData(), payload.size());
+    writeBytes(PADDING, header.payloadBytes - payload.size());
+
+    // Size the chunk columns for the new drone count
+    const std::size_t tickBytes = qMax<std::size_t>(1, droneCount * TelemetryFormat::BYTES_PER_SAMPLE);
+    chunkTickLimit = qBound<std::size_t>(1, CHUNK_BYTE_LIMIT / tickBytes, maxTicksPerChunk);
+    for (std::vector<double>& column : chunkColumns) {
+        column.resize(chunkTickLimit * droneCount);
+    }
+    chunkGpsStatus.resize(chunkTickLimit * droneCount);
+    chunkTicks.reserve(chunkTickLimit);
+    chunkTimes.reserve(chunkTickLimit);
+}
+
+void TelemetryRecorder::flushChunk() {
+    if (chunkTicks.empty() || !file.isOpen()) {
+        chunkTicks.clear();
+        chunkTimes.clear();
+        return;
+    }
+
+    const std::size_t tickCount = chunkTicks.size();
+    const std::size_t samples = tickCount * droneCount;
+    const std::size_t tickBytes = tickCount * sizeof(quint64);
+    const std::size_t timeBytes = tickCount * sizeof(double);
+    const std::size_t columnBytes = samples * sizeof(double);
+
+    quint32 crc = TelemetryFormat::crc32(chunkTicks.data(), tickBytes);
+    crc = TelemetryFormat::crc32(chunkTimes.data(), timeBytes, crc);
+    for (const std::vector<double>& column : chunkColumns) {
+        crc = TelemetryFormat::crc32(column.data(), columnBytes, crc);
+    }
+    crc = TelemetryFormat::crc32(chunkGpsStatus.data(), samples, crc);
+
+    const quint64 payloadBytes = tickBytes + timeBytes
+        + TelemetryFormat::DOUBLE_COLUMN_COUNT * columnBytes + samples;
+
+    TelemetryFormat::BlockHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.type = TelemetryFormat::TICK_CHUNK;
+    header.tickCount = static_cast<quint32>(tickCount);
+    header.droneCount = droneCount;
+    header.firstTick = chunkTicks.front();
+    header.firstTime = chunkTimes.front();
+    header.lastTime = chunkTimes.back();
+    header.payloadBytes = TelemetryFormat::paddedSize(payloadBytes);
+    header.payloadCrc32 = crc;
+
+    writeBytes(&header, sizeof(header));
+    writeBytes(chunkTicks.data(), tickBytes);
+    writeBytes(chunkTimes.data(), timeBytes);
+    for (const std::vector<double>& column : chunkColumns) {
+        writeBytes(column.data(), columnBytes);
+    }
+    writeBytes(chunkGpsStatus.data(), samples);
+    writeBytes(PADDING, header.payloadBytes - payloadBytes);
+
+    chunkTicks.clear();
+    chunkTimes.clear();
+}
+
+void TelemetryRecorder::writeBytes(const void* data, std::size_t size) {
+    if (writeBuffer.size() + size > WRITE_BUFFER_BYTES) {
+        flushWriteBuffer();
+    }
+
+    // Whole columns of large fleets go straight to the file
+    if (size >= WRITE_BUFFER_BYTES) {
+        if (!file.isOpen()) {
+            return;
+        }
+        if (file.write(static_cast<const char*>(data), size) != qint64(size)) {
+            fail(file.errorString());
+            return;
+        }
+        bytesWritten += size;
+        return;
+    }
+
+    const char* bytes = static_cast<const char*>(data);
+    writeBuffer.insert(writeBuffer.end(), bytes, bytes + size);
+}
+
+void TelemetryRecorder::flushWriteBuffer() {
+    if (writeBuffer.empty() || !file.isOpen()) {
+        writeBuffer.clear();
+        return;
+    }
+
+    const qint64 size = static_cast<qint64>(writeBuffer.size());
+    if (file.write(writeBuffer.data(), size) != size) {
+        fail(file.errorString());
+        return;
+    }
+    bytesWritten += size;
+    writeBuffer.clear();
+}
+
+void TelemetryRecorder::fail(const QString& reason) {
+    // Stop recording rather than leave a file with a torn chunk in the middle
+    Logger::getInstance().log(Logger::ERROR,
+        QString("Telemetry recording to %1 failed: %2").arg(file.fileName(), reason));
+    writeBuffer.clear();
+    chunkTicks.clear();
+    chunkTimes.clear();
+    file.close();
+}
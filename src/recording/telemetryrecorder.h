@@ -0,0 +1,65 @@
+#ifndef TELEMETRYRECORDER_H
+#define TELEMETRYRECORDER_H
+
+#include <QFile>
+#include <QString>
+#include <cstddef>
+#include <vector>
+#include "observer.h"
+#include "telemetryformat.h"
+
+// Observer that appends every tick's fleet state to a binary, column-chunked
+// recording (see telemetryformat.h). Ticks are gathered column by column in
+// memory and written a chunk at a time through a large staging buffer, so
+// recording costs a few memcpy calls per tick instead of formatted text.
+class TelemetryRecorder : public Observer {
+public:
+    static const int DEFAULT_TICKS_PER_CHUNK = 64;
+
+    explicit TelemetryRecorder(int maxTicksPerChunk = DEFAULT_TICKS_PER_CHUNK);
+    ~TelemetryRecorder() override;
+
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+    // Truncates the file and writes a fresh header; false if it cannot be opened
+    bool open(const QString& filename);
+    // Writes the partial chunk and closes the file
+    void close();
+    bool isOpen() const;
+
+    // Records the tick's snapshot; single-drone updates are ignored
+    void updateFleet(const FleetSnapshotPtr& snapshot) override;
+
+    // Appends one tick directly, e.g. from a fleet that is not published
+    void record(const FleetState& fleet);
+
+    quint64 getRecordedTicks() const;
+    quint64 getBytesWritten() const;
+
+private:
+    void writeIdTable(const FleetState& fleet);
+    void flushChunk();
+    void writeBytes(const void* data, std::size_t size);
+    void flushWriteBuffer();
+    void fail(const QString& reason);
+
+    QFile file;
+    int maxTicksPerChunk;
+    std::size_t chunkTickLimit;
+    std::size_t droneCount;
+    quint64 layoutVersion;
+    bool haveLayout;
+
+    // Ticks of the chunk being gathered, one vector per column
+    std::vector<quint64> chunkTicks;
+    std::vector<double> chunkTimes;
+    std::vector<double> chunkColumns[TelemetryFormat::DOUBLE_COLUMN_COUNT];
+    std::vector<quint8> chunkGpsStatus;
+
+    std::vector<char> writeBuffer;
+    quint64 recordedTicks;
+    quint64 bytesWritten;
+};
+
+#endif // TELEMETRYRECORDER_H
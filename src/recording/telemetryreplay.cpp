@@ -0,0 +1,270 @@
+#include "telemetryreplay.h"
+#include "telemetryformat.h"
+#include "fleetstate.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstring>
+
+TelemetryReplay::TelemetryReplay()
+    : mapped(nullptr)
+    , mappedSize(0)
+    , tickCount(0)
+    , loadedIdTable(-1)
+    , loadedLayoutVersion(0)
+{
+}
+
+TelemetryReplay::~TelemetryReplay() {
+    close();
+}
+
+bool TelemetryReplay::open(const QString& filename) {
+    close();
+
+    file.setFileName(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(file.errorString());
+    }
+    mappedSize = file.size();
+    if (mappedSize < qint64(sizeof(TelemetryFormat::FileHeader))) {
+        return fail("file is too small to be a telemetry recording");
+    }
+    mapped = file.map(0, mappedSize);
+    if (!mapped) {
+        return fail(file.errorString());
+    }
+
+    TelemetryFormat::FileHeader header;
+    std::memcpy(&header, mapped, sizeof(header));
+    if (std::memcmp(header.magic, TelemetryFormat::FILE_MAGIC, sizeof(header.magic)) != 0) {
+        return fail("not a telemetry recording");
+    }
+    if (header.version != TelemetryFormat::FORMAT_VERSION
+        || header.doubleColumnCount != TelemetryFormat::DOUBLE_COLUMN_COUNT) {
+        return fail(QString("unsupported recording version %1").arg(header.version));
+    }
+
+    if (!indexBlocks()) {
+        return false;
+    }
+
+    Logger::getInstance().log(Logger::INFO,
+        QString("Opened telemetry recording %1: %2 ticks in %3 chunks")
+        .arg(filename)
+        .arg(tickCount)
+        .arg(static_cast<qulonglong>(chunks.size())));
+    return true;
+}
+
+void TelemetryReplay::close() {
+    if (mapped) {
+        file.unmap(mapped);
+        mapped = nullptr;
+    }
+    file.close();
+    mappedSize = 0;
+    chunks.clear();
+    idTables.clear();
+    tickCount = 0;
+    loadedIdTable = -1;
+}
+
+bool TelemetryReplay::isOpen() const {
+    return mapped != nullptr;
+}
+
+QString TelemetryReplay::errorString() const {
+    return error;
+}
+
+quint64 TelemetryReplay::getTickCount() const {
+    return tickCount;
+}
+
+double TelemetryReplay::getStartTime() const {
+    return chunks.empty() ? 0.0 : chunks.front().firstTime;
+}
+
+double TelemetryReplay::getEndTime() const {
+    return chunks.empty() ? 0.0 : chunks.back().lastTime;
+}
+
+double TelemetryReplay::timeAt(quint64 position) const {
+    if (position >= tickCount) {
+        return getEndTime();
+    }
+    const ChunkEntry& chunk = chunks[chunkIndexFor(position)];
+    return chunkTimes(chunk)[position - chunk.firstPosition];
+}
+
+quint64 TelemetryReplay::seek(double time) const {
+    // First chunk that ends at or after `time`
+    auto chunk = std::lower_bound(chunks.begin(), chunks.end(), time,
+        [](const ChunkEntry& entry, double value) { return entry.lastTime < value; });
+    if (chunk == chunks.end()) {
+        return tickCount;
+    }
+
+    const double* times = chunkTimes(*chunk);
+    const double* first = std::lower_bound(times, times + chunk->tickCount, time);
+    return chunk->firstPosition + static_cast<quint64>(first - times);
+}
+
+bool TelemetryReplay::loadTick(quint64 position, FleetState& fleet) {
+    if (position >= tickCount) {
+        return false;
+    }
+
+    ChunkEntry& chunk = chunks[chunkIndexFor(position)];
+    const quint64 droneCount = chunk.droneCount;
+    const quint64 samples = quint64(chunk.tickCount) * droneCount;
+
+    if (!chunk.verified) {
+        const quint64 payloadBytes = chunk.tickCount * (sizeof(quint64) + sizeof(double))
+            + samples * TelemetryFormat::BYTES_PER_SAMPLE;
+        if (TelemetryFormat::crc32(chunk.payload, payloadBytes) != chunk.payloadCrc32) {
+            Logger::getInstance().log(Logger::ERROR,
+                QString("Telemetry recording %1: checksum mismatch in chunk at tick %2")
+                .arg(file.fileName())
+                .arg(position));
+            return false;
+        }
+        chunk.verified = true;
+    }
+
+    // Rebuild the drone list only when the recording's (or the caller's) layout moved
+    if (loadedIdTable != chunk.idTable || fleet.getLayoutVersion() != loadedLayoutVersion
+        || fleet.size() != droneCount) {
+        const std::vector<DroneId>& ids = idTables[chunk.idTable].ids;
+        fleet.clear();
+        fleet.addDrones(ids.data(), ids.size());
+        loadedIdTable = chunk.idTable;
+        loadedLayoutVersion = fleet.getLayoutVersion();
+    }
+
+    const quint64 tickInChunk = position - chunk.firstPosition;
+    const uchar* ticks = chunk.payload;
+    const uchar* columns = ticks + chunk.tickCount * (sizeof(quint64) + sizeof(double));
+    const std::size_t columnBytes = samples * sizeof(double);
+    const std::size_t rowOffset = tickInChunk * droneCount;
+
+    quint64 tick;
+    std::memcpy(&tick, ticks + tickInChunk * sizeof(quint64), sizeof(tick));
+    fleet.setClock(tick, chunkTimes(chunk)[tickInChunk]);
+
+    double* destinations[TelemetryFormat::DOUBLE_COLUMN_COUNT] = {
+        fleet.latitudes(), fleet.longitudes(), fleet.altitudes(),
+        fleet.headings(), fleet.speeds(), fleet.batteries()
+    };
+    for (int column = 0; column < TelemetryFormat::DOUBLE_COLUMN_COUNT; ++column) {
+        std::memcpy(destinations[column],
+                    columns + column * columnBytes + rowOffset * sizeof(double),
+                    droneCount * sizeof(double));
+    }
+
+    const uchar* gpsStatus = columns + TelemetryFormat::DOUBLE_COLUMN_COUNT * columnBytes + rowOffset;
+    GPSFixStatus* gpsOut = fleet.gpsStatuses();
+    for (quint64 i = 0; i < droneCount; ++i) {
+        gpsOut[i] = static_cast<GPSFixStatus>(gpsStatus[i]);
+    }
+    return true;
+}
+
+bool TelemetryReplay::indexBlocks() {
+    quint64 offset = sizeof(TelemetryFormat::FileHeader);
+    const quint64 end = static_cast<quint64>(mappedSize);
+
+    while (offset + sizeof(TelemetryFormat::BlockHeader) <= end) {
+        TelemetryFormat::BlockHeader header;
+        std::memcpy(&header, mapped + offset, sizeof(header));
+        const quint64 payloadOffset = offset + sizeof(header);
+        if (header.payloadBytes > end - payloadOffset) {
+            Logger::getInstance().log(Logger::WARNING,
+                QString("Telemetry recording %1 is truncated; replaying the first %2 ticks")
+                .arg(file.fileName())
+                .arg(tickCount));
+            break;
+        }
+        const uchar* payload = mapped + payloadOffset;
+
+        if (header.type == TelemetryFormat::ID_TABLE) {
+            if (!readIdTable(payload, header.payloadBytes, header.droneCount, header.payloadCrc32)) {
+                return false;
+            }
+        } else if (header.type == TelemetryFormat::TICK_CHUNK) {
+            const quint64 needed = header.tickCount * (sizeof(quint64) + sizeof(double))
+                + quint64(header.tickCount) * header.droneCount * TelemetryFormat::BYTES_PER_SAMPLE;
+            if (idTables.empty() || idTables.back().ids.size() != header.droneCount
+                || needed > header.payloadBytes) {
+                return fail(QString("malformed chunk at offset %1").arg(offset));
+            }
+            chunks.push_back({payload, tickCount, header.droneCount, header.tickCount,
+                              header.payloadCrc32, header.firstTime, header.lastTime,
+                              static_cast<int>(idTables.size()) - 1, false});
+            tickCount += header.tickCount;
+        }
+        // Unknown block types are skipped so newer writers stay readable
+
+        offset = payloadOffset + header.payloadBytes;
+    }
+    return true;
+}
+
+bool TelemetryReplay::readIdTable(const uchar* payload, quint64 payloadBytes,
+                                  quint64 droneCount, quint32 crc) {
+    // Every entry takes at least its length prefix, so a larger count is
+    // corrupt; checked before it sizes anything
+    if (droneCount > payloadBytes / sizeof(quint16)) {
+        return fail("malformed drone ID table");
+    }
+
+    std::vector<QString> names;
+    names.reserve(droneCount);
+
+    quint64 offset = 0;
+    for (quint64 i = 0; i < droneCount; ++i) {
+        quint16 length;
+        if (offset + sizeof(length) > payloadBytes) {
+            return fail("truncated drone ID table");
+        }
+        std::memcpy(&length, payload + offset, sizeof(length));
+        offset += sizeof(length);
+        if (offset + length > payloadBytes) {
+            return fail("truncated drone ID table");
+        }
+        names.push_back(QString::fromUtf8(reinterpret_cast<const char*>(payload + offset), length));
+        offset += length;
+    }
+
+    if (TelemetryFormat::crc32(payload, offset) != crc) {
+        return fail("checksum mismatch in drone ID table");
+    }
+
+    IdTable table;
+    table.ids.reserve(droneCount);
+    for (const QString& name : names) {
+        table.ids.push_back(DroneIdRegistry::getInstance().intern(name));
+    }
+    idTables.push_back(std::move(table));
+    return true;
+}
+
+std::size_t TelemetryReplay::chunkIndexFor(quint64 position) const {
+    // Last chunk starting at or before `position`
+    auto next = std::upper_bound(chunks.begin(), chunks.end(), position,
+        [](quint64 value, const ChunkEntry& entry) { return value < entry.firstPosition; });
+    return static_cast<std::size_t>(next - chunks.begin()) - 1;
+}
+
+const double* TelemetryReplay::chunkTimes(const ChunkEntry& chunk) const {
+    // Blocks are 8-byte aligned in an mmap'd (page-aligned) file
+    return reinterpret_cast<const double*>(chunk.payload + chunk.tickCount * sizeof(quint64));
+}
+
+bool TelemetryReplay::fail(const QString& reason) {
+    error = reason;
+    Logger::getInstance().log(Logger::ERROR,
+        QString("Cannot replay telemetry recording %1: %2").arg(file.fileName(), reason));
+    close();
+    return false;
+}
@@ -0,0 +1,82 @@
+#ifndef TELEMETRYREPLAY_H
+#define TELEMETRYREPLAY_H
+
+#include <QFile>
+#include <QString>
+#include <cstddef>
+#include <vector>
+#include "droneidregistry.h"
+
+class FleetState;
+
+// Random-access reader for telemetry recordings (see telemetryformat.h).
+// open() memory-maps the file and walks only the block headers to build a
+// sparse index with one entry per chunk; column data is read in place from
+// the mapping when a tick is loaded. Seeking by time is a binary search
+// over the chunks followed by one over the chunk's timestamps.
+class TelemetryReplay {
+public:
+    TelemetryReplay();
+    ~TelemetryReplay();
+
+    TelemetryReplay(const TelemetryReplay&) = delete;
+    TelemetryReplay& operator=(const TelemetryReplay&) = delete;
+
+    // A file cut short by a crash opens with every complete block before the cut
+    bool open(const QString& filename);
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+
+    // Recorded ticks are addressed by position 0 .. getTickCount() - 1
+    quint64 getTickCount() const;
+    double getStartTime() const;
+    double getEndTime() const;
+    double timeAt(quint64 position) const;
+
+    // Position of the first tick recorded at or after `time`; getTickCount() if none
+    quint64 seek(double time) const;
+
+    // Copies the tick at `position` into `fleet`, rebuilding the drone list
+    // when it differs. A chunk's checksum is verified the first time it is
+    // read; false if the position is out of range or the chunk is corrupt.
+    bool loadTick(quint64 position, FleetState& fleet);
+
+private:
+    struct ChunkEntry {
+        const uchar* payload;
+        quint64 firstPosition;
+        quint64 droneCount;
+        quint32 tickCount;
+        quint32 payloadCrc32;
+        double firstTime;
+        double lastTime;
+        int idTable;
+        bool verified;
+    };
+
+    // Names are interned once when the table is indexed
+    struct IdTable {
+        std::vector<DroneId> ids;
+    };
+
+    bool indexBlocks();
+    bool readIdTable(const uchar* payload, quint64 payloadBytes, quint64 droneCount, quint32 crc);
+    std::size_t chunkIndexFor(quint64 position) const;
+    const double* chunkTimes(const ChunkEntry& chunk) const;
+    bool fail(const QString& reason);
+
+    QFile file;
+    uchar* mapped;
+    qint64 mappedSize;
+    std::vector<ChunkEntry> chunks;
+    std::vector<IdTable> idTables;
+    quint64 tickCount;
+    QString error;
+
+    // ID table last written into a caller's fleet, and the layout it produced
+    int loadedIdTable;
+    quint64 loadedLayoutVersion;
+};
+
+#endif // TELEMETRYREPLAY_H
@@ -1,37 +1,65 @@
 #include "dronesimulator.h"
+#include "alertengine.h"
+#include "energymodel.h"
+#include "geofence.h"
 #include "movementstrategy.h"
+#include "simulationcheckpoint.h"
+#include "simulationfactory.h"
+#include "droneidregistry.h"
 #include "logger.h"
+#include "tickengine.h"
+#include <QElapsedTimer>
+#include <QMetaMethod>
 #include <QRandomGenerator>
+#include <QtMath>
 #include <algorithm>
+#include <cstring>
 
-DroneSimulator::DroneSimulator(QObject *parent)
+namespace {
+// Drones per work-stealing chunk: large enough to amortize the virtual call
+// and scheduling, small enough to balance across cores
+const std::size_t TICK_CHUNK_SIZE = 4096;
+}
+
+DroneSimulator::DroneSimulator(QObject *parent, LogMode logMode)
     : QObject(parent)
     , updateTimer(new QTimer(this))
+    , energyModel(SimulationFactory::createEnergyModel(SimulationFactory::PHYSICS_ENERGY))
+    , alertEngine(std::make_unique<AlertEngine>())
+    , geofence(std::make_shared<const Geofence>(Geofence::defaultZones()))
+    , tickEngine(std::make_unique<TickEngine>())
     , isSimulationRunning(false)
     , failureMode(false)
     , updateCount(0)
-    , batteryDrainRate(0.1)
+    , strategyRunsDirty(true)
+    , snapshotStale(true)
+    , spatialIndexStale(true)
+    , randomSeed(QRandomGenerator::global()->generate64())
+    , tickLogging(logMode == VERBOSE)
 {
+    alertEngine->setGeofence(geofence);
     initializeDrone();
 
-    // Set up timer for 500ms updates as required
-    updateTimer->setInterval(500);
+    // The timer only wakes the scheduler; simulated time advances in fixed
+    // steps of 1 / rate seconds (2 Hz by default, the original 500ms tick)
+    updateTimer->setTimerType(Qt::PreciseTimer);
+    updateTimer->setInterval(scheduler.timerIntervalMs());
     connect(updateTimer, &QTimer::timeout, this, &DroneSimulator::updateTelemetry);
 
-    Logger::getInstance().log(Logger::INFO, 
-        QString("DroneSimulator initialized for drone: %1").arg(droneData.getId()));
+    logConfiguration(Logger::INFO,
+        QString("DroneSimulator initialized for drone: %1").arg(fleet.nameAt(0)));
 }
 
 DroneSimulator::~DroneSimulator() {
     stopSimulation();
     observers.clear();
-    Logger::getInstance().log(Logger::INFO, "DroneSimulator destroyed");
+    logConfiguration(Logger::INFO, "DroneSimulator destroyed");
 }
 
 void DroneSimulator::attach(Observer* observer) {
     if (observer && std::find(observers.begin(), observers.end(), observer) == observers.end()) {
         observers.push_back(observer);
-        Logger::getInstance().log(Logger::DEBUG, "Observer attached to DroneSimulator");
+        LOG_DEBUG("Observer attached to DroneSimulator");
     }
 }
 
@@ -39,14 +67,20 @@ void DroneSimulator::detach(Observer* observer) {
     auto it = std::find(observers.begin(), observers.end(), observer);
     if (it != observers.end()) {
         observers.erase(it);
-        Logger::getInstance().log(Logger::DEBUG, "Observer detached from DroneSimulator");
+        LOG_DEBUG("Observer detached from DroneSimulator");
     }
 }
 
 void DroneSimulator::notify() {
+    if (observers.empty()) {
+        return;
+    }
+
+    // Every observer reads the same snapshot; nothing is copied per observer
+    const FleetSnapshotPtr snapshot = getSnapshot();
     for (Observer* observer : observers) {
         if (observer) {
-            observer->update(droneData);
+            observer->updateFleet(snapshot);
         }
     }
 }
@@ -54,9 +88,12 @@ void DroneSimulator::notify() {
 void DroneSimulator::startSimulation() {
     if (!isSimulationRunning) {
         isSimulationRunning = true;
+        scheduler.start();
         updateTimer->start();
         Logger::getInstance().log(Logger::INFO, "Drone simulation started");
-        emit telemetryUpdated(droneData);
+        if (!fleet.isEmpty()) {
+            emit telemetryUpdated(fleet.view(0));
+        }
     }
 }
 
@@ -69,37 +106,397 @@ void DroneSimulator::stopSimulation() {
 }
 
 void DroneSimulator::setMovementStrategy(std::unique_ptr<MovementStrategy> strategy) {
-    movementStrategy = std::move(strategy);
-    if (movementStrategy) {
-        Logger::getInstance().log(Logger::INFO, 
-            QString("Movement strategy changed to: %1").arg(movementStrategy->getStrategyName()));
+    // Replaces every strategy; the whole fleet moves under slot 0
+    movementStrategies.clear();
+    std::fill(strategySlots.begin(), strategySlots.end(), 0);
+    strategyRunsDirty = true;
+
+    if (strategy) {
+        logConfiguration(Logger::INFO,
+            QString("Movement strategy changed to: %1").arg(strategy->getStrategyName()));
+        movementStrategies.push_back(std::move(strategy));
+    }
+}
+
+int DroneSimulator::addMovementStrategy(std::unique_ptr<MovementStrategy> strategy) {
+    if (!strategy) {
+        return -1;
     }
+
+    logConfiguration(Logger::INFO,
+        QString("Movement strategy added: %1").arg(strategy->getStrategyName()));
+    movementStrategies.push_back(std::move(strategy));
+    return static_cast<int>(movementStrategies.size()) - 1;
+}
+
+void DroneSimulator::assignMovementStrategy(std::size_t begin, std::size_t end, int strategySlot) {
+    end = qMin(end, strategySlots.size());
+    for (std::size_t i = begin; i < end; ++i) {
+        strategySlots[i] = strategySlot;
+    }
+    strategyRunsDirty = true;
 }
 
 void DroneSimulator::setFailureMode(bool enabled) {
     failureMode = enabled;
-    Logger::getInstance().log(Logger::WARNING, 
+    logConfiguration(Logger::WARNING,
         QString("Failure mode %1").arg(enabled ? "ENABLED" : "DISABLED"));
 
-    if (enabled) {
-        // Drop GPS fix
-        droneData.setGPSStatus(GPSFixStatus::NO_FIX);
-        // Increase battery drain rate significantly
-        batteryDrainRate = 2.0;
-    } else {
-        // Restore GPS fix
-        droneData.setGPSStatus(GPSFixStatus::FIX_3D);
-        // Restore normal battery drain
-        batteryDrainRate = 0.1;
-    }
+    // Failure mode applies to the whole fleet: drop or restore GPS fix
+    GPSFixStatus status = enabled ? GPSFixStatus::NO_FIX : GPSFixStatus::FIX_3D;
+    std::fill(fleet.gpsStatuses(), fleet.gpsStatuses() + fleet.size(), status);
+    markFleetChanged();
 }
 
 bool DroneSimulator::isRunning() const {
     return isSimulationRunning;
 }
 
-const DroneData& DroneSimulator::getDroneData() const {
-    return droneData;
+void DroneSimulator::setEnergyModel(std::unique_ptr<EnergyModel> model) {
+    if (!model) {
+        return;
+    }
+    energyModel = std::move(model);
+    logConfiguration(Logger::INFO,
+        QString("Energy model set to %1").arg(energyModel->getModelName()));
+}
+
+const EnergyModel& DroneSimulator::getEnergyModel() const {
+    return *energyModel;
+}
+
+AlertEngine& DroneSimulator::getAlertEngine() {
+    return *alertEngine;
+}
+
+void DroneSimulator::setGeofence(std::shared_ptr<const Geofence> fence) {
+    geofence = fence ? std::move(fence) : std::make_shared<const Geofence>();
+    alertEngine->setGeofence(geofence);
+    logConfiguration(Logger::INFO,
+        QString("Geofence set: %1 zones, %2 edges, %3 grid cells")
+        .arg(static_cast<qulonglong>(geofence->getZones().size()))
+        .arg(static_cast<qulonglong>(geofence->getEdgeCount()))
+        .arg(static_cast<qulonglong>(geofence->getCellCount())));
+}
+
+const Geofence& DroneSimulator::getGeofence() const {
+    return *geofence;
+}
+
+bool DroneSimulator::loadGeofence(const QString& filename) {
+    std::vector<GeofenceZone> zones;
+    QString error;
+    if (!Geofence::loadZones(filename, zones, error)) {
+        LOG_ERROR(QString("Cannot load geofence %1: %2").arg(filename, error));
+        return false;
+    }
+    setGeofence(std::make_shared<const Geofence>(zones));
+    return true;
+}
+
+void DroneSimulator::setThreadCount(int count) {
+    tickEngine->setThreadCount(count);
+    logConfiguration(Logger::INFO,
+        QString("Tick engine using %1 threads").arg(tickEngine->threadCount()));
+}
+
+int DroneSimulator::getThreadCount() const {
+    return tickEngine->threadCount();
+}
+
+void DroneSimulator::setRandomSeed(quint64 seed) {
+    randomSeed = seed;
+    logConfiguration(Logger::INFO, QString("Random seed set to %1").arg(seed));
+}
+
+quint64 DroneSimulator::getRandomSeed() const {
+    return randomSeed;
+}
+
+void DroneSimulator::setTickLogging(bool enabled) {
+    tickLogging = enabled;
+}
+
+bool DroneSimulator::isTickLogging() const {
+    return tickLogging;
+}
+
+void DroneSimulator::logConfiguration(Logger::LogLevel level, const QString& message) const {
+    if (tickLogging) {
+        Logger::getInstance().log(level, message);
+    }
+}
+
+std::size_t DroneSimulator::addDrone(const DroneData& data, int strategySlot) {
+    std::size_t index = fleet.addDrone(data);
+    strategySlots.push_back(strategySlot);
+    strategyRunsDirty = true;
+    markFleetChanged();
+    if (failureMode) {
+        fleet.gpsStatuses()[index] = GPSFixStatus::NO_FIX;
+    }
+    return index;
+}
+
+void DroneSimulator::setFleetSize(std::size_t count) {
+    if (count <= fleet.size()) {
+        fleet.truncate(count);
+        strategySlots.resize(count);
+        strategyRunsDirty = true;
+        markFleetChanged();
+    } else {
+        // One registry lock and one layout change for the whole batch
+        const std::size_t first = fleet.size();
+        std::vector<QString> names;
+        names.reserve(count - first);
+        for (std::size_t i = first; i < count; ++i) {
+            names.push_back(droneIdForIndex(i));
+        }
+        const std::vector<DroneId> ids = DroneIdRegistry::getInstance().intern(names);
+        fleet.addDrones(ids.data(), ids.size());
+
+        // Lay new drones out on a square grid (~55 m spacing) around the home position
+        const std::size_t columns = static_cast<std::size_t>(qCeil(qSqrt(static_cast<double>(count))));
+        double* latitude = fleet.latitudes();
+        double* longitude = fleet.longitudes();
+        for (std::size_t i = first; i < count; ++i) {
+            latitude[i] = 28.4595 + static_cast<double>(i / columns) * 0.0005;
+            longitude[i] = 77.0266 + static_cast<double>(i % columns) * 0.0005;
+        }
+        std::fill(fleet.altitudes() + first, fleet.altitudes() + count, 100.0);
+        std::fill(fleet.headings() + first, fleet.headings() + count, 0.0);
+        std::fill(fleet.speeds() + first, fleet.speeds() + count, 0.0);
+        std::fill(fleet.batteries() + first, fleet.batteries() + count, 100.0);
+        std::fill(fleet.gpsStatuses() + first, fleet.gpsStatuses() + count,
+                  failureMode ? GPSFixStatus::NO_FIX : GPSFixStatus::FIX_3D);
+
+        strategySlots.resize(count, 0);
+        strategyRunsDirty = true;
+        markFleetChanged();
+    }
+
+    logConfiguration(Logger::INFO,
+        QString("Fleet size set to %1 drones").arg(static_cast<qulonglong>(fleet.size())));
+}
+
+std::size_t DroneSimulator::droneCount() const {
+    return fleet.size();
+}
+
+DroneData DroneSimulator::getDroneData(std::size_t index) const {
+    return fleet.view(index);
+}
+
+const FleetState& DroneSimulator::getFleet() const {
+    return fleet;
+}
+
+FleetSnapshotPtr DroneSimulator::getSnapshot() const {
+    if (snapshotStale || !latestSnapshot) {
+        latestSnapshot = snapshotPool.capture(fleet);
+        snapshotStale = false;
+    }
+    return latestSnapshot;
+}
+
+const SpatialGrid& DroneSimulator::getSpatialIndex() const {
+    if (spatialIndexStale) {
+        spatialIndex.rebuild(fleet);
+        spatialIndexStale = false;
+    }
+    return spatialIndex;
+}
+
+void DroneSimulator::publishFleet(const FleetState& state) {
+    // Drones arriving this way move under slot 0 if simulation resumes
+    if (state.getLayoutVersion() != fleet.getLayoutVersion()) {
+        strategySlots.assign(state.size(), 0);
+        strategyRunsDirty = true;
+    }
+    fleet.assignFrom(state);
+    publishTick();
+}
+
+bool DroneSimulator::saveCheckpoint(const QString& filename) const {
+    QElapsedTimer timer;
+    timer.start();
+
+    CheckpointWriter writer;
+    if (!writer.open(filename)) {
+        LOG_ERROR(QString("Cannot write checkpoint %1: %2").arg(filename, writer.errorString()));
+        return false;
+    }
+
+    writer.write(updateCount);
+    writer.write(fleet.getSimulationTime());
+    writer.write(scheduler.rate());
+    writer.write(randomSeed);
+    writer.write(static_cast<quint8>(failureMode));
+
+    // IDs are process-local, so drones are stored by name (as in recordings)
+    QByteArray names;
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        const QByteArray name = fleet.nameAt(i).toUtf8().left(0xFFFF);
+        const quint16 length = static_cast<quint16>(name.size());
+        names.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        names.append(name);
+    }
+    writer.writeArray(names.constData(), static_cast<std::size_t>(names.size()));
+
+    writer.writeArray(fleet.latitudes(), fleet.size());
+    writer.writeArray(fleet.longitudes(), fleet.size());
+    writer.writeArray(fleet.altitudes(), fleet.size());
+    writer.writeArray(fleet.headings(), fleet.size());
+    writer.writeArray(fleet.speeds(), fleet.size());
+    writer.writeArray(fleet.batteries(), fleet.size());
+    writer.writeArray(fleet.gpsStatuses(), fleet.size());
+    writer.writeArray(strategySlots);
+
+    for (const std::unique_ptr<MovementStrategy>& strategy : movementStrategies) {
+        writer.writeString(strategy->getStrategyName());
+        strategy->saveState(writer);
+    }
+    writer.writeString(energyModel->getModelName());
+    energyModel->saveState(writer);
+
+    if (!writer.finish(fleet.size(), static_cast<quint32>(movementStrategies.size()))) {
+        LOG_ERROR(QString("Cannot write checkpoint %1: %2").arg(filename, writer.errorString()));
+        return false;
+    }
+
+    Logger::getInstance().log(Logger::INFO,
+        QString("Checkpoint saved to %1 at tick %2: %3 drones in %4 ms")
+        .arg(filename)
+        .arg(updateCount)
+        .arg(static_cast<qulonglong>(fleet.size()))
+        .arg(timer.elapsed()));
+    return true;
+}
+
+bool DroneSimulator::restoreCheckpoint(const QString& filename) {
+    QElapsedTimer timer;
+    timer.start();
+
+    CheckpointReader reader;
+    auto fail = [&filename, &reader](const QString& reason) {
+        LOG_ERROR(QString("Cannot restore checkpoint %1: %2")
+                  .arg(filename, reason.isEmpty() ? reader.errorString() : reason));
+        return false;
+    };
+    if (!reader.open(filename)) {
+        return fail(QString());
+    }
+
+    // Everything is decoded into temporaries first; a bad checkpoint
+    // leaves the running simulation untouched
+    const std::size_t count = reader.header().droneCount;
+    quint64 restoredTick = 0;
+    double restoredTime = 0.0;
+    double restoredRate = 0.0;
+    quint64 restoredSeed = 0;
+    quint8 restoredFailureMode = 0;
+    quint64 nameBytes = 0;
+    if (!reader.read(restoredTick) || !reader.read(restoredTime) || !reader.read(restoredRate)
+        || !reader.read(restoredSeed)
+        || !reader.read(restoredFailureMode) || !reader.read(nameBytes)) {
+        return fail(QString());
+    }
+
+    const char* names = reader.take(nameBytes);
+    if (!names) {
+        return fail(QString());
+    }
+    // Each name takes at least its length prefix; checked before sizing anything
+    if (count > nameBytes / sizeof(quint16)) {
+        return fail("name table is truncated");
+    }
+    std::vector<QString> droneNames;
+    droneNames.reserve(count);
+    const char* namesEnd = names + nameBytes;
+    for (std::size_t i = 0; i < count; ++i) {
+        quint16 length = 0;
+        if (namesEnd - names < qptrdiff(sizeof(length))) {
+            return fail("name table is truncated");
+        }
+        std::memcpy(&length, names, sizeof(length));
+        names += sizeof(length);
+        if (namesEnd - names < length) {
+            return fail("name table is truncated");
+        }
+        droneNames.push_back(QString::fromUtf8(names, length));
+        names += length;
+    }
+    const std::vector<DroneId> ids = DroneIdRegistry::getInstance().intern(droneNames);
+    FleetState restored;
+    restored.addDrones(ids.data(), ids.size());
+
+    std::vector<int> restoredSlots;
+    if (!reader.readArray(restored.latitudes(), count)
+        || !reader.readArray(restored.longitudes(), count)
+        || !reader.readArray(restored.altitudes(), count)
+        || !reader.readArray(restored.headings(), count)
+        || !reader.readArray(restored.speeds(), count)
+        || !reader.readArray(restored.batteries(), count)
+        || !reader.readArray(restored.gpsStatuses(), count)
+        || !reader.readArray(restoredSlots)) {
+        return fail(QString());
+    }
+    if (restoredSlots.size() != count) {
+        return fail("strategy assignment does not match the fleet");
+    }
+
+    std::vector<std::unique_ptr<MovementStrategy>> restoredStrategies;
+    for (quint32 i = 0; i < reader.header().strategyCount; ++i) {
+        QString name;
+        if (!reader.readString(name)) {
+            return fail(QString());
+        }
+        std::unique_ptr<MovementStrategy> strategy = SimulationFactory::createMovementStrategy(name);
+        if (!strategy) {
+            return fail(QString("unknown movement strategy %1").arg(name));
+        }
+        if (!strategy->restoreState(reader)) {
+            return fail(QString("invalid state for movement strategy %1").arg(name));
+        }
+        restoredStrategies.push_back(std::move(strategy));
+    }
+
+    QString energyModelName;
+    if (!reader.readString(energyModelName)) {
+        return fail(QString());
+    }
+    std::unique_ptr<EnergyModel> restoredEnergyModel = SimulationFactory::createEnergyModel(energyModelName);
+    if (!restoredEnergyModel) {
+        return fail(QString("unknown energy model %1").arg(energyModelName));
+    }
+    if (!restoredEnergyModel->restoreState(reader)) {
+        return fail(QString("invalid state for energy model %1").arg(energyModelName));
+    }
+    if (!reader.atEnd()) {
+        return fail("unexpected data after the energy model");
+    }
+
+    fleet = std::move(restored);
+    fleet.setClock(restoredTick, restoredTime);
+    strategySlots = std::move(restoredSlots);
+    movementStrategies = std::move(restoredStrategies);
+    energyModel = std::move(restoredEnergyModel);
+    strategyRunsDirty = true;
+    updateCount = restoredTick;
+    randomSeed = restoredSeed;
+    failureMode = restoredFailureMode != 0;
+    scheduler.setRate(restoredRate);
+    updateTimer->setInterval(scheduler.timerIntervalMs());
+
+    Logger::getInstance().log(Logger::INFO,
+        QString("Checkpoint restored from %1 at tick %2: %3 drones in %4 ms")
+        .arg(filename)
+        .arg(updateCount)
+        .arg(static_cast<qulonglong>(fleet.size()))
+        .arg(timer.elapsed()));
+
+    publishTick();
+    return true;
 }
 
 void DroneSimulator::updateTelemetry() {
@@ -107,52 +504,170 @@ void DroneSimulator::updateTelemetry() {
         return;
     }
 
+    // Run every step that fell due since the last wake-up, so late timeouts
+    // are caught up instead of silently stretching simulated time
+    const quint64 droppedBefore = scheduler.droppedSteps();
+    const int steps = scheduler.stepsDue();
+    for (int i = 0; i < steps && isSimulationRunning; ++i) {
+        advanceTick();
+    }
+
+    if (scheduler.droppedSteps() != droppedBefore) {
+        Logger::getInstance().log(Logger::WARNING,
+            QString("Simulation fell behind real time, dropped %1 ticks")
+            .arg(scheduler.droppedSteps() - droppedBefore));
+    }
+}
+
+void DroneSimulator::runTicks(quint64 count) {
+    // Steps back to back without the timer, e.g. for headless batch runs
+    for (quint64 i = 0; i < count; ++i) {
+        advanceTick();
+    }
+}
+
+quint64 DroneSimulator::getUpdateCount() const {
+    return updateCount;
+}
+
+void DroneSimulator::setTickRate(double rateHz) {
+    scheduler.setRate(rateHz);
+    updateTimer->setInterval(scheduler.timerIntervalMs());
+    logConfiguration(Logger::INFO,
+        QString("Tick rate set to %1 Hz").arg(scheduler.rate()));
+}
+
+double DroneSimulator::getTickRate() const {
+    return scheduler.rate();
+}
+
+double DroneSimulator::getSimulationTime() const {
+    return fleet.getSimulationTime();
+}
+
+quint64 DroneSimulator::getDroppedTicks() const {
+    return scheduler.droppedSteps();
+}
+
+void DroneSimulator::advanceTick() {
     updateCount++;
+    const double dt = scheduler.stepSeconds();
+    fleet.setClock(updateCount, fleet.getSimulationTime() + dt);
 
-    // Apply movement strategy if available
-    applyMovementStrategy();
+    // Movement and battery run chunk by chunk across the tick engine; strategies
+    // that cannot run concurrently are advanced first on this thread
+    const TickContext context{updateCount, randomSeed, dt, geofence.get()};
+    const EnergyContext energyContext{updateCount, randomSeed, dt, failureMode};
+    prepareMovementStrategies(context);
+    energyModel->prepare(fleet, energyContext);
+    tickEngine->parallelFor(fleet.size(), TICK_CHUNK_SIZE,
+        [this, &context, &energyContext](std::size_t begin, std::size_t end) {
+            applyMovementStrategy(begin, end, context);
+            energyModel->updateBatteries(fleet, begin, end, energyContext);
+        });
 
-    // Update battery
-    updateBattery();
+    if (fleet.isEmpty()) {
+        return;
+    }
 
-    // Emit signal and notify observers
-    emit telemetryUpdated(droneData);
-    notify();
+    publishTick();
 
-    // Log every 5th update to avoid spam
-    if (updateCount % 5 == 0) {
-        Logger::getInstance().log(Logger::INFO,
-            QString("Telemetry updated - Lat: %1, Lon: %2, Battery: %3%")
-            .arg(droneData.getLatitude(), 0, 'f', 6)
-            .arg(droneData.getLongitude(), 0, 'f', 6)
-            .arg(droneData.getBattery(), 0, 'f', 1));
+    // Log every 2.5 simulated seconds (every 5th tick at 2 Hz) to avoid spam
+    const quint64 logEvery = static_cast<quint64>(qMax(1, qRound(2.5 * scheduler.rate())));
+    if (tickLogging && updateCount % logEvery == 0) {
+        LOG_INFO(QString("Telemetry updated - Lat: %1, Lon: %2, Battery: %3% (%4 drones)")
+                 .arg(fleet.latitudes()[0], 0, 'f', 6)
+                 .arg(fleet.longitudes()[0], 0, 'f', 6)
+                 .arg(fleet.batteries()[0], 0, 'f', 1)
+                 .arg(static_cast<qulonglong>(fleet.size())));
     }
 }
 
+void DroneSimulator::markFleetChanged() {
+    snapshotStale = true;
+    spatialIndexStale = true;
+}
+
+void DroneSimulator::publishTick() {
+    markFleetChanged();
+    if (fleet.isEmpty()) {
+        return;
+    }
+
+    // Emit signal for the primary drone and notify observers. The tick's
+    // snapshot is only captured when a receiver or observer will read it.
+    emit telemetryUpdated(fleet.view(0));
+    static const QMetaMethod fleetUpdatedSignal = QMetaMethod::fromSignal(&DroneSimulator::fleetUpdated);
+    if (isSignalConnected(fleetUpdatedSignal)) {
+        emit fleetUpdated(getSnapshot());
+    }
+
+    // Every published state is checked, including replays and received telemetry
+    alertEngine->evaluate(fleet);
+    alertEngine->notify();
+    notify();
+}
+
 void DroneSimulator::initializeDrone() {
-    droneData = DroneData("DRONE-001", 28.4595, 77.0266, 100.0, 0.0, 0.0, 100.0, GPSFixStatus::FIX_3D);
+    fleet.clear();
+    strategySlots.clear();
+    addDrone(DroneData(droneIdForIndex(0), 28.4595, 77.0266, 100.0, 0.0, 0.0, 100.0, GPSFixStatus::FIX_3D));
 }
 
-void DroneSimulator::updateBattery() {
-    double currentBattery = droneData.getBattery();
+QString DroneSimulator::droneIdForIndex(std::size_t index) {
+    return QString("DRONE-%1").arg(static_cast<qulonglong>(index + 1), 3, 10, QLatin1Char('0'));
+}
 
-    if (currentBattery > 0) {
-        double newBattery = currentBattery - batteryDrainRate;
-        newBattery = qMax(0.0, newBattery);
-        droneData.setBattery(newBattery);
+void DroneSimulator::prepareMovementStrategies(const TickContext& context) {
+    if (strategyRunsDirty) {
+        rebuildStrategyRuns();
+    }
 
-        // Log warning when battery gets low
-        if (newBattery <= 20.0 && currentBattery > 20.0) {
-            Logger::getInstance().log(Logger::WARNING, "Drone battery is low (20%)");
+    for (const std::unique_ptr<MovementStrategy>& strategy : movementStrategies) {
+        if (strategy) {
+            strategy->prepare(fleet, context);
         }
-        if (newBattery <= 5.0 && currentBattery > 5.0) {
-            Logger::getInstance().log(Logger::ERROR, "Drone battery is critically low (5%)");
+    }
+
+    for (const StrategyRun& run : strategyRuns) {
+        MovementStrategy* strategy = movementStrategies[run.slot].get();
+        if (!strategy->supportsParallelUpdates()) {
+            strategy->updatePositions(fleet, run.begin, run.end, context);
         }
     }
 }
 
-void DroneSimulator::applyMovementStrategy() {
-    if (movementStrategy) {
-        movementStrategy->updatePosition(droneData);
+void DroneSimulator::applyMovementStrategy(std::size_t begin, std::size_t end, const TickContext& context) {
+    // First run that ends inside or after this chunk
+    auto run = std::upper_bound(strategyRuns.begin(), strategyRuns.end(), begin,
+        [](std::size_t index, const StrategyRun& candidate) { return index < candidate.end; });
+
+    // One virtual call per run of drones sharing a strategy within the chunk
+    for (; run != strategyRuns.end() && run->begin < end; ++run) {
+        MovementStrategy* strategy = movementStrategies[run->slot].get();
+        if (strategy->supportsParallelUpdates()) {
+            strategy->updatePositions(fleet, qMax(begin, run->begin), qMin(end, run->end), context);
+        }
     }
 }
+
+void DroneSimulator::rebuildStrategyRuns() {
+    strategyRuns.clear();
+
+    const int strategyCount = static_cast<int>(movementStrategies.size());
+    std::size_t begin = 0;
+    while (begin < strategySlots.size()) {
+        int slot = strategySlots[begin];
+        std::size_t end = begin + 1;
+        while (end < strategySlots.size() && strategySlots[end] == slot) {
+            ++end;
+        }
+        // Drones pointing at a missing strategy simply do not move
+        if (slot >= 0 && slot < strategyCount && movementStrategies[slot]) {
+            strategyRuns.push_back({slot, begin, end});
+        }
+        begin = end;
+    }
+
+    strategyRunsDirty = false;
+}
@@ -5,16 +5,35 @@
 #include <QTimer>
 #include <memory>
 #include <vector>
+#include <cstddef>
 #include "dronedata.h"
+#include "fleetstate.h"
+#include "fleetsnapshot.h"
+#include "spatialgrid.h"
 #include "observer.h"
+#include "tickscheduler.h"
+#include "logger.h"
 
+class AlertEngine;
+class EnergyModel;
+class Geofence;
 class MovementStrategy;
+class TickEngine;
+struct EnergyContext;
+struct TickContext;
 
 class DroneSimulator : public QObject, public Subject {
     Q_OBJECT
 
 public:
-    explicit DroneSimulator(QObject *parent = nullptr);
+    // QUIET starts with routine logging off (see setTickLogging()), so not
+    // even construction and destruction are logged
+    enum LogMode {
+        VERBOSE = 0,
+        QUIET = 1
+    };
+
+    explicit DroneSimulator(QObject *parent = nullptr, LogMode logMode = VERBOSE);
     virtual ~DroneSimulator();
 
     // Observer pattern methods
@@ -26,32 +45,132 @@ public:
     void startSimulation();
     void stopSimulation();
     void setMovementStrategy(std::unique_ptr<MovementStrategy> strategy);
+    int addMovementStrategy(std::unique_ptr<MovementStrategy> strategy);
+    void assignMovementStrategy(std::size_t begin, std::size_t end, int strategySlot);
     void setFailureMode(bool enabled);
     bool isRunning() const;
 
+    // How batteries drain (physics-based by default)
+    void setEnergyModel(std::unique_ptr<EnergyModel> model);
+    const EnergyModel& getEnergyModel() const;
+
+    // Rules evaluated on every published tick (the default battery and GPS
+    // rules until replaced); attach to it to receive the alert transitions
+    AlertEngine& getAlertEngine();
+
+    // Inclusion and exclusion zones (the built-in operating area until
+    // replaced; null removes every zone). Strategies keep drones from
+    // breaching them and the alert engine's geofence rules report breaches.
+    // The geofence is configuration, not part of checkpoints.
+    void setGeofence(std::shared_ptr<const Geofence> fence);
+    const Geofence& getGeofence() const;
+    // Replaces the zones with the file's; keeps the current ones on failure
+    bool loadGeofence(const QString& filename);
+
+    // Advance `count` ticks immediately, independent of the update timer
+    void runTicks(quint64 count);
+    quint64 getUpdateCount() const;
+
+    // Fixed simulation step rate in Hz (2 Hz to 1 kHz); each tick covers 1 / rate seconds
+    void setTickRate(double rateHz);
+    double getTickRate() const;
+    double getSimulationTime() const;
+    quint64 getDroppedTicks() const;
+
+    // Movement and battery updates are spread over this many threads (0 = all cores)
+    void setThreadCount(int count);
+    int getThreadCount() const;
+
+    // Random draws are keyed by (seed, drone, tick); equal seeds replay exactly
+    void setRandomSeed(quint64 seed);
+    quint64 getRandomSeed() const;
+
+    // Routine INFO lines (default on): periodic telemetry and configuration
+    // changes such as strategy, rate, seed or fleet size. Ensemble members
+    // turn them off so thousands of runs do not flood the log; errors and
+    // alerts are still logged.
+    void setTickLogging(bool enabled);
+    bool isTickLogging() const;
+
+    // Fleet management
+    std::size_t addDrone(const DroneData& data, int strategySlot = 0);
+    void setFleetSize(std::size_t count);
+    std::size_t droneCount() const;
+
     // Data access
-    const DroneData& getDroneData() const;
+    DroneData getDroneData(std::size_t index = 0) const;
+    const FleetState& getFleet() const;
+
+    // Immutable snapshot of the current fleet; the tick's published snapshot
+    // is reused until the fleet changes again
+    FleetSnapshotPtr getSnapshot() const;
+
+    // Proximity index over the current positions, rebuilt on first use
+    // after each tick (fleets nobody queries never pay for it)
+    const SpatialGrid& getSpatialIndex() const;
+
+    // Replaces the fleet with externally produced telemetry (e.g. a replayed
+    // recording) and publishes it to the signal and observers like a tick
+    void publishFleet(const FleetState& state);
+
+    // Versioned binary checkpoint of everything that determines future ticks:
+    // fleet, clock, seed, failure mode and the internal state of each
+    // strategy and of the energy model. A restored simulator continues
+    // bit-identically to the one that saved, so long runs can be forked;
+    // the restore is published like a tick.
+    bool saveCheckpoint(const QString& filename) const;
+    bool restoreCheckpoint(const QString& filename);
 
 public slots:
     void updateTelemetry();
 
 signals:
     void telemetryUpdated(const DroneData& data);
+    // Once per tick; receivers share the snapshot and may keep it
+    void fleetUpdated(const FleetSnapshotPtr& snapshot);
 
 private:
     void initializeDrone();
-    void updateBattery();
-    void applyMovementStrategy();
+    void advanceTick();
+    void publishTick();
+    void markFleetChanged();
+    // Logs a routine configuration line unless tick logging is off
+    void logConfiguration(Logger::LogLevel level, const QString& message) const;
+    static QString droneIdForIndex(std::size_t index);
+    void applyMovementStrategy(std::size_t begin, std::size_t end, const TickContext& context);
+    void prepareMovementStrategies(const TickContext& context);
+    void rebuildStrategyRuns();
+
+    // Contiguous range of drones sharing one movement strategy
+    struct StrategyRun {
+        int slot;
+        std::size_t begin;
+        std::size_t end;
+    };
 
-    DroneData droneData;
+    FleetState fleet;
+    mutable FleetSnapshotPool snapshotPool;
+    mutable FleetSnapshotPtr latestSnapshot;
+    mutable SpatialGrid spatialIndex;
     QTimer* updateTimer;
-    std::unique_ptr<MovementStrategy> movementStrategy;
+    std::vector<std::unique_ptr<MovementStrategy>> movementStrategies;
+    std::unique_ptr<EnergyModel> energyModel;
+    std::unique_ptr<AlertEngine> alertEngine;
+    std::shared_ptr<const Geofence> geofence;
+    std::vector<int> strategySlots;  // per drone, index into movementStrategies
+    std::vector<StrategyRun> strategyRuns;
     std::vector<Observer*> observers;
+    std::unique_ptr<TickEngine> tickEngine;
+    TickScheduler scheduler;
 
     bool isSimulationRunning;
     bool failureMode;
-    int updateCount;
-    double batteryDrainRate;
+    quint64 updateCount;
+    bool strategyRunsDirty;
+    mutable bool snapshotStale;
+    mutable bool spatialIndexStale;
+    quint64 randomSeed;
+    bool tickLogging;
 };
 
 #endif // DRONESIMULATOR_H
\ No newline at end of file
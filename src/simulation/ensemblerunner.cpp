@@ -0,0 +1,304 @@
+#include "ensemblerunner.h"
+#include "alertengine.h"
+#include "dronesimulator.h"
+#include "energymodel.h"
+#include "movementstrategy.h"
+#include "philoxrng.h"
+#include "logger.h"
+#include <QThread>
+#include <QtMath>
+#include <thread>
+
+namespace {
+const double EARTH_RADIUS_METERS = 6371000.0;
+const double METERS_PER_DEGREE_LATITUDE = EARTH_RADIUS_METERS * M_PI / 180.0;
+
+// Time-to-low-battery histogram resolution over the run duration
+const int LOW_BATTERY_BINS = 60;
+}
+
+EnsembleStatistics::EnsembleStatistics(double lowBatteryBinSeconds, int lowBatteryBins,
+                                       double displacementBinMeters, int displacementBins)
+    : lowBatteryBinSeconds(qMax(1e-9, lowBatteryBinSeconds))
+    , displacementBinMeters(qMax(1e-9, displacementBinMeters))
+    , lowBatteryHistogram(qMax(1, lowBatteryBins), 0)
+    , displacementHistogram(qMax(1, displacementBins), 0)
+    , completedRuns(0)
+    , droneSamples(0)
+    , neverLow(0)
+    , displacementSum(0.0)
+    , maxDisplacement(0.0)
+    , finalBatterySum(0.0)
+    , finalLatitudeSum(0.0)
+    , finalLongitudeSum(0.0)
+{
+}
+
+void EnsembleStatistics::merge(const EnsembleStatistics& other) {
+    for (std::size_t i = 0; i < lowBatteryHistogram.size() && i < other.lowBatteryHistogram.size(); ++i) {
+        lowBatteryHistogram[i] += other.lowBatteryHistogram[i];
+    }
+    for (std::size_t i = 0; i < displacementHistogram.size() && i < other.displacementHistogram.size(); ++i) {
+        displacementHistogram[i] += other.displacementHistogram[i];
+    }
+    completedRuns += other.completedRuns;
+    droneSamples += other.droneSamples;
+    neverLow += other.neverLow;
+    displacementSum += other.displacementSum;
+    maxDisplacement = qMax(maxDisplacement, other.maxDisplacement);
+    finalBatterySum += other.finalBatterySum;
+    finalLatitudeSum += other.finalLatitudeSum;
+    finalLongitudeSum += other.finalLongitudeSum;
+}
+
+double EnsembleStatistics::fractionLowBefore(double seconds) const {
+    if (droneSamples == 0) {
+        return 0.0;
+    }
+    const std::size_t bins = qMin(lowBatteryHistogram.size(),
+                                  static_cast<std::size_t>(qMax(0.0, seconds / lowBatteryBinSeconds + 1e-9)));
+    quint64 low = 0;
+    for (std::size_t i = 0; i < bins; ++i) {
+        low += lowBatteryHistogram[i];
+    }
+    return static_cast<double>(low) / droneSamples;
+}
+
+double EnsembleStatistics::meanDisplacementMeters() const {
+    return droneSamples ? displacementSum / droneSamples : 0.0;
+}
+
+double EnsembleStatistics::meanFinalBattery() const {
+    return droneSamples ? finalBatterySum / droneSamples : 0.0;
+}
+
+double EnsembleStatistics::meanFinalLatitude() const {
+    return droneSamples ? finalLatitudeSum / droneSamples : 0.0;
+}
+
+double EnsembleStatistics::meanFinalLongitude() const {
+    return droneSamples ? finalLongitudeSum / droneSamples : 0.0;
+}
+
+void EnsembleStatistics::addLowBattery(double seconds) {
+    const std::size_t bin = static_cast<std::size_t>(qMax(0.0, seconds / lowBatteryBinSeconds));
+    ++lowBatteryHistogram[qMin(bin, lowBatteryHistogram.size() - 1)];
+}
+
+void EnsembleStatistics::addFinalState(double displacementMeters, double battery,
+                                       double latitude, double longitude) {
+    const std::size_t bin = static_cast<std::size_t>(displacementMeters / displacementBinMeters);
+    ++displacementHistogram[qMin(bin, displacementHistogram.size() - 1)];
+    ++droneSamples;
+    displacementSum += displacementMeters;
+    maxDisplacement = qMax(maxDisplacement, displacementMeters);
+    finalBatterySum += battery;
+    finalLatitudeSum += latitude;
+    finalLongitudeSum += longitude;
+}
+
+EnsembleRunner::EnsembleRunner()
+    : runCount(100)
+    , dronesPerRun(1)
+    , duration(1800.0)
+    , tickRate(TickScheduler::MIN_RATE_HZ)
+    , movementType(SimulationFactory::RANDOM_WALK_MOVEMENT)
+    , energyModelType(SimulationFactory::PHYSICS_ENERGY)
+    , failureMode(false)
+    , baseSeed(0)
+    , lowBatteryThreshold(20.0)
+    , threadCount(0)
+    , progressInterval(0)
+    , nextRun(0)
+    , cancelled(false)
+{
+}
+
+void EnsembleRunner::setRunCount(quint64 count) {
+    runCount = count;
+}
+
+quint64 EnsembleRunner::getRunCount() const {
+    return runCount;
+}
+
+void EnsembleRunner::setDronesPerRun(std::size_t count) {
+    dronesPerRun = qMax<std::size_t>(1, count);
+}
+
+std::size_t EnsembleRunner::getDronesPerRun() const {
+    return dronesPerRun;
+}
+
+void EnsembleRunner::setDuration(double seconds) {
+    duration = qMax(0.0, seconds);
+}
+
+double EnsembleRunner::getDuration() const {
+    return duration;
+}
+
+void EnsembleRunner::setTickRate(double rateHz) {
+    tickRate = qBound(TickScheduler::MIN_RATE_HZ, rateHz, TickScheduler::MAX_RATE_HZ);
+}
+
+double EnsembleRunner::getTickRate() const {
+    return tickRate;
+}
+
+void EnsembleRunner::setMovementType(SimulationFactory::MovementType type) {
+    movementType = type;
+}
+
+void EnsembleRunner::setEnergyModelType(SimulationFactory::EnergyModelType type) {
+    energyModelType = type;
+}
+
+void EnsembleRunner::setFailureMode(bool enabled) {
+    failureMode = enabled;
+}
+
+void EnsembleRunner::setBaseSeed(quint64 seed) {
+    baseSeed = seed;
+}
+
+quint64 EnsembleRunner::getBaseSeed() const {
+    return baseSeed;
+}
+
+void EnsembleRunner::setLowBatteryThreshold(double percent) {
+    lowBatteryThreshold = percent;
+}
+
+double EnsembleRunner::getLowBatteryThreshold() const {
+    return lowBatteryThreshold;
+}
+
+void EnsembleRunner::setThreadCount(int count) {
+    threadCount = qMax(0, count);
+}
+
+int EnsembleRunner::getThreadCount() const {
+    return threadCount > 0 ? threadCount : qMax(1, QThread::idealThreadCount());
+}
+
+void EnsembleRunner::setProgressCallback(const ProgressCallback& callback, quint64 interval) {
+    progressCallback = callback;
+    progressInterval = interval;
+}
+
+quint64 EnsembleRunner::seedForRun(quint64 run) const {
+    return PhiloxRng(baseSeed, PhiloxRng::ENSEMBLE).bits(run, 0, 0);
+}
+
+EnsembleStatistics EnsembleRunner::run() {
+    EnsembleStatistics shared = makeStatistics();
+    nextRun = 0;
+    cancelled = false;
+
+    const int workers = static_cast<int>(qMin<quint64>(getThreadCount(), qMax<quint64>(1, runCount)));
+    LOG_INFO(QString("Ensemble starting: %1 runs of %2 drones for %3 s on %4 threads")
+             .arg(runCount)
+             .arg(static_cast<qulonglong>(dronesPerRun))
+             .arg(duration)
+             .arg(workers));
+
+    // The calling thread is worker 0
+    std::vector<std::thread> threads;
+    for (int i = 1; i < workers; ++i) {
+        threads.emplace_back(&EnsembleRunner::workerLoop, this, std::ref(shared));
+    }
+    workerLoop(shared);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    LOG_INFO(QString("Ensemble finished: %1 runs, %2 drone samples")
+             .arg(shared.getCompletedRuns())
+             .arg(shared.getDroneSamples()));
+    return shared;
+}
+
+void EnsembleRunner::cancel() {
+    cancelled = true;
+}
+
+void EnsembleRunner::workerLoop(EnsembleStatistics& shared) {
+    while (!cancelled) {
+        const quint64 run = nextRun.fetch_add(1);
+        if (run >= runCount) {
+            return;
+        }
+
+        EnsembleStatistics result = makeStatistics();
+        runOne(run, result);
+        if (cancelled) {
+            return;  // partial runs would skew the statistics
+        }
+
+        // One short critical section per finished run; runs themselves share nothing
+        std::lock_guard<std::mutex> lock(mutex);
+        shared.merge(result);
+        if (progressCallback && progressInterval > 0 && shared.getCompletedRuns() % progressInterval == 0) {
+            progressCallback(shared);
+        }
+    }
+}
+
+EnsembleStatistics EnsembleRunner::makeStatistics() const {
+    return EnsembleStatistics(duration / LOW_BATTERY_BINS, LOW_BATTERY_BINS);
+}
+
+void EnsembleRunner::runOne(quint64 run, EnsembleStatistics& result) const {
+    DroneSimulator simulator(nullptr, DroneSimulator::QUIET);
+    simulator.setThreadCount(1);
+    simulator.getAlertEngine().setRules({});  // low battery is measured below, not logged
+    simulator.setTickRate(tickRate);
+    simulator.setFleetSize(dronesPerRun);
+    simulator.setMovementStrategy(SimulationFactory::createMovementStrategy(movementType));
+    simulator.setEnergyModel(SimulationFactory::createEnergyModel(energyModelType));
+    simulator.setRandomSeed(seedForRun(run));
+    if (failureMode) {
+        simulator.setFailureMode(true);
+    }
+
+    const FleetState& fleet = simulator.getFleet();
+    const std::vector<double> startLatitude(fleet.latitudes(), fleet.latitudes() + fleet.size());
+    const std::vector<double> startLongitude(fleet.longitudes(), fleet.longitudes() + fleet.size());
+
+    // Drones still above the threshold; compacted as they cross it
+    std::vector<std::size_t> pending;
+    pending.reserve(fleet.size());
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        if (fleet.batteries()[i] < lowBatteryThreshold) {
+            result.addLowBattery(0.0);
+        } else {
+            pending.push_back(i);
+        }
+    }
+
+    const quint64 ticks = static_cast<quint64>(qCeil(duration * simulator.getTickRate()));
+    for (quint64 tick = 0; tick < ticks && !cancelled; ++tick) {
+        simulator.runTicks(1);
+        const double* battery = fleet.batteries();
+        std::size_t kept = 0;
+        for (std::size_t index : pending) {
+            if (battery[index] < lowBatteryThreshold) {
+                result.addLowBattery(fleet.getSimulationTime());
+            } else {
+                pending[kept++] = index;
+            }
+        }
+        pending.resize(kept);
+    }
+    result.neverLow += pending.size();
+
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        const double north = (fleet.latitudes()[i] - startLatitude[i]) * METERS_PER_DEGREE_LATITUDE;
+        const double east = (fleet.longitudes()[i] - startLongitude[i]) * METERS_PER_DEGREE_LATITUDE
+            * qCos(qDegreesToRadians(startLatitude[i]));
+        result.addFinalState(qSqrt(north * north + east * east), fleet.batteries()[i],
+                             fleet.latitudes()[i], fleet.longitudes()[i]);
+    }
+    ++result.completedRuns;
+}
@@ -0,0 +1,130 @@
+#ifndef ENSEMBLERUNNER_H
+#define ENSEMBLERUNNER_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "simulationfactory.h"
+
+// Aggregate outcome of an ensemble: histograms only, so memory does not
+// grow with the number of runs.
+class EnsembleStatistics {
+public:
+    EnsembleStatistics(double lowBatteryBinSeconds = 60.0, int lowBatteryBins = 60,
+                       double displacementBinMeters = 50.0, int displacementBins = 100);
+
+    void merge(const EnsembleStatistics& other);
+
+    quint64 getCompletedRuns() const { return completedRuns; }
+    quint64 getDroneSamples() const { return droneSamples; }
+
+    // Drones whose battery fell below the threshold in [bin * width, (bin + 1) * width)
+    // simulated seconds; drones that never did are counted separately
+    double getLowBatteryBinSeconds() const { return lowBatteryBinSeconds; }
+    const std::vector<quint64>& getLowBatteryHistogram() const { return lowBatteryHistogram; }
+    quint64 getNeverLowCount() const { return neverLow; }
+    // Share of all drones that were low before `seconds` (resolved to whole bins)
+    double fractionLowBefore(double seconds) const;
+
+    // Distance from launch point at the end of the run; the last bin also
+    // holds everything beyond it
+    double getDisplacementBinMeters() const { return displacementBinMeters; }
+    const std::vector<quint64>& getDisplacementHistogram() const { return displacementHistogram; }
+    double meanDisplacementMeters() const;
+    double getMaxDisplacementMeters() const { return maxDisplacement; }
+
+    double meanFinalBattery() const;
+    double meanFinalLatitude() const;
+    double meanFinalLongitude() const;
+
+private:
+    friend class EnsembleRunner;
+
+    void addLowBattery(double seconds);
+    void addFinalState(double displacementMeters, double battery, double latitude, double longitude);
+
+    double lowBatteryBinSeconds;
+    double displacementBinMeters;
+    std::vector<quint64> lowBatteryHistogram;
+    std::vector<quint64> displacementHistogram;
+    quint64 completedRuns;
+    quint64 droneSamples;
+    quint64 neverLow;
+    double displacementSum;
+    double maxDisplacement;
+    double finalBatterySum;
+    double finalLatitudeSum;
+    double finalLongitudeSum;
+};
+
+// Monte Carlo mode: runs many independent, seeded simulations in parallel
+// and folds each finished run into EnsembleStatistics. Every run is its own
+// DroneSimulator with its own strategy instance, stepped on one thread, so
+// runs never share mutable state and throughput scales with the worker
+// count. Run r uses the seed PhiloxRng(baseSeed, ENSEMBLE).bits(r, 0, 0), so
+// an ensemble, and any single member of it, can be reproduced.
+class EnsembleRunner {
+public:
+    // Called after every `interval` completed runs with the statistics so
+    // far, on the worker thread that completed the run (serialized)
+    typedef std::function<void(const EnsembleStatistics& statistics)> ProgressCallback;
+
+    EnsembleRunner();
+
+    void setRunCount(quint64 count);
+    quint64 getRunCount() const;
+    void setDronesPerRun(std::size_t count);
+    std::size_t getDronesPerRun() const;
+    void setDuration(double seconds);
+    double getDuration() const;
+    void setTickRate(double rateHz);
+    double getTickRate() const;
+    void setMovementType(SimulationFactory::MovementType type);
+    void setEnergyModelType(SimulationFactory::EnergyModelType type);
+    void setFailureMode(bool enabled);
+    void setBaseSeed(quint64 seed);
+    quint64 getBaseSeed() const;
+    // Battery percentage that counts as "low" (default 20)
+    void setLowBatteryThreshold(double percent);
+    double getLowBatteryThreshold() const;
+    // Worker threads, one run each at a time (0 = all cores)
+    void setThreadCount(int count);
+    int getThreadCount() const;
+    void setProgressCallback(const ProgressCallback& callback, quint64 interval);
+
+    // Seed of run `run` for this runner's base seed
+    quint64 seedForRun(quint64 run) const;
+
+    // Blocks until every run has finished
+    EnsembleStatistics run();
+
+    // Asks a running ensemble to stop after the runs in progress
+    void cancel();
+
+private:
+    void workerLoop(EnsembleStatistics& shared);
+    void runOne(quint64 run, EnsembleStatistics& result) const;
+    EnsembleStatistics makeStatistics() const;
+
+    quint64 runCount;
+    std::size_t dronesPerRun;
+    double duration;
+    double tickRate;
+    SimulationFactory::MovementType movementType;
+    SimulationFactory::EnergyModelType energyModelType;
+    bool failureMode;
+    quint64 baseSeed;
+    double lowBatteryThreshold;
+    int threadCount;
+    ProgressCallback progressCallback;
+    quint64 progressInterval;
+
+    std::atomic<quint64> nextRun;
+    std::atomic<bool> cancelled;
+    std::mutex mutex;
+};
+
+#endif // ENSEMBLERUNNER_H
@@ -0,0 +1,241 @@
+#include "simulationcheckpoint.h"
+#include "telemetryformat.h"
+#include <QDateTime>
+#include <cstring>
+
+namespace {
+// Staging buffer for scalars and small arrays; larger arrays bypass it
+const std::size_t WRITE_BUFFER_BYTES = 1 << 20;
+}
+
+CheckpointWriter::CheckpointWriter()
+    : payloadBytes(0)
+    , payloadCrc(0)
+    , failed(false)
+{
+    buffer.reserve(WRITE_BUFFER_BYTES);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    // An uncommitted QSaveFile discards its temporary file
+}
+
+bool CheckpointWriter::open(const QString& filename) {
+    file.reset();
+    buffer.clear();
+    payloadBytes = 0;
+    payloadCrc = 0;
+    failed = false;
+    error.clear();
+
+    // Unbuffered: the staging buffer already batches small writes
+    file = std::make_unique<QSaveFile>(filename);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        error = file->errorString();
+        failed = true;
+        file.reset();
+        return false;
+    }
+
+    // Placeholder until finish() knows the payload's size and CRC
+    CheckpointFormat::FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    if (file->write(reinterpret_cast<const char*>(&header), sizeof(header)) != qint64(sizeof(header))) {
+        error = file->errorString();
+        failed = true;
+    }
+    return !failed;
+}
+
+bool CheckpointWriter::finish(quint64 droneCount, quint32 strategyCount) {
+    flushBuffer();
+    if (failed || !file) {
+        file.reset();
+        return false;
+    }
+
+    CheckpointFormat::FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CheckpointFormat::FILE_MAGIC, sizeof(header.magic));
+    header.version = CheckpointFormat::FORMAT_VERSION;
+    header.headerBytes = sizeof(header);
+    header.droneCount = droneCount;
+    header.strategyCount = strategyCount;
+    header.payloadCrc32 = payloadCrc;
+    header.payloadBytes = payloadBytes;
+    header.createdMsecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+
+    if (!file->seek(0)
+        || file->write(reinterpret_cast<const char*>(&header), sizeof(header)) != qint64(sizeof(header))) {
+        error = file->errorString();
+        failed = true;
+    } else if (!file->commit()) {
+        // Renaming over the target failed; the old checkpoint is still there
+        error = file->errorString();
+        failed = true;
+    }
+    file.reset();
+    return !failed;
+}
+
+QString CheckpointWriter::errorString() const {
+    return error;
+}
+
+void CheckpointWriter::writeString(const QString& text) {
+    const QByteArray utf8 = text.toUtf8();
+    writeArray(utf8.constData(), static_cast<std::size_t>(utf8.size()));
+}
+
+void CheckpointWriter::writeBytes(const void* data, std::size_t size) {
+    if (failed || size == 0) {
+        return;
+    }
+    payloadCrc = TelemetryFormat::crc32(data, size, payloadCrc);
+    payloadBytes += size;
+
+    if (buffer.size() + size > WRITE_BUFFER_BYTES) {
+        flushBuffer();
+    }
+
+    // Whole columns of large fleets go straight to the file
+    if (size >= WRITE_BUFFER_BYTES) {
+        if (file->write(static_cast<const char*>(data), size) != qint64(size)) {
+            error = file->errorString();
+            failed = true;
+        }
+        return;
+    }
+
+    const char* bytes = static_cast<const char*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+void CheckpointWriter::flushBuffer() {
+    if (buffer.empty()) {
+        return;
+    }
+    if (!failed && file->write(buffer.data(), buffer.size()) != qint64(buffer.size())) {
+        error = file->errorString();
+        failed = true;
+    }
+    buffer.clear();
+}
+
+CheckpointReader::CheckpointReader()
+    : mapped(nullptr)
+    , cursor(nullptr)
+    , end(nullptr)
+    , failed(false)
+{
+    std::memset(&fileHeader, 0, sizeof(fileHeader));
+}
+
+CheckpointReader::~CheckpointReader() {
+    close();
+}
+
+bool CheckpointReader::open(const QString& filename) {
+    close();
+
+    file.setFileName(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(file.errorString());
+    }
+    const qint64 size = file.size();
+    if (size < qint64(sizeof(CheckpointFormat::FileHeader))) {
+        return fail("file is too small to be a checkpoint");
+    }
+    mapped = file.map(0, size);
+    if (!mapped) {
+        return fail(file.errorString());
+    }
+
+    std::memcpy(&fileHeader, mapped, sizeof(fileHeader));
+    if (std::memcmp(fileHeader.magic, CheckpointFormat::FILE_MAGIC, sizeof(fileHeader.magic)) != 0) {
+        return fail("not a simulation checkpoint");
+    }
+    if (fileHeader.version != CheckpointFormat::FORMAT_VERSION
+        || fileHeader.headerBytes != sizeof(fileHeader)) {
+        return fail(QString("unsupported checkpoint version %1").arg(fileHeader.version));
+    }
+    if (fileHeader.payloadBytes != quint64(size) - sizeof(fileHeader)) {
+        return fail("checkpoint is truncated");
+    }
+
+    cursor = reinterpret_cast<const char*>(mapped) + sizeof(fileHeader);
+    end = cursor + fileHeader.payloadBytes;
+    if (TelemetryFormat::crc32(cursor, fileHeader.payloadBytes) != fileHeader.payloadCrc32) {
+        return fail("checkpoint payload is corrupt");
+    }
+    return true;
+}
+
+void CheckpointReader::close() {
+    if (mapped) {
+        file.unmap(mapped);
+        mapped = nullptr;
+    }
+    file.close();
+    cursor = nullptr;
+    end = nullptr;
+    failed = false;
+    error.clear();
+}
+
+const CheckpointFormat::FileHeader& CheckpointReader::header() const {
+    return fileHeader;
+}
+
+QString CheckpointReader::errorString() const {
+    return error;
+}
+
+bool CheckpointReader::atEnd() const {
+    return !failed && cursor == end;
+}
+
+bool CheckpointReader::readString(QString& text) {
+    quint64 size = 0;
+    if (!read(size)) {
+        return false;
+    }
+    const char* utf8 = take(size);
+    if (!utf8) {
+        return false;
+    }
+    text = QString::fromUtf8(utf8, static_cast<qsizetype>(size));
+    return true;
+}
+
+const char* CheckpointReader::take(std::size_t size) {
+    if (failed || size > remaining()) {
+        fail("checkpoint payload ends early");
+        return nullptr;
+    }
+    const char* data = cursor;
+    cursor += size;
+    return data;
+}
+
+bool CheckpointReader::readBytes(void* data, std::size_t size) {
+    const char* source = take(size);
+    if (!source) {
+        return false;
+    }
+    std::memcpy(data, source, size);
+    return true;
+}
+
+std::size_t CheckpointReader::remaining() const {
+    return cursor ? static_cast<std::size_t>(end - cursor) : 0;
+}
+
+bool CheckpointReader::fail(const QString& message) {
+    // Keep the first error; later ones are usually a consequence of it
+    if (!failed) {
+        error = message;
+    }
+    failed = true;
+    return false;
+}
@@ -0,0 +1,152 @@
+#ifndef SIMULATIONCHECKPOINT_H
+#define SIMULATIONCHECKPOINT_H
+
+#include <QFile>
+#include <QSaveFile>
+#include <QString>
+#include <QtGlobal>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// On-disk layout of simulation checkpoints (.dck). Like telemetry
+// recordings, everything is stored in host byte order. A checkpoint is one
+// header followed by a single payload written front to back; the header
+// carries the payload's size and CRC-32, which are checked before anything
+// is restored. The payload is a sequence of values and arrays whose order
+// is defined by DroneSimulator::saveCheckpoint() and the strategies' and
+// energy models' saveState(); arrays are stored as quint64 count + raw elements so a
+// million-drone column is one copy each way.
+namespace CheckpointFormat {
+
+const char FILE_MAGIC[8] = {'D', 'R', 'O', 'N', 'E', 'C', 'K', 'P'};
+// 2: the energy model and its state replace the fixed drain rate
+const quint32 FORMAT_VERSION = 2;
+
+struct FileHeader {
+    char magic[8];
+    quint32 version;
+    quint32 headerBytes;
+    quint64 droneCount;
+    quint32 strategyCount;
+    quint32 payloadCrc32;
+    quint64 payloadBytes;
+    qint64 createdMsecsSinceEpoch;
+    quint8 reserved[16];
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout is part of the file format");
+
+} // namespace CheckpointFormat
+
+// Streams a checkpoint payload to disk. Small values are staged in a
+// buffer; large arrays go straight to the file. Everything goes to a
+// temporary file that finish() renames over the target once the header is
+// written, so a failed or interrupted save leaves the previous checkpoint
+// intact.
+class CheckpointWriter {
+public:
+    CheckpointWriter();
+    ~CheckpointWriter();
+
+    bool open(const QString& filename);
+    // Writes the header; false if any write failed along the way
+    bool finish(quint64 droneCount, quint32 strategyCount);
+    QString errorString() const;
+
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values are stored as raw bytes");
+        writeBytes(&value, sizeof(T));
+    }
+
+    template <typename T>
+    void writeArray(const T* values, std::size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint arrays are stored as raw bytes");
+        write<quint64>(count);
+        writeBytes(values, count * sizeof(T));
+    }
+
+    template <typename T>
+    void writeArray(const std::vector<T>& values) {
+        writeArray(values.data(), values.size());
+    }
+
+    void writeString(const QString& text);
+
+private:
+    void writeBytes(const void* data, std::size_t size);
+    void flushBuffer();
+
+    std::unique_ptr<QSaveFile> file;
+    std::vector<char> buffer;
+    quint64 payloadBytes;
+    quint32 payloadCrc;
+    bool failed;
+    QString error;
+};
+
+// Reads a checkpoint through a memory map. open() validates the header and
+// the payload CRC, so the read calls only have to guard against a payload
+// that does not match what the caller expects; they return false (and stay
+// false) once anything was out of bounds.
+class CheckpointReader {
+public:
+    CheckpointReader();
+    ~CheckpointReader();
+
+    bool open(const QString& filename);
+    void close();
+    const CheckpointFormat::FileHeader& header() const;
+    QString errorString() const;
+    bool atEnd() const;
+
+    template <typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values are stored as raw bytes");
+        return readBytes(&value, sizeof(T));
+    }
+
+    // Reads an array that must hold exactly `count` elements
+    template <typename T>
+    bool readArray(T* values, std::size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint arrays are stored as raw bytes");
+        quint64 stored = 0;
+        if (!read(stored) || stored != count) {
+            return fail("array length does not match");
+        }
+        return readBytes(values, count * sizeof(T));
+    }
+
+    template <typename T>
+    bool readArray(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint arrays are stored as raw bytes");
+        quint64 count = 0;
+        if (!read(count) || count > remaining() / sizeof(T)) {
+            return fail("array runs past the end of the checkpoint");
+        }
+        values.resize(count);
+        return readBytes(values.data(), count * sizeof(T));
+    }
+
+    bool readString(QString& text);
+
+    // Direct access for bulk decoders (e.g. the name table); advances past `size` bytes
+    const char* take(std::size_t size);
+
+private:
+    bool readBytes(void* data, std::size_t size);
+    std::size_t remaining() const;
+    bool fail(const QString& message);
+
+    QFile file;
+    uchar* mapped;
+    const char* cursor;
+    const char* end;
+    CheckpointFormat::FileHeader fileHeader;
+    bool failed;
+    QString error;
+};
+
+#endif // SIMULATIONCHECKPOINT_H
@@ -6,6 +6,8 @@
 #include "hoverstrategy.h"
 #include "randomwalkstrategy.h"
 #include "movementstrategy.h"
+#include "physicsenergymodel.h"
+#include "constantdrainmodel.h"
 #include "logger.h"
 
 std::unique_ptr<DroneSimulator> SimulationFactory::createSimulator(SimulatorType type) {
@@ -26,8 +28,8 @@ std::unique_ptr<DroneSimulator> SimulationFactory::createSimulator(SimulatorType
 }
 
 std::unique_ptr<MovementStrategy> SimulationFactory::createMovementStrategy(MovementType type) {
-    Logger::getInstance().log(Logger::INFO, 
-        QString("Creating movement strategy of type: %1").arg(static_cast<int>(type)));
+    // Debug only: ensembles create one strategy per run
+    LOG_DEBUG(QString("Creating movement strategy of type: %1").arg(static_cast<int>(type)));
 
     switch (type) {
         case HOVER_MOVEMENT:
@@ -39,3 +41,43 @@ std::unique_ptr<MovementStrategy> SimulationFactory::createMovementStrategy(Move
             return std::make_unique<HoverStrategy>();
     }
 }
+
+std::unique_ptr<MovementStrategy> SimulationFactory::createMovementStrategy(const QString& strategyName) {
+    const MovementType types[] = {HOVER_MOVEMENT, RANDOM_WALK_MOVEMENT};
+    for (MovementType type : types) {
+        std::unique_ptr<MovementStrategy> strategy = createMovementStrategy(type);
+        if (strategy->getStrategyName() == strategyName) {
+            return strategy;
+        }
+    }
+
+    Logger::getInstance().log(Logger::ERROR,
+        QString("Unknown movement strategy requested: %1").arg(strategyName));
+    return nullptr;
+}
+
+std::unique_ptr<EnergyModel> SimulationFactory::createEnergyModel(EnergyModelType type) {
+    switch (type) {
+        case PHYSICS_ENERGY:
+            return std::make_unique<PhysicsEnergyModel>();
+        case CONSTANT_DRAIN_ENERGY:
+            return std::make_unique<ConstantDrainModel>();
+        default:
+            Logger::getInstance().log(Logger::ERROR, "Unknown energy model type requested");
+            return std::make_unique<PhysicsEnergyModel>();
+    }
+}
+
+std::unique_ptr<EnergyModel> SimulationFactory::createEnergyModel(const QString& modelName) {
+    const EnergyModelType types[] = {PHYSICS_ENERGY, CONSTANT_DRAIN_ENERGY};
+    for (EnergyModelType type : types) {
+        std::unique_ptr<EnergyModel> model = createEnergyModel(type);
+        if (model->getModelName() == modelName) {
+            return model;
+        }
+    }
+
+    Logger::getInstance().log(Logger::ERROR,
+        QString("Unknown energy model requested: %1").arg(modelName));
+    return nullptr;
+}
@@ -1,9 +1,11 @@
 #ifndef SIMULATIONFACTORY_H
 #define SIMULATIONFACTORY_H
 
+#include <QString>
 #include <memory>
 
 class DroneSimulator;
+class EnergyModel;
 class MovementStrategy;
 
 // Factory Pattern Implementation
@@ -19,8 +21,18 @@ public:
         RANDOM_WALK_MOVEMENT
     };
 
+    enum EnergyModelType {
+        PHYSICS_ENERGY,
+        CONSTANT_DRAIN_ENERGY
+    };
+
     static std::unique_ptr<DroneSimulator> createSimulator(SimulatorType type);
     static std::unique_ptr<MovementStrategy> createMovementStrategy(MovementType type);
+    // By getStrategyName(), e.g. when restoring a checkpoint; null if unknown
+    static std::unique_ptr<MovementStrategy> createMovementStrategy(const QString& strategyName);
+    static std::unique_ptr<EnergyModel> createEnergyModel(EnergyModelType type);
+    // By getModelName(); null if unknown
+    static std::unique_ptr<EnergyModel> createEnergyModel(const QString& modelName);
 };
 
 #endif // SIMULATIONFACTORY_H
\ No newline at end of file
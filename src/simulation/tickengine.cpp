@@ -0,0 +1,152 @@
+#include "tickengine.h"
+#include <QThread>
+#include <algorithm>
+
+TickEngine::TickEngine(int threadCount)
+    : participants(1)
+    , generation(0)
+    , pendingWorkers(0)
+    , stopping(false)
+    , currentTask(nullptr)
+    , currentCount(0)
+    , currentGrain(1)
+    , stolen(0)
+{
+    setThreadCount(threadCount);
+}
+
+TickEngine::~TickEngine() {
+    stopWorkers();
+}
+
+void TickEngine::setThreadCount(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = qMax(1, QThread::idealThreadCount());
+    }
+    if (threadCount == participants && (participants == 1 || !workers.empty())) {
+        return;
+    }
+
+    // Workers start lazily on the first parallelFor() that needs them
+    stopWorkers();
+    participants = threadCount;
+    slices.reset(new WorkSlice[participants]);
+    for (int i = 0; i < participants; ++i) {
+        slices[i].next.store(0, std::memory_order_relaxed);
+        slices[i].end = 0;
+    }
+}
+
+int TickEngine::threadCount() const {
+    return participants;
+}
+
+quint64 TickEngine::stolenChunks() const {
+    return stolen.load(std::memory_order_relaxed);
+}
+
+void TickEngine::parallelFor(std::size_t count, std::size_t grain, const RangeTask& task) {
+    if (count == 0) {
+        return;
+    }
+    grain = qMax<std::size_t>(1, grain);
+    const std::size_t chunks = (count + grain - 1) / grain;
+
+    // Not worth waking anyone: run inline
+    if (participants <= 1 || chunks <= 1) {
+        for (std::size_t begin = 0; begin < count; begin += grain) {
+            task(begin, qMin(begin + grain, count));
+        }
+        return;
+    }
+
+    if (workers.empty()) {
+        startWorkers();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        currentCount = count;
+        currentGrain = grain;
+
+        // Contiguous slice of chunks per participant keeps neighbouring drones together
+        for (int i = 0; i < participants; ++i) {
+            slices[i].next.store(chunks * i / participants, std::memory_order_relaxed);
+            slices[i].end = chunks * (i + 1) / participants;
+        }
+
+        pendingWorkers = participants - 1;
+        ++generation;
+    }
+    wakeWorkers.notify_all();
+
+    runSlices(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    workersDone.wait(lock, [this] { return pendingWorkers == 0; });
+    currentTask = nullptr;
+}
+
+void TickEngine::startWorkers() {
+    stopping = false;
+    workers.reserve(participants - 1);
+    for (int i = 1; i < participants; ++i) {
+        // Hand over the current generation so a slow-starting worker cannot miss a round
+        workers.emplace_back(&TickEngine::workerLoop, this, i, generation);
+    }
+}
+
+void TickEngine::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void TickEngine::workerLoop(int participant, quint64 startGeneration) {
+    quint64 seenGeneration = startGeneration;
+    for (;;) {
+        std::unique_lock<std::mutex> lock(mutex);
+        wakeWorkers.wait(lock, [&] { return stopping || generation != seenGeneration; });
+        if (stopping) {
+            return;
+        }
+        seenGeneration = generation;
+        lock.unlock();
+
+        runSlices(participant);
+
+        lock.lock();
+        if (--pendingWorkers == 0) {
+            workersDone.notify_one();
+        }
+    }
+}
+
+void TickEngine::runSlices(int participant) {
+    const RangeTask& task = *currentTask;
+    const std::size_t count = currentCount;
+    const std::size_t grain = currentGrain;
+
+    // Own slice first, then steal from the others in ring order
+    for (int offset = 0; offset < participants; ++offset) {
+        WorkSlice& slice = slices[(participant + offset) % participants];
+        for (;;) {
+            std::size_t chunk = slice.next.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= slice.end) {
+                break;
+            }
+            std::size_t begin = chunk * grain;
+            task(begin, qMin(begin + grain, count));
+            if (offset != 0) {
+                stolen.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+}
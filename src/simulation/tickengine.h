@@ -0,0 +1,68 @@
+#ifndef TICKENGINE_H
+#define TICKENGINE_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads that runs fleet-wide work in parallel.
+// parallelFor() cuts [0, count) into chunks and hands each participant a
+// contiguous slice of them; a participant that finishes its slice steals
+// the remaining chunks of the others through the same lock-free counters.
+// The calling thread takes part as participant 0 and parallelFor() only
+// returns once every chunk has run, which gives the tick its barrier.
+class TickEngine {
+public:
+    typedef std::function<void(std::size_t begin, std::size_t end)> RangeTask;
+
+    // 0 picks QThread::idealThreadCount()
+    explicit TickEngine(int threadCount = 0);
+    ~TickEngine();
+
+    TickEngine(const TickEngine&) = delete;
+    TickEngine& operator=(const TickEngine&) = delete;
+
+    void setThreadCount(int threadCount);
+    int threadCount() const;
+
+    // Not reentrant: call from one thread at a time
+    void parallelFor(std::size_t count, std::size_t grain, const RangeTask& task);
+
+    // Chunks run by a participant other than the one they were assigned to
+    quint64 stolenChunks() const;
+
+private:
+    struct alignas(64) WorkSlice {
+        std::atomic<std::size_t> next;
+        std::size_t end;
+    };
+
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop(int participant, quint64 startGeneration);
+    void runSlices(int participant);
+
+    int participants;
+    std::vector<std::thread> workers;
+    std::unique_ptr<WorkSlice[]> slices;
+
+    std::mutex mutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable workersDone;
+    quint64 generation;
+    int pendingWorkers;
+    bool stopping;
+
+    const RangeTask* currentTask;
+    std::size_t currentCount;
+    std::size_t currentGrain;
+    std::atomic<quint64> stolen;
+};
+
+#endif // TICKENGINE_H
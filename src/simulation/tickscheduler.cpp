@@ -0,0 +1,78 @@
+#include "tickscheduler.h"
+
+namespace {
+// A wake-up this many steps late only catches up this far
+const int DEFAULT_MAX_SUB_STEPS = 10;
+}
+
+TickScheduler::TickScheduler(double rateHz)
+    : lastElapsedNs(0)
+    , stepNs(0)
+    , accumulatorNs(0)
+    , rateHz(0.0)
+    , subStepLimit(DEFAULT_MAX_SUB_STEPS)
+    , dropped(0)
+{
+    setRate(rateHz);
+}
+
+void TickScheduler::setRate(double rate) {
+    rateHz = qBound(MIN_RATE_HZ, rate, MAX_RATE_HZ);
+    stepNs = qRound64(1e9 / rateHz);
+    accumulatorNs = qMin(accumulatorNs, stepNs);
+}
+
+double TickScheduler::rate() const {
+    return rateHz;
+}
+
+double TickScheduler::stepSeconds() const {
+    return stepNs / 1e9;
+}
+
+int TickScheduler::timerIntervalMs() const {
+    // Round down so the timer never fires less often than the step rate
+    return qMax(1, static_cast<int>(stepNs / 1000000));
+}
+
+void TickScheduler::setMaxSubSteps(int steps) {
+    subStepLimit = qMax(1, steps);
+}
+
+int TickScheduler::maxSubSteps() const {
+    return subStepLimit;
+}
+
+void TickScheduler::start() {
+    clock.start();
+    lastElapsedNs = 0;
+    accumulatorNs = 0;
+}
+
+int TickScheduler::stepsDue() {
+    if (!clock.isValid()) {
+        start();
+    }
+
+    const qint64 now = clock.nsecsElapsed();
+    const qint64 elapsed = now - lastElapsedNs;
+    lastElapsedNs = now;
+    return advance(elapsed);
+}
+
+int TickScheduler::advance(qint64 elapsedNs) {
+    accumulatorNs += qMax<qint64>(0, elapsedNs);
+
+    qint64 steps = accumulatorNs / stepNs;
+    accumulatorNs -= steps * stepNs;
+
+    if (steps > subStepLimit) {
+        dropped += static_cast<quint64>(steps - subStepLimit);
+        steps = subStepLimit;
+    }
+    return static_cast<int>(steps);
+}
+
+quint64 TickScheduler::droppedSteps() const {
+    return dropped;
+}
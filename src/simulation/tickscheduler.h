@@ -0,0 +1,54 @@
+#ifndef TICKSCHEDULER_H
+#define TICKSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+// Fixed-timestep clock for the simulation. Real elapsed time is measured
+// with a monotonic clock and accumulated; every whole step in the
+// accumulator becomes one tick of exactly stepSeconds() of simulated time.
+// Timer jitter and late timeouts therefore never change simulated time,
+// they only change how many steps run on a given wake-up. When the host
+// falls far behind, at most maxSubSteps() steps run per wake-up and the
+// excess is dropped (and counted) instead of spiralling.
+class TickScheduler {
+public:
+    static constexpr double MIN_RATE_HZ = 2.0;
+    static constexpr double MAX_RATE_HZ = 1000.0;
+
+    explicit TickScheduler(double rateHz = MIN_RATE_HZ);
+
+    // Clamped to [MIN_RATE_HZ, MAX_RATE_HZ]
+    void setRate(double rateHz);
+    double rate() const;
+    double stepSeconds() const;
+
+    // Timer period that wakes the scheduler at least once per step
+    int timerIntervalMs() const;
+
+    void setMaxSubSteps(int steps);
+    int maxSubSteps() const;
+
+    // Restarts the clock with an empty accumulator
+    void start();
+
+    // Steps due since the previous call, measured on the internal clock
+    int stepsDue();
+
+    // Same, for an explicit amount of elapsed real time
+    int advance(qint64 elapsedNs);
+
+    // Steps discarded because a wake-up exceeded maxSubSteps()
+    quint64 droppedSteps() const;
+
+private:
+    QElapsedTimer clock;
+    qint64 lastElapsedNs;
+    qint64 stepNs;
+    qint64 accumulatorNs;
+    double rateHz;
+    int subStepLimit;
+    quint64 dropped;
+};
+
+#endif // TICKSCHEDULER_H
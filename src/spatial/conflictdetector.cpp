@@ -0,0 +1,161 @@
+#include "conflictdetector.h"
+#include "fleetstate.h"
+#include "logger.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// New conflicts logged individually per tick; the rest are summarized
+const std::size_t MAX_LOGGED_CONFLICTS = 16;
+
+quint64 pairKey(DroneId a, DroneId b) {
+    return a < b ? (static_cast<quint64>(a) << 32) | b : (static_cast<quint64>(b) << 32) | a;
+}
+}
+
+ConflictDetector::ConflictDetector(double separationMeters, double collisionMeters)
+    : separationMeters(DEFAULT_SEPARATION_METERS)
+    , collisionMeters(DEFAULT_COLLISION_METERS)
+    , totalConflicts(0)
+{
+    setSeparation(separationMeters);
+    setCollisionDistance(collisionMeters);
+}
+
+void ConflictDetector::setSeparation(double meters) {
+    separationMeters = qMax(meters, 0.0);
+    grid.setCellSize(separationMeters);
+}
+
+double ConflictDetector::getSeparation() const {
+    return separationMeters;
+}
+
+void ConflictDetector::setCollisionDistance(double meters) {
+    collisionMeters = qMax(meters, 0.0);
+}
+
+double ConflictDetector::getCollisionDistance() const {
+    return collisionMeters;
+}
+
+void ConflictDetector::updateFleet(const FleetSnapshotPtr& snapshot) {
+    detect(*snapshot);
+    notify();
+}
+
+void ConflictDetector::addListener(ConflictListener* listener) {
+    if (listener && std::find(listeners.begin(), listeners.end(), listener) == listeners.end()) {
+        listeners.push_back(listener);
+    }
+}
+
+void ConflictDetector::removeListener(ConflictListener* listener) {
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
+
+void ConflictDetector::notify() {
+    for (ConflictListener* listener : listeners) {
+        listener->updateConflicts(conflicts);
+    }
+}
+
+const std::vector<ConflictEvent>& ConflictDetector::detect(const FleetState& fleet) {
+    // Broad phase: pairs within the separation distance
+    grid.rebuild(fleet);
+    candidates.clear();
+    grid.findPairsWithin(qMax(separationMeters, collisionMeters), candidates);
+
+    conflicts.clear();
+    previousPairs.swap(activePairs);
+    activePairs.clear();
+
+    const double* latitude = fleet.latitudes();
+    const double* longitude = fleet.longitudes();
+    const double* altitude = fleet.altitudes();
+    const double* heading = fleet.headings();
+    const double* speed = fleet.speeds();
+    std::size_t newConflicts = 0;
+
+    // Narrow phase: distance and closing speed
+    for (const auto& candidate : candidates) {
+        const std::size_t a = candidate.first;
+        const std::size_t b = candidate.second;
+        const double dx = grid.eastMeters(longitude[b]) - grid.eastMeters(longitude[a]);
+        const double dy = grid.northMeters(latitude[b]) - grid.northMeters(latitude[a]);
+        const double dz = altitude[b] - altitude[a];
+        const double distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+        const double headingA = qDegreesToRadians(heading[a]);
+        const double headingB = qDegreesToRadians(heading[b]);
+        const double vx = speed[b] * std::sin(headingB) - speed[a] * std::sin(headingA);
+        const double vy = speed[b] * std::cos(headingB) - speed[a] * std::cos(headingA);
+        const double closingSpeed = distance > 0.0
+            ? -(dx * vx + dy * vy) / distance
+            : std::sqrt(vx * vx + vy * vy);
+
+        ConflictEvent::Severity severity;
+        if (distance <= collisionMeters) {
+            severity = ConflictEvent::COLLISION;
+        } else if (distance <= separationMeters && closingSpeed > 0.0) {
+            severity = ConflictEvent::PROXIMITY;
+        } else {
+            continue;
+        }
+
+        const DroneId firstId = fleet.idAt(a);
+        const DroneId secondId = fleet.idAt(b);
+        const quint64 key = pairKey(firstId, secondId);
+        const bool isNew = previousPairs.find(key) == previousPairs.end();
+        activePairs.insert(key);
+        if (isNew) {
+            ++newConflicts;
+        }
+        conflicts.push_back(ConflictEvent{a, b, firstId, secondId, distance, closingSpeed, severity, isNew});
+    }
+
+    std::sort(conflicts.begin(), conflicts.end(), [](const ConflictEvent& x, const ConflictEvent& y) {
+        return x.first != y.first ? x.first < y.first : x.second < y.second;
+    });
+
+    totalConflicts += newConflicts;
+    if (newConflicts > 0) {
+        logNewConflicts(fleet, newConflicts);
+    }
+    return conflicts;
+}
+
+const std::vector<ConflictEvent>& ConflictDetector::getConflicts() const {
+    return conflicts;
+}
+
+quint64 ConflictDetector::getTotalConflicts() const {
+    return totalConflicts;
+}
+
+void ConflictDetector::logNewConflicts(const FleetState& fleet, std::size_t newConflicts) {
+    std::size_t logged = 0;
+    for (const ConflictEvent& conflict : conflicts) {
+        if (!conflict.isNew) {
+            continue;
+        }
+        if (logged++ == MAX_LOGGED_CONFLICTS) {
+            break;
+        }
+        if (conflict.severity == ConflictEvent::COLLISION) {
+            LOG_ERROR(QString("Collision risk: %1 and %2 are %3 m apart")
+                      .arg(fleet.nameAt(conflict.first), fleet.nameAt(conflict.second))
+                      .arg(conflict.distanceMeters, 0, 'f', 1));
+        } else {
+            LOG_WARNING(QString("Separation lost: %1 and %2 are %3 m apart, closing at %4 m/s")
+                        .arg(fleet.nameAt(conflict.first), fleet.nameAt(conflict.second))
+                        .arg(conflict.distanceMeters, 0, 'f', 1)
+                        .arg(conflict.closingSpeed, 0, 'f', 1));
+        }
+    }
+    if (newConflicts > MAX_LOGGED_CONFLICTS) {
+        LOG_WARNING(QString("%1 further new conflicts this tick")
+                    .arg(static_cast<qulonglong>(newConflicts - MAX_LOGGED_CONFLICTS)));
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef CONFLICTDETECTOR_H
+#define CONFLICTDETECTOR_H
+
+#include <QtGlobal>
+#include <cstddef>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "droneidregistry.h"
+#include "observer.h"
+#include "spatialgrid.h"
+
+class FleetState;
+
+// One pair of drones that lost separation on a tick
+struct ConflictEvent {
+    enum Severity {
+        PROXIMITY = 0,  // inside the separation distance and closing
+        COLLISION = 1   // inside the collision distance
+    };
+
+    std::size_t first;       // fleet indices, first < second
+    std::size_t second;
+    DroneId firstId;
+    DroneId secondId;
+    double distanceMeters;
+    double closingSpeed;     // m/s along the line between them, positive when approaching
+    Severity severity;
+    bool isNew;              // not in conflict on the previous tick
+};
+
+// Receives the conflicts of every tick from a ConflictDetector
+class ConflictListener {
+public:
+    virtual ~ConflictListener() = default;
+    // The conflicts active on the tick, possibly none
+    virtual void updateConflicts(const std::vector<ConflictEvent>& conflicts) = 0;
+};
+
+// Per-tick separation check. Attached to a simulator it runs on every
+// published snapshot: a broad phase buckets the fleet into a SpatialGrid
+// with separation-sized cells and collects the pairs within the separation
+// distance, then a narrow phase classifies each pair from its 3D distance
+// and closing speed (velocity from heading, compass degrees, and ground
+// speed). Cost grows with the fleet and the number of nearby pairs, not
+// with the fleet squared. New conflicts are logged; listeners added to the
+// detector receive the tick's conflicts through updateConflicts().
+class ConflictDetector : public Observer {
+public:
+    static constexpr double DEFAULT_SEPARATION_METERS = 50.0;
+    static constexpr double DEFAULT_COLLISION_METERS = 5.0;
+
+    ConflictDetector(double separationMeters = DEFAULT_SEPARATION_METERS,
+                     double collisionMeters = DEFAULT_COLLISION_METERS);
+
+    void setSeparation(double meters);
+    double getSeparation() const;
+    void setCollisionDistance(double meters);
+    double getCollisionDistance() const;
+
+    // Observer: runs detection on the tick's snapshot, then notifies
+    void updateFleet(const FleetSnapshotPtr& snapshot) override;
+
+    void addListener(ConflictListener* listener);
+    void removeListener(ConflictListener* listener);
+    // Forwards the last detected conflicts to the listeners
+    void notify();
+
+    // Runs one tick of detection directly; conflicts are ordered by (first, second)
+    const std::vector<ConflictEvent>& detect(const FleetState& fleet);
+
+    const std::vector<ConflictEvent>& getConflicts() const;
+    // Conflicts that began since construction (each pair counted once per episode)
+    quint64 getTotalConflicts() const;
+
+private:
+    void logNewConflicts(const FleetState& fleet, std::size_t newConflicts);
+
+    double separationMeters;
+    double collisionMeters;
+    SpatialGrid grid;
+    std::vector<std::pair<std::size_t, std::size_t>> candidates;
+    std::vector<ConflictEvent> conflicts;
+
+    // Drone ID pairs in conflict on this and the previous tick
+    std::unordered_set<quint64> activePairs;
+    std::unordered_set<quint64> previousPairs;
+
+    std::vector<ConflictListener*> listeners;
+    quint64 totalConflicts;
+};
+
+#endif // CONFLICTDETECTOR_H
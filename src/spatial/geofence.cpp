@@ -0,0 +1,494 @@
+#include "geofence.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+// Where a cell's reference point sits, as a fraction of the cell in both
+// axes. Off-centre and irrational so zone vertices on round coordinates
+// do not land on it.
+const double REFERENCE_FRACTION = 0.41421356237309503;
+
+// Edges are registered with cells up to this fraction of a cell past their
+// extent, so rounding never drops an edge from a cell it touches. An edge
+// in a cell it misses cannot cross a segment inside that cell, so extra
+// registrations cost time but not correctness.
+const double EDGE_MARGIN = 1e-6;
+
+// Cells are stretched by this factor so the far edges of the box fall
+// inside the last row and column
+const double GRID_STRETCH = 1.0 + 1e-9;
+
+// Extent given to a degenerate (zero-width or zero-height) bounding box, in degrees
+const double MIN_EXTENT = 1e-9;
+
+// Twice the signed area of (a, b, c); positive when c is left of a->b
+inline double orientation(double ax, double ay, double bx, double by, double cx, double cy) {
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+bool isUsable(const GeofenceZone& zone) {
+    return zone.vertices.size() >= 3;
+}
+
+bool parseVertex(const QJsonValue& value, GeofenceZone::Vertex& vertex) {
+    const QJsonArray pair = value.toArray();
+    if (pair.size() != 2 || !pair.at(0).isDouble() || !pair.at(1).isDouble()) {
+        return false;
+    }
+    vertex.latitude = pair.at(0).toDouble();
+    vertex.longitude = pair.at(1).toDouble();
+    return vertex.latitude >= -90.0 && vertex.latitude <= 90.0
+        && vertex.longitude >= -180.0 && vertex.longitude <= 180.0;
+}
+
+bool parseZone(const QJsonObject& object, GeofenceZone& zone, QString& error) {
+    zone.name = object.value("name").toString();
+    if (zone.name.isEmpty()) {
+        error = "zone without a name";
+        return false;
+    }
+
+    const QString type = object.value("type").toString("exclusion");
+    if (type == "inclusion") {
+        zone.type = GeofenceZone::INCLUSION;
+    } else if (type == "exclusion") {
+        zone.type = GeofenceZone::EXCLUSION;
+    } else {
+        error = QString("zone \"%1\": unknown type \"%2\"").arg(zone.name, type);
+        return false;
+    }
+
+    const QJsonArray vertices = object.value("vertices").toArray();
+    if (vertices.size() < 3) {
+        error = QString("zone \"%1\" needs at least three vertices").arg(zone.name);
+        return false;
+    }
+    zone.vertices.clear();
+    zone.vertices.reserve(vertices.size());
+    for (const QJsonValue& value : vertices) {
+        GeofenceZone::Vertex vertex;
+        if (!parseVertex(value, vertex)) {
+            error = QString("zone \"%1\": vertices must be [latitude, longitude] pairs in degrees").arg(zone.name);
+            return false;
+        }
+        zone.vertices.push_back(vertex);
+    }
+    return true;
+}
+}
+
+Geofence::Geofence()
+    : Geofence(std::vector<GeofenceZone>())
+{
+}
+
+Geofence::Geofence(const std::vector<GeofenceZone>& fenceZones)
+    : zones(fenceZones)
+    , edgeCount(0)
+    , inclusionZones(false)
+    , permittedIsBox(true)
+    , permittedBounds{-90.0, 90.0, -180.0, 180.0}
+    , originX(0.0)
+    , originY(0.0)
+    , cellWidth(1.0)
+    , cellHeight(1.0)
+    , inverseCellWidth(1.0)
+    , inverseCellHeight(1.0)
+    , columns(0)
+    , rows(0)
+{
+    build();
+}
+
+std::vector<GeofenceZone> Geofence::defaultZones() {
+    return {box("operating-area", GeofenceZone::INCLUSION, GeofenceBounds{28.4, 29.0, 77.0, 78.0})};
+}
+
+const Geofence& Geofence::operatingArea() {
+    static const Geofence area(defaultZones());
+    return area;
+}
+
+GeofenceZone Geofence::box(const QString& name, GeofenceZone::Type type, const GeofenceBounds& bounds) {
+    GeofenceZone zone;
+    zone.name = name;
+    zone.type = type;
+    zone.vertices = {
+        {bounds.minLatitude, bounds.minLongitude},
+        {bounds.minLatitude, bounds.maxLongitude},
+        {bounds.maxLatitude, bounds.maxLongitude},
+        {bounds.maxLatitude, bounds.minLongitude}
+    };
+    return zone;
+}
+
+bool Geofence::parseZones(const QByteArray& json, std::vector<GeofenceZone>& parsed, QString& error) {
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        error = QString("%1 at offset %2").arg(parseError.errorString()).arg(parseError.offset);
+        return false;
+    }
+    if (!document.isObject() || !document.object().value("zones").isArray()) {
+        error = "expected an object with a \"zones\" array";
+        return false;
+    }
+
+    std::vector<GeofenceZone> result;
+    for (const QJsonValue& value : document.object().value("zones").toArray()) {
+        GeofenceZone zone;
+        if (!value.isObject()) {
+            error = "every zone must be an object";
+            return false;
+        }
+        if (!parseZone(value.toObject(), zone, error)) {
+            return false;
+        }
+        result.push_back(zone);
+    }
+    parsed.swap(result);
+    return true;
+}
+
+bool Geofence::loadZones(const QString& filename, std::vector<GeofenceZone>& loaded, QString& error) {
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+        return false;
+    }
+    return parseZones(file.readAll(), loaded, error);
+}
+
+GeofenceBounds Geofence::getPermittedBounds() const {
+    return permittedBounds;
+}
+
+qint64 Geofence::cellX(double longitude) const {
+    const double cell = std::floor((longitude - originX) * inverseCellWidth);
+    return static_cast<qint64>(qBound(0.0, cell, static_cast<double>(columns - 1)));
+}
+
+qint64 Geofence::cellY(double latitude) const {
+    const double cell = std::floor((latitude - originY) * inverseCellHeight);
+    return static_cast<qint64>(qBound(0.0, cell, static_cast<double>(rows - 1)));
+}
+
+double Geofence::referenceX(qint64 column) const {
+    return originX + (static_cast<double>(column) + REFERENCE_FRACTION) * cellWidth;
+}
+
+double Geofence::referenceY(qint64 row) const {
+    return originY + (static_cast<double>(row) + REFERENCE_FRACTION) * cellHeight;
+}
+
+void Geofence::build() {
+    // Bounding boxes of all zones and of the inclusion zones
+    double minX = 0.0, maxX = 0.0, minY = 0.0, maxY = 0.0;
+    GeofenceBounds inclusion{90.0, -90.0, 180.0, -180.0};
+    bool anyZone = false;
+    std::size_t inclusionCount = 0;
+    std::size_t exclusionCount = 0;
+    double inclusionArea = 0.0;
+
+    for (const GeofenceZone& zone : zones) {
+        if (!isUsable(zone)) {
+            continue;
+        }
+        double area = 0.0;
+        for (std::size_t i = 0; i < zone.vertices.size(); ++i) {
+            const GeofenceZone::Vertex& vertex = zone.vertices[i];
+            const GeofenceZone::Vertex& next = zone.vertices[(i + 1) % zone.vertices.size()];
+            area += vertex.longitude * next.latitude - next.longitude * vertex.latitude;
+            minX = anyZone ? qMin(minX, vertex.longitude) : vertex.longitude;
+            maxX = anyZone ? qMax(maxX, vertex.longitude) : vertex.longitude;
+            minY = anyZone ? qMin(minY, vertex.latitude) : vertex.latitude;
+            maxY = anyZone ? qMax(maxY, vertex.latitude) : vertex.latitude;
+            anyZone = true;
+            if (zone.type == GeofenceZone::INCLUSION) {
+                inclusion.minLatitude = qMin(inclusion.minLatitude, vertex.latitude);
+                inclusion.maxLatitude = qMax(inclusion.maxLatitude, vertex.latitude);
+                inclusion.minLongitude = qMin(inclusion.minLongitude, vertex.longitude);
+                inclusion.maxLongitude = qMax(inclusion.maxLongitude, vertex.longitude);
+            }
+            if (vertex.latitude != next.latitude || vertex.longitude != next.longitude) {
+                ++edgeCount;
+            }
+        }
+        if (zone.type == GeofenceZone::INCLUSION) {
+            ++inclusionCount;
+            inclusionArea = std::abs(area) / 2.0;
+        } else {
+            ++exclusionCount;
+        }
+    }
+    if (!anyZone) {
+        return;
+    }
+
+    inclusionZones = inclusionCount > 0;
+    if (inclusionZones) {
+        permittedBounds = inclusion;
+        // A lone inclusion polygon as large as its bounding box is that box
+        const double boxArea = (inclusion.maxLatitude - inclusion.minLatitude)
+            * (inclusion.maxLongitude - inclusion.minLongitude);
+        permittedIsBox = inclusionCount == 1 && exclusionCount == 0
+            && std::abs(inclusionArea - boxArea) <= 1e-12 * boxArea;
+    } else {
+        permittedIsBox = exclusionCount == 0;
+    }
+
+    // About CELLS_PER_EDGE cells per edge, split to keep cells near square
+    const double width = qMax(maxX - minX, MIN_EXTENT);
+    const double height = qMax(maxY - minY, MIN_EXTENT);
+    const double targetCells = static_cast<double>(qBound<std::size_t>(1, CELLS_PER_EDGE * edgeCount, MAX_GRID_CELLS));
+    columns = static_cast<qint64>(qBound(1.0, std::round(std::sqrt(targetCells * width / height)), targetCells));
+    rows = static_cast<qint64>(qBound(1.0, std::floor(targetCells / columns), targetCells));
+    originX = minX;
+    originY = minY;
+    cellWidth = width / columns * GRID_STRETCH;
+    cellHeight = height / rows * GRID_STRETCH;
+    inverseCellWidth = 1.0 / cellWidth;
+    inverseCellHeight = 1.0 / cellHeight;
+
+    const std::size_t cellCount = static_cast<std::size_t>(columns * rows);
+    std::vector<quint8> cellFlags(cellCount, 0);
+    cellExclusion.assign(cellCount, -1);
+
+    // Pass 1 per zone registers its edges with every cell they touch; pass 2
+    // walks each grid row at the reference latitude, where the zone's edge
+    // crossings bound the runs of inside reference points. Untouched cells
+    // in those runs are wholly inside; touched ones record the reference.
+    struct PendingEdge {
+        quint32 cell;
+        quint32 zone;
+        Edge edge;
+    };
+    std::vector<PendingEdge> pending;
+    std::vector<std::pair<quint32, quint32>> insideReferences;   // (cell, zone)
+    std::vector<std::pair<qint64, double>> crossings;             // (row, longitude)
+    std::vector<qint32> touchedBy(cellCount, -1);
+
+    for (std::size_t z = 0; z < zones.size(); ++z) {
+        const GeofenceZone& zone = zones[z];
+        if (!isUsable(zone)) {
+            continue;
+        }
+        const quint32 zoneIndex = static_cast<quint32>(z);
+        crossings.clear();
+
+        for (std::size_t i = 0; i < zone.vertices.size(); ++i) {
+            const GeofenceZone::Vertex& start = zone.vertices[i];
+            const GeofenceZone::Vertex& end = zone.vertices[(i + 1) % zone.vertices.size()];
+            const Edge edge{start.longitude, start.latitude, end.longitude, end.latitude};
+            if (edge.startX == edge.endX && edge.startY == edge.endY) {
+                continue;
+            }
+
+            // Pass 1: clip the edge to each row band it spans and register the columns it covers
+            const double lowY = qMin(edge.startY, edge.endY);
+            const double highY = qMax(edge.startY, edge.endY);
+            const qint64 firstRow = cellY(lowY - EDGE_MARGIN * cellHeight);
+            const qint64 lastRow = cellY(highY + EDGE_MARGIN * cellHeight);
+            for (qint64 row = firstRow; row <= lastRow; ++row) {
+                double fromX = qMin(edge.startX, edge.endX);
+                double toX = qMax(edge.startX, edge.endX);
+                if (edge.startY != edge.endY) {
+                    const double bandLow = originY + (row - EDGE_MARGIN) * cellHeight;
+                    const double bandHigh = originY + (row + 1 + EDGE_MARGIN) * cellHeight;
+                    const double t0 = (bandLow - edge.startY) / (edge.endY - edge.startY);
+                    const double t1 = (bandHigh - edge.startY) / (edge.endY - edge.startY);
+                    const double tFrom = qMax(0.0, qMin(t0, t1));
+                    const double tTo = qMin(1.0, qMax(t0, t1));
+                    if (tFrom > tTo) {
+                        continue;
+                    }
+                    const double x0 = edge.startX + tFrom * (edge.endX - edge.startX);
+                    const double x1 = edge.startX + tTo * (edge.endX - edge.startX);
+                    fromX = qMin(x0, x1);
+                    toX = qMax(x0, x1);
+                }
+                const qint64 firstColumn = cellX(fromX - EDGE_MARGIN * cellWidth);
+                const qint64 lastColumn = cellX(toX + EDGE_MARGIN * cellWidth);
+                for (qint64 column = firstColumn; column <= lastColumn; ++column) {
+                    const quint32 cell = static_cast<quint32>(row * columns + column);
+                    pending.push_back(PendingEdge{cell, zoneIndex, edge});
+                    touchedBy[cell] = static_cast<qint32>(z);
+                }
+            }
+
+            // Crossings of the rows' reference latitudes, half-open like the usual crossing test
+            qint64 row = static_cast<qint64>(qMax(0.0, std::floor((lowY - originY) * inverseCellHeight - REFERENCE_FRACTION)));
+            for (; row < rows && referenceY(row) < highY; ++row) {
+                const double y = referenceY(row);
+                if ((edge.startY > y) != (edge.endY > y)) {
+                    crossings.emplace_back(row, edge.startX
+                        + (y - edge.startY) * (edge.endX - edge.startX) / (edge.endY - edge.startY));
+                }
+            }
+        }
+
+        // Pass 2: a reference point is inside when an odd number of crossings lie east of it
+        std::sort(crossings.begin(), crossings.end());
+        for (std::size_t i = 0; i + 1 < crossings.size(); i += 2) {
+            const qint64 row = crossings[i].first;
+            const double enter = crossings[i].second;
+            const double leave = crossings[i + 1].second;
+            qint64 column = static_cast<qint64>(qMax(0.0, std::floor((enter - originX) * inverseCellWidth - REFERENCE_FRACTION)));
+            while (column < columns && referenceX(column) < enter) {
+                ++column;
+            }
+            for (; column < columns && referenceX(column) < leave; ++column) {
+                const quint32 cell = static_cast<quint32>(row * columns + column);
+                if (touchedBy[cell] == static_cast<qint32>(z)) {
+                    insideReferences.emplace_back(cell, zoneIndex);
+                } else if (zone.type == GeofenceZone::INCLUSION) {
+                    cellFlags[cell] |= FULL_INCLUSION;
+                } else if (!(cellFlags[cell] & FULL_EXCLUSION)) {
+                    cellFlags[cell] |= FULL_EXCLUSION;
+                    cellExclusion[cell] = static_cast<qint32>(z);
+                }
+            }
+        }
+    }
+
+    // Gather each cell's edges zone by zone. Cells with a constant answer
+    // keep none: a full exclusion decides the cell, and partial inclusion
+    // zones do not matter where another inclusion covers the whole cell.
+    std::sort(pending.begin(), pending.end(), [](const PendingEdge& a, const PendingEdge& b) {
+        return a.cell != b.cell ? a.cell < b.cell : a.zone < b.zone;
+    });
+    std::sort(insideReferences.begin(), insideReferences.end());
+
+    cells.resize(cellCount);
+    edges.reserve(pending.size());
+    std::size_t next = 0;
+    for (std::size_t cell = 0; cell < cellCount; ++cell) {
+        const std::size_t firstZone = cellZones.size();
+        while (next < pending.size() && pending[next].cell == cell) {
+            const quint32 zone = pending[next].zone;
+            std::size_t last = next;
+            while (last < pending.size() && pending[last].cell == cell && pending[last].zone == zone) {
+                ++last;
+            }
+
+            const bool exclusion = zones[zone].type == GeofenceZone::EXCLUSION;
+            const bool decided = (cellFlags[cell] & FULL_EXCLUSION)
+                || (!exclusion && (cellFlags[cell] & FULL_INCLUSION));
+            if (!decided) {
+                const bool referenceInside = std::binary_search(insideReferences.begin(), insideReferences.end(),
+                    std::make_pair(static_cast<quint32>(cell), zone));
+                cellZones.push_back(CellZone{zone, static_cast<quint32>(edges.size()),
+                                             static_cast<quint32>(last - next), exclusion, referenceInside});
+                const double x = referenceX(static_cast<qint64>(cell) % columns);
+                const double y = referenceY(static_cast<qint64>(cell) / columns);
+                for (std::size_t i = next; i < last; ++i) {
+                    const Edge& edge = pending[i].edge;
+                    if (orientation(edge.startX, edge.startY, edge.endX, edge.endY, x, y) < 0.0) {
+                        edges.push_back(Edge{edge.endX, edge.endY, edge.startX, edge.startY});
+                    } else {
+                        edges.push_back(edge);
+                    }
+                }
+            }
+            next = last;
+        }
+        cells[cell].firstZone = static_cast<quint32>(firstZone);
+        cells[cell].countFlags = static_cast<quint32>((cellZones.size() - firstZone) << CELL_FLAG_BITS) | cellFlags[cell];
+    }
+    edges.shrink_to_fit();
+}
+
+bool Geofence::insideZone(const CellZone& entry, double x, double y, double referenceXValue,
+                          double referenceYValue) const {
+    // Parity of the zone edges crossing the segment from the reference
+    // point. Edges are stored with the reference on their left, so an edge
+    // is crossed when its ends straddle the segment's line and the point is
+    // on its right. An edge end exactly on that line counts as left of it,
+    // so a segment through a vertex crosses zero or two edges there, never
+    // one. Points on the boundary are inside.
+    bool inside = entry.referenceInside;
+    const Edge* edge = edges.data() + entry.firstEdge;
+    for (quint32 i = 0; i < entry.edgeCount; ++i, ++edge) {
+        const double startSide = orientation(referenceXValue, referenceYValue, x, y, edge->startX, edge->startY);
+        const double endSide = orientation(referenceXValue, referenceYValue, x, y, edge->endX, edge->endY);
+        const double pointSide = orientation(edge->startX, edge->startY, edge->endX, edge->endY, x, y);
+        const bool straddles = (startSide < 0.0) != (endSide < 0.0);
+        if ((straddles && pointSide == 0.0) || (edge->startX == x && edge->startY == y)
+            || (edge->endX == x && edge->endY == y)) {
+            return true;
+        }
+        inside ^= straddles & (pointSide < 0.0);
+    }
+    return inside;
+}
+
+Geofence::Status Geofence::classify(double latitude, double longitude, int* zone) const {
+    if (zone) {
+        *zone = -1;
+    }
+    if (cells.empty()) {
+        return CLEAR;
+    }
+
+    // Outside the grid no zone can contain the point (NaN ends up here too)
+    const double fx = (longitude - originX) * inverseCellWidth;
+    const double fy = (latitude - originY) * inverseCellHeight;
+    if (!(fx >= 0.0 && fx < columns && fy >= 0.0 && fy < rows)) {
+        return inclusionZones ? OUTSIDE_INCLUSION : CLEAR;
+    }
+    const qint64 column = static_cast<qint64>(fx);
+    const qint64 row = static_cast<qint64>(fy);
+    const std::size_t cell = static_cast<std::size_t>(row * columns + column);
+
+    const Cell& gridCell = cells[cell];
+    if (gridCell.countFlags & FULL_EXCLUSION) {
+        if (zone) {
+            *zone = cellExclusion[cell];
+        }
+        return INSIDE_EXCLUSION;
+    }
+
+    bool included = !inclusionZones || (gridCell.countFlags & FULL_INCLUSION);
+    const double x = referenceX(column);
+    const double y = referenceY(row);
+    const CellZone* entry = cellZones.data() + gridCell.firstZone;
+    const CellZone* lastEntry = entry + (gridCell.countFlags >> CELL_FLAG_BITS);
+    for (; entry != lastEntry; ++entry) {
+        if (entry->exclusion) {
+            if (insideZone(*entry, longitude, latitude, x, y)) {
+                if (zone) {
+                    *zone = static_cast<int>(entry->zone);
+                }
+                return INSIDE_EXCLUSION;
+            }
+        } else if (!included) {
+            included = insideZone(*entry, longitude, latitude, x, y);
+        }
+    }
+    return included ? CLEAR : OUTSIDE_INCLUSION;
+}
+
+void Geofence::classify(const double* latitudes, const double* longitudes, std::size_t count,
+                        quint8* status) const {
+    // A lone box (including the built-in operating area) is a branch-free range check
+    if (permittedIsBox) {
+        const quint8 outside = inclusionZones ? OUTSIDE_INCLUSION : CLEAR;
+        const GeofenceBounds& box = permittedBounds;
+        for (std::size_t i = 0; i < count; ++i) {
+            const bool inside = (latitudes[i] >= box.minLatitude) & (latitudes[i] <= box.maxLatitude)
+                & (longitudes[i] >= box.minLongitude) & (longitudes[i] <= box.maxLongitude);
+            status[i] = inside ? quint8(CLEAR) : outside;
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        status[i] = static_cast<quint8>(classify(latitudes[i], longitudes[i]));
+    }
+}
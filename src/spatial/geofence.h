@@ -0,0 +1,156 @@
+#ifndef GEOFENCE_H
+#define GEOFENCE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <cstddef>
+#include <vector>
+
+// One geofence polygon. Edges are straight in latitude/longitude and the
+// boundary belongs to the zone. The polygon is closed implicitly (the last
+// vertex connects back to the first); it may be concave but should not
+// intersect itself.
+struct GeofenceZone {
+    enum Type {
+        INCLUSION = 0,  // drones must stay inside one of these (when any exist)
+        EXCLUSION = 1   // drones must stay out of all of these
+    };
+
+    struct Vertex {
+        double latitude;
+        double longitude;
+    };
+
+    QString name;
+    Type type;
+    std::vector<Vertex> vertices;
+};
+
+// Latitude/longitude box
+struct GeofenceBounds {
+    double minLatitude;
+    double maxLatitude;
+    double minLongitude;
+    double maxLongitude;
+};
+
+// Compiled set of inclusion and exclusion zones with a uniform grid over
+// their bounding box for constant-time containment. Building the grid
+// classifies every cell: cells no zone edge touches are wholly inside or
+// outside each zone and store the answer outright; the remaining cells keep
+// the few edges that cross them plus, per zone, whether a reference point in
+// the cell is inside. A point in such a cell is inside a zone when the
+// reference is, flipped once for every zone edge the segment between them
+// crosses, so a query only looks at edges within its own cell. The grid has
+// a few cells per edge, so the work per point stays about constant however
+// many zones and vertices there are. A Geofence is immutable once built and
+// may be shared between threads.
+class Geofence {
+public:
+    // Per-drone result, one byte per drone in batch classification
+    enum Status {
+        CLEAR = 0,
+        OUTSIDE_INCLUSION = 1,  // inclusion zones exist and none contains the point
+        INSIDE_EXCLUSION = 2
+    };
+
+    // Grid cells per zone edge, and the cap on the grid as a whole
+    static constexpr std::size_t CELLS_PER_EDGE = 4;
+    static constexpr std::size_t MAX_GRID_CELLS = std::size_t(1) << 21;
+
+    // No zones: every point is clear
+    Geofence();
+    explicit Geofence(const std::vector<GeofenceZone>& zones);
+
+    // The built-in operating area, an inclusion box over 28.4-29.0 N, 77.0-78.0 E
+    static std::vector<GeofenceZone> defaultZones();
+    static const Geofence& operatingArea();
+
+    static GeofenceZone box(const QString& name, GeofenceZone::Type type, const GeofenceBounds& bounds);
+
+    // Parses a JSON zone file (format in the README); on failure `error` says why
+    static bool parseZones(const QByteArray& json, std::vector<GeofenceZone>& zones, QString& error);
+    static bool loadZones(const QString& filename, std::vector<GeofenceZone>& zones, QString& error);
+
+    const std::vector<GeofenceZone>& getZones() const { return zones; }
+    std::size_t getEdgeCount() const { return edgeCount; }
+    std::size_t getCellCount() const { return cells.size(); }
+    bool hasInclusionZones() const { return inclusionZones; }
+
+    // Box a drone can stay in without leaving every inclusion zone: the
+    // inclusion zones' bounding box, or the whole globe when there are none
+    GeofenceBounds getPermittedBounds() const;
+    // True when the permitted area is exactly getPermittedBounds(), so
+    // clamping to the box is the whole check
+    bool isBox() const { return permittedIsBox; }
+
+    // Status of one point; `zone`, when given, receives the exclusion zone
+    // breached (one of them if several overlap) or -1
+    Status classify(double latitude, double longitude, int* zone = nullptr) const;
+
+    // Status of `count` points into status[i]
+    void classify(const double* latitudes, const double* longitudes, std::size_t count,
+                  quint8* status) const;
+
+private:
+    // A zone edge copied into every cell it touches, so a cell's edges are contiguous
+    struct Edge {
+        double startX;   // longitude
+        double startY;   // latitude
+        double endX;
+        double endY;
+    };
+
+    // One zone whose boundary crosses a cell
+    struct CellZone {
+        quint32 zone;
+        quint32 firstEdge;
+        quint32 edgeCount;
+        bool exclusion;
+        bool referenceInside;
+    };
+
+    enum CellFlag {
+        FULL_INCLUSION = 1,  // the whole cell lies inside an inclusion zone
+        FULL_EXCLUSION = 2,  // the whole cell lies inside exclusion zone cellExclusion[cell]
+        CELL_FLAG_BITS = 2
+    };
+
+    // A query reads one of these, and nothing else when the cell is constant
+    struct Cell {
+        quint32 firstZone;   // into cellZones
+        quint32 countFlags;  // zone count << CELL_FLAG_BITS | CellFlag bits
+    };
+
+    void build();
+    qint64 cellX(double longitude) const;
+    qint64 cellY(double latitude) const;
+    double referenceX(qint64 column) const;
+    double referenceY(qint64 row) const;
+    bool insideZone(const CellZone& entry, double x, double y, double referenceXValue,
+                    double referenceYValue) const;
+
+    std::vector<GeofenceZone> zones;
+    std::size_t edgeCount;
+    bool inclusionZones;
+    bool permittedIsBox;
+    GeofenceBounds permittedBounds;
+
+    // Grid over the zones' bounding box, row-major, longitude along a row
+    double originX;
+    double originY;
+    double cellWidth;
+    double cellHeight;
+    double inverseCellWidth;
+    double inverseCellHeight;
+    qint64 columns;
+    qint64 rows;
+
+    std::vector<Cell> cells;
+    std::vector<qint32> cellExclusion;
+    std::vector<CellZone> cellZones;
+    std::vector<Edge> edges;
+};
+
+#endif // GEOFENCE_H
@@ -0,0 +1,261 @@
+#include "spatialgrid.h"
+#include "fleetstate.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Mean Earth radius; the local plane is accurate to well under 1% across a few tens of km
+const double EARTH_RADIUS_METERS = 6371000.0;
+const double METERS_PER_DEGREE_LATITUDE = EARTH_RADIUS_METERS * M_PI / 180.0;
+
+const double MIN_CELL_SIZE_METERS = 0.01;
+
+// Keeps cell coordinates of absurd or non-finite positions within 32 bits
+// (2^30 cells of the smallest size still span about 10,000 km)
+const double MAX_CELL_COORDINATE = 1073741824.0;  // 2^30
+
+std::size_t bucketCountFor(std::size_t items) {
+    std::size_t buckets = 1;
+    while (buckets < items) {
+        buckets <<= 1;
+    }
+    return buckets;
+}
+}
+
+SpatialGrid::SpatialGrid(double cellSizeMeters)
+    : cellSize(DEFAULT_CELL_SIZE_METERS)
+    , inverseCellSize(1.0 / DEFAULT_CELL_SIZE_METERS)
+    , originLatitude(0.0)
+    , originLongitude(0.0)
+    , metersPerDegreeLongitude(METERS_PER_DEGREE_LATITUDE)
+    , bucketMask(0)
+{
+    setCellSize(cellSizeMeters);
+    clear();
+}
+
+void SpatialGrid::setCellSize(double meters) {
+    cellSize = qMax(meters, MIN_CELL_SIZE_METERS);
+    inverseCellSize = 1.0 / cellSize;
+}
+
+double SpatialGrid::getCellSize() const {
+    return cellSize;
+}
+
+void SpatialGrid::clear() {
+    bucketMask = 0;
+    bucketStart.assign(2, 0);
+    items.clear();
+}
+
+void SpatialGrid::rebuild(const FleetState& fleet) {
+    const std::size_t count = fleet.size();
+    if (count == 0) {
+        clear();
+        return;
+    }
+
+    const double* latitude = fleet.latitudes();
+    const double* longitude = fleet.longitudes();
+    const double* altitude = fleet.altitudes();
+
+    // Project about the centre of the fleet's bounding box to keep distortion low
+    double minLatitude = latitude[0], maxLatitude = latitude[0];
+    double minLongitude = longitude[0], maxLongitude = longitude[0];
+    for (std::size_t i = 1; i < count; ++i) {
+        minLatitude = qMin(minLatitude, latitude[i]);
+        maxLatitude = qMax(maxLatitude, latitude[i]);
+        minLongitude = qMin(minLongitude, longitude[i]);
+        maxLongitude = qMax(maxLongitude, longitude[i]);
+    }
+    originLatitude = 0.5 * (minLatitude + maxLatitude);
+    originLongitude = 0.5 * (minLongitude + maxLongitude);
+    metersPerDegreeLongitude = METERS_PER_DEGREE_LATITUDE * std::cos(qDegreesToRadians(originLatitude));
+
+    // Counting sort by bucket: count, prefix-sum, scatter
+    const std::size_t bucketCount = bucketCountFor(count);
+    bucketMask = bucketCount - 1;
+    bucketStart.assign(bucketCount + 1, 0);
+    staged.resize(count);
+    stagedBucket.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        Item& item = staged[i];
+        item.east = eastMeters(longitude[i]);
+        item.north = northMeters(latitude[i]);
+        item.altitude = altitude[i];
+        item.index = i;
+        item.cellX = static_cast<qint32>(cellCoordinate(item.east));
+        item.cellY = static_cast<qint32>(cellCoordinate(item.north));
+        const std::size_t bucket = bucketOf(item.cellX, item.cellY);
+        stagedBucket[i] = static_cast<quint32>(bucket);
+        ++bucketStart[bucket + 1];
+    }
+    for (std::size_t bucket = 0; bucket < bucketCount; ++bucket) {
+        bucketStart[bucket + 1] += bucketStart[bucket];
+    }
+
+    items.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        items[bucketStart[stagedBucket[i]]++] = staged[i];
+    }
+
+    // The scatter advanced every start to the next bucket's start; shift back
+    for (std::size_t bucket = bucketCount; bucket > 0; --bucket) {
+        bucketStart[bucket] = bucketStart[bucket - 1];
+    }
+    bucketStart[0] = 0;
+}
+
+void SpatialGrid::queryRadius(double latitude, double longitude, double altitude, double radiusMeters,
+                              std::vector<std::size_t>& out) const {
+    if (isEmpty() || !(radiusMeters >= 0.0)) {
+        return;
+    }
+
+    const double east = eastMeters(longitude);
+    const double north = northMeters(latitude);
+    const double radiusSquared = radiusMeters * radiusMeters;
+    forEachInCells(cellCoordinate(east - radiusMeters), cellCoordinate(north - radiusMeters),
+                   cellCoordinate(east + radiusMeters), cellCoordinate(north + radiusMeters),
+                   [&](std::size_t slot) {
+        const Item& item = items[slot];
+        const double dx = item.east - east;
+        const double dy = item.north - north;
+        const double dz = item.altitude - altitude;
+        if (dx * dx + dy * dy + dz * dz <= radiusSquared) {
+            out.push_back(item.index);
+        }
+    });
+}
+
+void SpatialGrid::findPairsWithin(double radiusMeters,
+                                  std::vector<std::pair<std::size_t, std::size_t>>& out) const {
+    if (isEmpty() || !(radiusMeters >= 0.0)) {
+        return;
+    }
+
+    const double radiusSquared = radiusMeters * radiusMeters;
+    auto consider = [&](const Item& a, const Item& b) {
+        const double dx = a.east - b.east;
+        const double dy = a.north - b.north;
+        const double dz = a.altitude - b.altitude;
+        if (dx * dx + dy * dy + dz * dz <= radiusSquared) {
+            out.emplace_back(qMin(a.index, b.index), qMax(a.index, b.index));
+        }
+    };
+
+    // A radius spanning more cells than there are buckets degenerates to all pairs
+    const double reachCells = std::ceil(radiusMeters * inverseCellSize);
+    const double bucketCount = static_cast<double>(bucketMask + 1);
+    if ((2.0 * reachCells + 1.0) * (reachCells + 1.0) > bucketCount) {
+        for (std::size_t slot = 0; slot < items.size(); ++slot) {
+            for (std::size_t other = slot + 1; other < items.size(); ++other) {
+                consider(items[slot], items[other]);
+            }
+        }
+        return;
+    }
+
+    // Forward half-neighbourhood: the own cell, cells to the east on the same
+    // row, and the full rows to the north. Every pair is seen from one side only.
+    const qint64 reach = static_cast<qint64>(reachCells);
+    for (std::size_t slot = 0; slot < items.size(); ++slot) {
+        const Item& item = items[slot];
+        for (qint64 dy = 0; dy <= reach; ++dy) {
+            for (qint64 dx = dy == 0 ? 0 : -reach; dx <= reach; ++dx) {
+                const qint64 cellX = item.cellX + dx;
+                const qint64 cellY = item.cellY + dy;
+                const std::size_t bucket = bucketOf(cellX, cellY);
+                for (quint32 other = bucketStart[bucket]; other < bucketStart[bucket + 1]; ++other) {
+                    const Item& candidate = items[other];
+                    if (candidate.cellX != cellX || candidate.cellY != cellY) {
+                        continue;
+                    }
+                    // Within the own cell, pair each drone only with the ones after it
+                    if (dx == 0 && dy == 0 && other <= slot) {
+                        continue;
+                    }
+                    consider(item, candidate);
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::queryBox(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude,
+                           std::vector<std::size_t>& out) const {
+    if (isEmpty() || minLatitude > maxLatitude || minLongitude > maxLongitude) {
+        return;
+    }
+
+    // The projection is linear per axis, so the box stays a box on the plane
+    const double minEast = eastMeters(minLongitude);
+    const double maxEast = eastMeters(maxLongitude);
+    const double minNorth = northMeters(minLatitude);
+    const double maxNorth = northMeters(maxLatitude);
+    forEachInCells(cellCoordinate(minEast), cellCoordinate(minNorth),
+                   cellCoordinate(maxEast), cellCoordinate(maxNorth),
+                   [&](std::size_t slot) {
+        const Item& item = items[slot];
+        if (item.east >= minEast && item.east <= maxEast
+            && item.north >= minNorth && item.north <= maxNorth) {
+            out.push_back(item.index);
+        }
+    });
+}
+
+double SpatialGrid::eastMeters(double longitude) const {
+    return (longitude - originLongitude) * metersPerDegreeLongitude;
+}
+
+double SpatialGrid::northMeters(double latitude) const {
+    return (latitude - originLatitude) * METERS_PER_DEGREE_LATITUDE;
+}
+
+qint64 SpatialGrid::cellCoordinate(double meters) const {
+    double cell = std::floor(meters * inverseCellSize);
+    if (!(cell > -MAX_CELL_COORDINATE)) {
+        cell = -MAX_CELL_COORDINATE;  // also catches NaN
+    } else if (cell > MAX_CELL_COORDINATE) {
+        cell = MAX_CELL_COORDINATE;
+    }
+    return static_cast<qint64>(cell);
+}
+
+std::size_t SpatialGrid::bucketOf(qint64 cellX, qint64 cellY) const {
+    quint64 hash = static_cast<quint64>(cellX) * 0x9E3779B97F4A7C15ULL
+                 + static_cast<quint64>(cellY) * 0xC2B2AE3D27D4EB4FULL;
+    hash ^= hash >> 29;
+    return static_cast<std::size_t>(hash) & bucketMask;
+}
+
+template <typename Visitor>
+void SpatialGrid::forEachInCells(qint64 minCellX, qint64 minCellY, qint64 maxCellX, qint64 maxCellY,
+                                 Visitor visit) const {
+    const quint64 cellsX = static_cast<quint64>(maxCellX - minCellX) + 1;
+    const quint64 cellsY = static_cast<quint64>(maxCellY - minCellY) + 1;
+    const quint64 buckets = bucketMask + 1;
+
+    // A range with more cells than buckets revisits buckets; one linear pass is cheaper
+    if (cellsX > buckets || cellsY > buckets || cellsX * cellsY > buckets) {
+        for (std::size_t slot = 0; slot < items.size(); ++slot) {
+            visit(slot);
+        }
+        return;
+    }
+
+    for (qint64 cellY = minCellY; cellY <= maxCellY; ++cellY) {
+        for (qint64 cellX = minCellX; cellX <= maxCellX; ++cellX) {
+            const std::size_t bucket = bucketOf(cellX, cellY);
+            for (quint32 slot = bucketStart[bucket]; slot < bucketStart[bucket + 1]; ++slot) {
+                // Buckets are shared by colliding cells; only visit this cell's drones once
+                if (items[slot].cellX == cellX && items[slot].cellY == cellY) {
+                    visit(slot);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <QtGlobal>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+class FleetState;
+
+// Uniform hash grid over fleet positions for proximity queries.
+// rebuild() projects latitude/longitude onto a local east/north plane in
+// metres (equirectangular about the fleet's centre), buckets every drone by
+// its grid cell with a counting sort, and stores the positions in bucket
+// order so a query scans contiguous memory. Cells are hashed into a table
+// sized to the fleet, so memory follows the drone count rather than the
+// area covered. A rebuild is two linear passes; it is meant to run once
+// per tick after movement.
+class SpatialGrid {
+public:
+    static constexpr double DEFAULT_CELL_SIZE_METERS = 100.0;
+
+    explicit SpatialGrid(double cellSizeMeters = DEFAULT_CELL_SIZE_METERS);
+
+    // Takes effect on the next rebuild(); ideally close to the typical query radius
+    void setCellSize(double meters);
+    double getCellSize() const;
+
+    void rebuild(const FleetState& fleet);
+    void clear();
+
+    std::size_t size() const { return items.size(); }
+    bool isEmpty() const { return items.empty(); }
+
+    // Appends the fleet indices of drones within radiusMeters (3D distance,
+    // altitude included) of the point. Order is unspecified.
+    void queryRadius(double latitude, double longitude, double altitude, double radiusMeters,
+                     std::vector<std::size_t>& out) const;
+
+    // Appends the fleet indices of drones inside the latitude/longitude box
+    void queryBox(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude,
+                  std::vector<std::size_t>& out) const;
+
+    // Appends every pair of drones within radiusMeters of each other (3D),
+    // once each as (lower fleet index, higher). Each drone is compared only
+    // against its own cell and the forward half of its neighbourhood, so the
+    // cost follows the number of nearby pairs rather than the fleet squared.
+    void findPairsWithin(double radiusMeters,
+                         std::vector<std::pair<std::size_t, std::size_t>>& out) const;
+
+    // Local plane coordinates of a point, in metres from the grid origin
+    double eastMeters(double longitude) const;
+    double northMeters(double latitude) const;
+
+private:
+    // One drone in bucket order; a query touches one line per candidate
+    struct Item {
+        double east;
+        double north;
+        double altitude;
+        std::size_t index;
+        qint32 cellX;
+        qint32 cellY;
+    };
+
+    qint64 cellCoordinate(double meters) const;
+    std::size_t bucketOf(qint64 cellX, qint64 cellY) const;
+
+    // Calls visit(slot) for every stored drone in the cell range
+    template <typename Visitor>
+    void forEachInCells(qint64 minCellX, qint64 minCellY, qint64 maxCellX, qint64 maxCellY,
+                        Visitor visit) const;
+
+    double cellSize;
+    double inverseCellSize;
+    double originLatitude;
+    double originLongitude;
+    double metersPerDegreeLongitude;
+    std::size_t bucketMask;
+
+    // bucketStart[b]..bucketStart[b + 1] are the slots of bucket b
+    std::vector<quint32> bucketStart;
+    std::vector<Item> items;
+
+    // Rebuild scratch in fleet order, kept to avoid reallocating every tick
+    std::vector<Item> staged;
+    std::vector<quint32> stagedBucket;
+};
+
+#endif // SPATIALGRID_H
@@ -0,0 +1,323 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "dronesimulator.h"
+#include "dronedata.h"
+#include "fleetstate.h"
+#include "hoverstrategy.h"
+#include "randomwalkstrategy.h"
+#include "geofence.h"
+#include "logger.h"
+#include "observer.h"
+
+// Throughput benchmarks for the per-tick hot paths. Fleet sizes default to
+// DEFAULT_FLEET_SIZES and can be replaced with a comma-separated list in
+// DRONE_BENCH_FLEETS. Run with e.g. `-o results.xml,xml` or `-csv` for
+// machine-readable results; every row is named after its parameters so
+// results line up across versions.
+namespace {
+
+const char* const DEFAULT_FLEET_SIZES = "100,10000,100000";
+
+// Simulated ticks run on one thread so results compare across machines
+constexpr int BENCHMARK_THREADS = 1;
+
+// Messages each logging thread writes per benchmark iteration
+constexpr int MESSAGES_PER_THREAD = 2000;
+
+std::vector<int> fleetSizes() {
+    QByteArray list = qgetenv("DRONE_BENCH_FLEETS");
+    if (list.isEmpty()) {
+        list = DEFAULT_FLEET_SIZES;
+    }
+
+    std::vector<int> sizes;
+    for (const QByteArray& entry : list.split(',')) {
+        bool ok = false;
+        const int size = entry.trimmed().toInt(&ok);
+        if (ok && size > 0) {
+            sizes.push_back(size);
+        }
+    }
+    return sizes;
+}
+
+FleetState makeFleet(int size) {
+    // Spread over the operating area so geofence cells are all exercised
+    FleetState fleet;
+    fleet.reserve(static_cast<std::size_t>(size));
+    const int columns = qMax(1, qCeil(qSqrt(static_cast<double>(size))));
+    for (int i = 0; i < size; ++i) {
+        const double lat = 28.41 + 0.58 * (i / columns) / columns;
+        const double lon = 77.01 + 0.98 * (i % columns) / columns;
+        fleet.addDrone(DroneData(QString("DRONE-%1").arg(i), lat, lon, 100.0,
+                                 0.0, 5.0, 100.0, GPSFixStatus::FIX_3D));
+    }
+    return fleet;
+}
+
+// The operating area with `count` small exclusion boxes scattered over it
+std::shared_ptr<const Geofence> scatteredZones(int count) {
+    std::vector<GeofenceZone> zones = Geofence::defaultZones();
+    const int columns = qMax(1, qCeil(qSqrt(static_cast<double>(count))));
+    for (int i = 0; i < count; ++i) {
+        const double lat = 28.4 + 0.6 * ((i / columns) + 0.25) / columns;
+        const double lon = 77.0 + 1.0 * ((i % columns) + 0.25) / columns;
+        zones.push_back(Geofence::box(QString("zone-%1").arg(i), GeofenceZone::EXCLUSION,
+                                      {lat, lat + 0.3 / columns, lon, lon + 0.5 / columns}));
+    }
+    return std::make_shared<const Geofence>(zones);
+}
+
+// Reads the shared snapshot like a fleet-aware observer (map, recorder)
+class SnapshotObserver : public Observer {
+public:
+    void update(const DroneData& data) override { lastBattery = data.getBattery(); }
+    void updateFleet(const FleetSnapshotPtr& snapshot) override {
+        lastBattery = snapshot->batteries()[0];
+    }
+    double lastBattery = 0.0;
+};
+
+// Keeps the default per-drone fan-out, like the legacy single-drone observers
+class PerDroneObserver : public Observer {
+public:
+    void update(const DroneData& data) override { batterySum += data.getBattery(); }
+    double batterySum = 0.0;
+};
+
+void discardMessages(QtMsgType, const QMessageLogContext&, const QString&) {}
+
+} // namespace
+
+class BenchmarkSimulation : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void benchmarkTick_data();
+    void benchmarkTick();
+    void benchmarkNotify_data();
+    void benchmarkNotify();
+    void benchmarkMovement_data();
+    void benchmarkMovement();
+    void benchmarkLoggerContention_data();
+    void benchmarkLoggerContention();
+    void benchmarkDroneDataCopy_data();
+    void benchmarkDroneDataCopy();
+
+private:
+    QTemporaryDir logDir;
+};
+
+void BenchmarkSimulation::initTestCase() {
+    QVERIFY(logDir.isValid());
+    QVERIFY(!fleetSizes().empty());
+
+    // Keep the simulator's INFO lines out of the benchmark log
+    Logger& logger = Logger::getInstance();
+    logger.setLogFile(logDir.filePath("benchmark.log"));
+    logger.setLogLevel(Logger::WARNING);
+}
+
+void BenchmarkSimulation::cleanupTestCase() {
+    Logger& logger = Logger::getInstance();
+    logger.setAsync(false);
+    logger.setLogLevel(Logger::INFO);
+}
+
+void BenchmarkSimulation::benchmarkTick_data() {
+    QTest::addColumn<int>("fleetSize");
+    QTest::addColumn<QString>("strategy");
+
+    for (int size : fleetSizes()) {
+        for (const char* strategy : {"hover", "randomwalk"}) {
+            QTest::addRow("%d drones, %s", size, strategy) << size << QString(strategy);
+        }
+    }
+}
+
+void BenchmarkSimulation::benchmarkTick() {
+    QFETCH(int, fleetSize);
+    QFETCH(QString, strategy);
+
+    // One step of updateTelemetry(): movement, batteries, alert rules and
+    // publication, without waiting on the timer
+    DroneSimulator simulator;
+    simulator.setTickLogging(false);
+    simulator.setThreadCount(BENCHMARK_THREADS);
+    simulator.setRandomSeed(42);
+    if (strategy == "hover") {
+        simulator.setMovementStrategy(std::make_unique<HoverStrategy>());
+    } else {
+        simulator.setMovementStrategy(std::make_unique<RandomWalkStrategy>());
+    }
+    simulator.setFleetSize(static_cast<std::size_t>(fleetSize));
+    simulator.runTicks(1);
+
+    QBENCHMARK {
+        simulator.runTicks(1);
+    }
+    QVERIFY(simulator.getUpdateCount() > 1);
+}
+
+void BenchmarkSimulation::benchmarkNotify_data() {
+    QTest::addColumn<int>("fleetSize");
+    QTest::addColumn<int>("observerCount");
+    QTest::addColumn<bool>("perDrone");
+
+    for (int size : fleetSizes()) {
+        for (int observers : {1, 16, 256}) {
+            QTest::addRow("%d drones, %d snapshot observers", size, observers) << size << observers << false;
+        }
+        QTest::addRow("%d drones, 1 per-drone observer", size) << size << 1 << true;
+    }
+}
+
+void BenchmarkSimulation::benchmarkNotify() {
+    QFETCH(int, fleetSize);
+    QFETCH(int, observerCount);
+    QFETCH(bool, perDrone);
+
+    DroneSimulator simulator;
+    simulator.setTickLogging(false);
+    simulator.setFleetSize(static_cast<std::size_t>(fleetSize));
+
+    std::vector<std::unique_ptr<Observer>> observers;
+    for (int i = 0; i < observerCount; ++i) {
+        if (perDrone) {
+            observers.push_back(std::make_unique<PerDroneObserver>());
+        } else {
+            observers.push_back(std::make_unique<SnapshotObserver>());
+        }
+        simulator.attach(observers.back().get());
+    }
+
+    // The tick's snapshot is captured once; this measures the fan-out
+    simulator.notify();
+    QBENCHMARK {
+        simulator.notify();
+    }
+
+    for (const std::unique_ptr<Observer>& observer : observers) {
+        simulator.detach(observer.get());
+    }
+}
+
+void BenchmarkSimulation::benchmarkMovement_data() {
+    QTest::addColumn<int>("fleetSize");
+    QTest::addColumn<QString>("strategy");
+    QTest::addColumn<int>("exclusionZones");
+
+    for (int size : fleetSizes()) {
+        QTest::addRow("%d drones, hover", size) << size << QString("hover") << 0;
+        QTest::addRow("%d drones, randomwalk", size) << size << QString("randomwalk") << 0;
+        QTest::addRow("%d drones, randomwalk, 1000 zones", size) << size << QString("randomwalk") << 1000;
+    }
+}
+
+void BenchmarkSimulation::benchmarkMovement() {
+    QFETCH(int, fleetSize);
+    QFETCH(QString, strategy);
+    QFETCH(int, exclusionZones);
+
+    FleetState fleet = makeFleet(fleetSize);
+    std::unique_ptr<MovementStrategy> movement;
+    if (strategy == "hover") {
+        movement = std::make_unique<HoverStrategy>();
+    } else {
+        movement = std::make_unique<RandomWalkStrategy>();
+    }
+    const std::shared_ptr<const Geofence> fence = exclusionZones > 0 ? scatteredZones(exclusionZones) : nullptr;
+
+    TickContext context{0, 42, MovementStrategy::REFERENCE_STEP_SECONDS, fence.get()};
+    QBENCHMARK {
+        ++context.tick;
+        movement->prepare(fleet, context);
+        movement->updatePositions(fleet, 0, fleet.size(), context);
+    }
+    QVERIFY(context.tick > 0);
+}
+
+void BenchmarkSimulation::benchmarkLoggerContention_data() {
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<bool>("async");
+
+    for (int threads : {1, 4, 16}) {
+        QTest::addRow("%d threads, sync", threads) << threads << false;
+        QTest::addRow("%d threads, async", threads) << threads << true;
+    }
+}
+
+void BenchmarkSimulation::benchmarkLoggerContention() {
+    QFETCH(int, threads);
+    QFETCH(bool, async);
+
+    Logger& logger = Logger::getInstance();
+    logger.setOverflowPolicy(Logger::BLOCK);
+    logger.setAsync(async);
+
+    // Console output goes to the test log otherwise; the file write is kept
+    const QtMessageHandler previousHandler = qInstallMessageHandler(discardMessages);
+    QBENCHMARK {
+        std::vector<std::thread> producers;
+        for (int t = 0; t < threads; ++t) {
+            producers.emplace_back([&logger, t]() {
+                for (int i = 0; i < MESSAGES_PER_THREAD; ++i) {
+                    logger.log(Logger::WARNING, QString("Benchmark message %1/%2").arg(t).arg(i));
+                }
+            });
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        logger.flush();
+    }
+    qInstallMessageHandler(previousHandler);
+
+    logger.setAsync(false);
+}
+
+void BenchmarkSimulation::benchmarkDroneDataCopy_data() {
+    QTest::addColumn<int>("fleetSize");
+    QTest::addColumn<bool>("fromFleet");
+
+    for (int size : fleetSizes()) {
+        QTest::addRow("%d drones, vector copy", size) << size << false;
+        QTest::addRow("%d drones, fleet views", size) << size << true;
+    }
+}
+
+void BenchmarkSimulation::benchmarkDroneDataCopy() {
+    QFETCH(int, fleetSize);
+    QFETCH(bool, fromFleet);
+
+    const FleetState fleet = makeFleet(fleetSize);
+    std::vector<DroneData> drones;
+    drones.reserve(fleet.size());
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        drones.push_back(fleet.view(i));
+    }
+
+    std::vector<DroneData> copies;
+    if (fromFleet) {
+        // What the per-drone observer path materializes every tick
+        QBENCHMARK {
+            copies.clear();
+            for (std::size_t i = 0; i < fleet.size(); ++i) {
+                copies.push_back(fleet.view(i));
+            }
+        }
+    } else {
+        QBENCHMARK {
+            copies = drones;
+        }
+    }
+    QCOMPARE(copies.size(), drones.size());
+}
+
+QTEST_MAIN(BenchmarkSimulation)
+#include "benchmark_simulation.moc"
@@ -0,0 +1,74 @@
+#include <QtTest/QtTest>
+#include "alertkernels.h"
+#include "movementkernels.h"
+#include <vector>
+
+class TestAlerts : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testAlertKernels();
+};
+
+void TestAlerts::testAlertKernels() {
+    const std::size_t count = 901;  // a partial last word and an unused one
+    std::vector<double> column(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        column[i] = static_cast<double>(i % 7);
+    }
+    column[3] = qQNaN();
+
+    const MovementKernels::InstructionSet original = MovementKernels::activeInstructionSet();
+    for (int op = AlertCondition::LESS; op <= AlertCondition::NOT_EQUAL; ++op) {
+        const AlertCondition::Comparison comparison = static_cast<AlertCondition::Comparison>(op);
+        std::vector<std::vector<quint64>> masks;
+        for (int set = MovementKernels::SCALAR; set <= MovementKernels::detectedInstructionSet(); ++set) {
+            MovementKernels::setInstructionSet(static_cast<MovementKernels::InstructionSet>(set));
+            std::vector<quint64> bits(AlertProgram::BLOCK_WORDS, ~quint64(0));
+            AlertKernels::compare(column.data(), count, comparison, 3.0, bits.data(), bits.size());
+            masks.push_back(bits);
+        }
+
+        // Lane 900 holds 4; NaN only satisfies !=; words past the column are cleared
+        const std::vector<quint64>& bits = masks[0];
+        QCOMPARE((bits[900 / 64] >> (900 % 64)) & 1,
+                 quint64(op == AlertCondition::GREATER || op == AlertCondition::GREATER_EQUAL
+                         || op == AlertCondition::NOT_EQUAL));
+        QCOMPARE((bits[0] >> 3) & 1, quint64(op == AlertCondition::NOT_EQUAL));
+        QCOMPARE(bits[15], quint64(0));
+        for (std::size_t set = 1; set < masks.size(); ++set) {
+            QVERIFY(masks[set] == masks[0]);
+        }
+    }
+
+    // Byte columns match the comparison lane by lane, whatever the threshold
+    std::vector<quint8> bytes(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        bytes[i] = static_cast<quint8>(i % 5 == 4 ? 255 : i % 5);
+    }
+    for (double threshold : {2.0, 2.5, -1.0, 255.0, 300.0, qQNaN()}) {
+        for (int op = AlertCondition::LESS; op <= AlertCondition::NOT_EQUAL; ++op) {
+            for (int set = MovementKernels::SCALAR; set <= MovementKernels::detectedInstructionSet(); ++set) {
+                MovementKernels::setInstructionSet(static_cast<MovementKernels::InstructionSet>(set));
+                std::vector<quint64> bits(AlertProgram::BLOCK_WORDS, ~quint64(0));
+                AlertKernels::compare(bytes.data(), count, static_cast<AlertCondition::Comparison>(op),
+                                      threshold, bits.data(), bits.size());
+                for (std::size_t i = 0; i < count; ++i) {
+                    const double lane = bytes[i];
+                    const bool expected = op == AlertCondition::LESS ? lane < threshold
+                        : op == AlertCondition::LESS_EQUAL ? lane <= threshold
+                        : op == AlertCondition::GREATER ? lane > threshold
+                        : op == AlertCondition::GREATER_EQUAL ? lane >= threshold
+                        : op == AlertCondition::EQUAL ? lane == threshold : lane != threshold;
+                    QCOMPARE((bits[i / 64] >> (i % 64)) & 1, quint64(expected));
+                }
+                QCOMPARE(bits[count / 64] >> (count % 64), quint64(0));
+                QCOMPARE(bits[15], quint64(0));
+            }
+        }
+    }
+    MovementKernels::setInstructionSet(original);
+}
+
+QTEST_MAIN(TestAlerts)
+#include "test_alerts.moc"
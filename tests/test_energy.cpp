@@ -0,0 +1,52 @@
+#include <QtTest/QtTest>
+#include "energykernels.h"
+#include "movementkernels.h"
+#include <cstring>
+#include <vector>
+
+class TestEnergy : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testEnergyKernels();
+};
+
+void TestEnergy::testEnergyKernels() {
+    const std::size_t count = 37;
+    const EnergyKernels::PowerParams params{180.0, 0.15, 28.0, 10.0, 90.0, 1.0, 0.4, 0.5};
+    std::vector<double> altitude(count), speed(count), percentPerJoule(count, 100.0 / (77.0 * 3600.0));
+    for (std::size_t i = 0; i < count; ++i) {
+        altitude[i] = 100.0 + (i % 5) * 2.0 - 4.0;  // climbing, level and descending drones
+        speed[i] = i < 20 ? 0.0 : 0.25 * i;
+    }
+
+    std::vector<std::vector<double>> batteries;
+    const MovementKernels::InstructionSet original = MovementKernels::activeInstructionSet();
+    for (int set = MovementKernels::SCALAR; set <= MovementKernels::detectedInstructionSet(); ++set) {
+        MovementKernels::setInstructionSet(static_cast<MovementKernels::InstructionSet>(set));
+        std::vector<double> filtered(count, 100.0), drain(count);
+        std::vector<double> battery(count, 50.0);
+        battery[4] = 0.01;
+        EnergyKernels::PowerLanes lanes{altitude.data(), speed.data(), percentPerJoule.data(), filtered.data()};
+        EnergyKernels::powerDrain(params, lanes, drain.data(), count);
+
+        // Level, still drones pay exactly the hover load
+        QCOMPARE(drain[2], 180.0 * 0.5 * percentPerJoule[2]);
+        QVERIFY(drain[3] > drain[2]);    // climbing
+        QVERIFY(drain[1] < drain[2]);    // descending
+        QVERIFY(drain[36] > drain[31]);  // faster at the same climb rate
+
+        EnergyKernels::discharge(drain.data(), battery.data(), count);
+        QCOMPARE(battery[2], 50.0 - drain[2]);
+        QCOMPARE(battery[4], 0.0);  // never below empty
+        batteries.push_back(battery);
+    }
+    MovementKernels::setInstructionSet(original);
+
+    for (std::size_t set = 1; set < batteries.size(); ++set) {
+        QVERIFY(std::memcmp(batteries[0].data(), batteries[set].data(), count * sizeof(double)) == 0);
+    }
+}
+
+QTEST_MAIN(TestEnergy)
+#include "test_energy.moc"
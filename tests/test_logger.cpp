@@ -1,5 +1,7 @@
 #include <QtTest/QtTest>
 #include <QTemporaryFile>
+#include <thread>
+#include <vector>
 #include "logger.h"
 
 class TestLogger : public QObject {
@@ -9,6 +11,8 @@ private slots:
     void testSingleton();
     void testLogLevels();
     void testFileLogging();
+    void testAsyncLogging();
+    void testLevelGating();
 };
 
 void TestLogger::testSingleton() {
@@ -48,5 +52,69 @@ void TestLogger::testFileLogging() {
     QVERIFY(logFile.size() > 0);
 }
 
+void TestLogger::testAsyncLogging() {
+    QTemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    QString filename = tempFile.fileName();
+    tempFile.close();
+
+    Logger& logger = Logger::getInstance();
+    logger.setLogFile(filename);
+    logger.setOverflowPolicy(Logger::BLOCK);
+    logger.setAsync(true, 16);
+    QVERIFY(logger.isAsync());
+
+    // A tiny buffer forces producers to wait on the writer under BLOCK
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([&logger, t]() {
+            for (int i = 0; i < 250; ++i) {
+                logger.log(Logger::INFO, QString("Async message %1/%2").arg(t).arg(i));
+            }
+        });
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    logger.flush();
+
+    QFile logFile(filename);
+    QVERIFY(logFile.open(QIODevice::ReadOnly | QIODevice::Text));
+    int asyncLines = 0;
+    while (!logFile.atEnd()) {
+        if (logFile.readLine().contains("Async message")) {
+            ++asyncLines;
+        }
+    }
+    QCOMPARE(asyncLines, 1000);
+
+    logger.setAsync(false);
+    logger.setOverflowPolicy(Logger::DROP_AND_COUNT);
+    QVERIFY(!logger.isAsync());
+}
+
+void TestLogger::testLevelGating() {
+    Logger& logger = Logger::getInstance();
+    QCOMPARE(logger.getLogLevel(), Logger::INFO);
+    QVERIFY(!logger.isEnabled(Logger::DEBUG));
+    QVERIFY(logger.isEnabled(Logger::ERROR));
+
+    // Disabled levels never evaluate the message expression
+    int formatted = 0;
+    auto message = [&formatted]() {
+        ++formatted;
+        return QString("Formatted %1").arg(formatted);
+    };
+    LOG_DEBUG(message());
+    QCOMPARE(formatted, 0);
+    LOG_INFO(message());
+    QCOMPARE(formatted, 1);
+
+    logger.setLogLevel(Logger::WARNING);
+    LOG_INFO(message());
+    QCOMPARE(formatted, 1);
+    logger.setLogLevel(Logger::INFO);
+}
+
 QTEST_MAIN(TestLogger)
 #include "test_logger.moc"
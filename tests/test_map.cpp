@@ -0,0 +1,96 @@
+#include <QtTest/QtTest>
+#include <QImage>
+#include <memory>
+#include "fleetmaprasterizer.h"
+#include "fleetmaprenderer.h"
+#include "fleetstate.h"
+#include "dronedata.h"
+
+class TestMap : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testSpritesAtHighZoom();
+    void testDensityAtLowZoom();
+    void testRendererDeliversLatestFrame();
+};
+
+namespace {
+FleetState gridFleet(int side, double spacingDegrees) {
+    FleetState fleet;
+    fleet.reserve(static_cast<std::size_t>(side) * side);
+    for (int row = 0; row < side; ++row) {
+        for (int column = 0; column < side; ++column) {
+            fleet.addDrone(DroneData(QString("MAP-%1-%2").arg(row).arg(column),
+                                     28.0 + row * spacingDegrees, 77.0 + column * spacingDegrees,
+                                     100.0, 0.0, 0.0, 100.0, GPSFixStatus::FIX_3D));
+        }
+    }
+    return fleet;
+}
+}
+
+void TestMap::testSpritesAtHighZoom() {
+    FleetState fleet;
+    fleet.addDrone(DroneData(QString("MAP-A"), 28.5, 77.5, 100.0, 0.0, 0.0, 90.0, GPSFixStatus::FIX_3D));
+    fleet.addDrone(DroneData(QString("MAP-B"), 28.5, 77.6, 100.0, 0.0, 0.0, 10.0, GPSFixStatus::FIX_3D));
+
+    FleetMapRasterizer rasterizer;
+    QImage image;
+    const MapViewport viewport{28.5, 77.5, 1000.0, 400, 300};
+    rasterizer.render(fleet, viewport, image);
+
+    QCOMPARE(image.width(), 400);
+    QCOMPARE(image.height(), 300);
+    QCOMPARE(rasterizer.getLastMode(), FleetMapRasterizer::SPRITES);
+    QCOMPARE(rasterizer.getLastVisibleCount(), std::size_t(2));
+
+    // The centred drone sits mid-image; the second is 0.1 deg east, scaled by cos(latitude)
+    const QRgb background = image.pixel(0, 0);
+    QVERIFY(image.pixel(200, 150) != background);
+    const int eastX = 200 + static_cast<int>(0.1 * 1000.0 * qCos(qDegreesToRadians(28.5)));
+    QVERIFY(image.pixel(eastX, 150) != background);
+    QVERIFY(image.pixel(200, 150) != image.pixel(eastX, 150));  // colour follows battery
+}
+
+void TestMap::testDensityAtLowZoom() {
+    const FleetState fleet = gridFleet(200, 0.001);
+
+    FleetMapRasterizer rasterizer;
+    QImage image;
+    const MapViewport viewport = FleetMapRasterizer::fitToFleet(fleet, 160, 120);
+    rasterizer.render(fleet, viewport, image);
+
+    // 40,000 drones on 19,200 pixels aggregate into a density view that shows them all
+    QCOMPARE(rasterizer.getLastMode(), FleetMapRasterizer::DENSITY);
+    QCOMPARE(rasterizer.getLastVisibleCount(), fleet.size());
+    QVERIFY(image.pixel(80, 60) != image.pixel(0, 0));
+}
+
+void TestMap::testRendererDeliversLatestFrame() {
+    FleetMapRenderer renderer;
+
+    auto snapshot = std::make_shared<const FleetState>(gridFleet(10, 0.001));
+    const MapViewport viewport = FleetMapRasterizer::fitToFleet(*snapshot, 64, 48);
+    renderer.requestFrame(snapshot, viewport);
+    QTRY_VERIFY(renderer.getRenderedFrames() >= 1);
+
+    MapViewport rendered;
+    const QImage& frame = renderer.takeFrame(&rendered);
+    QCOMPARE(frame.width(), 64);
+    QCOMPARE(frame.height(), 48);
+    QCOMPARE(rendered.pixelsPerDegree, viewport.pixelsPerDegree);
+
+    // Frames alternate between the renderer's two buffers without detaching
+    const uchar* firstBits = renderer.takeFrame().constBits();
+    renderer.requestFrame(snapshot, viewport);
+    QTRY_VERIFY(renderer.getRenderedFrames() >= 2);
+    const uchar* secondBits = renderer.takeFrame().constBits();
+    QVERIFY(secondBits != firstBits);
+    renderer.requestFrame(snapshot, viewport);
+    QTRY_VERIFY(renderer.getRenderedFrames() >= 3);
+    QCOMPARE(renderer.takeFrame().constBits(), firstBits);
+}
+
+QTEST_MAIN(TestMap)
+#include "test_map.moc"
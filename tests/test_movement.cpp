@@ -2,6 +2,12 @@
 #include "hoverstrategy.h"
 #include "randomwalkstrategy.h"
 #include "dronedata.h"
+#include "fleetstate.h"
+#include "movementkernels.h"
+#include "geofence.h"
+#include "philoxrng.h"
+#include <cstring>
+#include <vector>
 
 class TestMovement : public QObject {
     Q_OBJECT
@@ -10,6 +16,12 @@ private slots:
     void testHoverStrategy();
     void testRandomWalkStrategy();
     void testStrategyNames();
+    void testBatchUpdate();
+    void testRandomWalkGeofence();
+    void testSinCosKernel();
+    void testKernelInstructionSetsAgree();
+    void testPhiloxKnownAnswers();
+    void testBatchReproducible();
 };
 
 void TestMovement::testHoverStrategy() {
@@ -50,5 +62,150 @@ void TestMovement::testStrategyNames() {
     QCOMPARE(randomWalk.getStrategyName(), QString("Random Walk"));
 }
 
+void TestMovement::testBatchUpdate() {
+    FleetState fleet;
+    for (int i = 0; i < 64; ++i) {
+        fleet.addDrone(DroneData(QString("DRONE-%1").arg(i), 28.4595, 77.0266, 100.0,
+                                 0.0, 0.0, 100.0, GPSFixStatus::FIX_3D));
+    }
+
+    const TickContext context{1, 42, 0.5};
+    HoverStrategy hover;
+    hover.updatePositions(fleet, 0, 32, context);
+    for (std::size_t i = 0; i < 32; ++i) {
+        QVERIFY(qAbs(fleet.latitudes()[i] - 28.4595) < 0.01);
+        QVERIFY(fleet.speeds()[i] >= 0.5 && fleet.speeds()[i] <= 2.0);
+    }
+
+    // Drones outside the range are untouched
+    QCOMPARE(fleet.speeds()[32], 0.0);
+
+    RandomWalkStrategy randomWalk;
+    randomWalk.updatePositions(fleet, 32, 64, context);
+    for (std::size_t i = 32; i < 64; ++i) {
+        QVERIFY(fleet.latitudes()[i] >= 28.4 && fleet.latitudes()[i] <= 29.0);
+        QVERIFY(fleet.longitudes()[i] >= 77.0 && fleet.longitudes()[i] <= 78.0);
+        QVERIFY(fleet.altitudes()[i] >= 50.0 && fleet.altitudes()[i] <= 200.0);
+    }
+}
+
+void TestMovement::testRandomWalkGeofence() {
+    // A wedge-shaped area with a no-fly box just north of the drones
+    GeofenceZone area;
+    area.name = "wedge";
+    area.type = GeofenceZone::INCLUSION;
+    area.vertices = {{28.440, 77.000}, {28.440, 77.060}, {28.480, 77.030}};
+    const Geofence fence({area, Geofence::box("tower", GeofenceZone::EXCLUSION,
+                                              GeofenceBounds{28.4605, 28.4700, 77.0200, 77.0330})});
+    QVERIFY(!fence.isBox());
+
+    FleetState fleet;
+    for (int i = 0; i < 300; ++i) {
+        fleet.addDrone(DroneData(QString("DRONE-%1").arg(i), 28.4595, 77.0266, 100.0,
+                                 0.0, 0.0, 100.0, GPSFixStatus::FIX_3D));
+    }
+
+    // Steps that would breach are refused, so no drone ever does, though many get close
+    RandomWalkStrategy randomWalk;
+    double closest = 1.0;
+    for (quint64 tick = 1; tick <= 400; ++tick) {
+        TickContext context{tick, 99, 0.5};
+        context.geofence = &fence;
+        randomWalk.prepare(fleet, context);
+        randomWalk.updatePositions(fleet, 0, fleet.size(), context);
+        for (std::size_t i = 0; i < fleet.size(); ++i) {
+            QCOMPARE(fence.classify(fleet.latitudes()[i], fleet.longitudes()[i]), Geofence::CLEAR);
+            if (fleet.longitudes()[i] > 77.0200 && fleet.longitudes()[i] < 77.0330) {
+                closest = qMin(closest, 28.4605 - fleet.latitudes()[i]);
+            }
+        }
+    }
+    QVERIFY(closest < 0.0002);
+}
+
+void TestMovement::testSinCosKernel() {
+    const std::size_t count = 1001;
+    std::vector<double> angle(count), sinOut(count), cosOut(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        angle[i] = -10.0 + 20.0 * static_cast<double>(i) / (count - 1);
+    }
+
+    MovementKernels::sinCos(angle.data(), sinOut.data(), cosOut.data(), count);
+    for (std::size_t i = 0; i < count; ++i) {
+        QVERIFY(qAbs(sinOut[i] - std::sin(angle[i])) < 1e-15);
+        QVERIFY(qAbs(cosOut[i] - std::cos(angle[i])) < 1e-15);
+    }
+}
+
+void TestMovement::testKernelInstructionSetsAgree() {
+    const std::size_t count = 37;  // not a multiple of any vector width
+    std::vector<quint64> randomBits(count * MovementKernels::RANDOM_WALK_DRAWS);
+    for (std::size_t i = 0; i < randomBits.size(); ++i) {
+        randomBits[i] = 0x9E3779B97F4A7C15ULL * (i + 1);
+    }
+
+    MovementKernels::RandomWalkParams params{0.0005, 0.1, 28.4, 29.0, 77.0, 78.0, 50.0, 200.0, 10.0, 10000.0};
+    std::vector<std::vector<double>> latitudes;
+
+    const MovementKernels::InstructionSet original = MovementKernels::activeInstructionSet();
+    for (int set = MovementKernels::SCALAR; set <= MovementKernels::detectedInstructionSet(); ++set) {
+        MovementKernels::setInstructionSet(static_cast<MovementKernels::InstructionSet>(set));
+        std::vector<double> direction(count, 1.0), latitude(count, 28.5), longitude(count, 77.5);
+        std::vector<double> altitude(count, 100.0), heading(count), speed(count);
+        MovementKernels::RandomWalkLanes lanes{direction.data(), latitude.data(), longitude.data(),
+                                               altitude.data(), heading.data(), speed.data()};
+        MovementKernels::randomWalk(params, lanes, randomBits.data(), count);
+        latitudes.push_back(latitude);
+    }
+    MovementKernels::setInstructionSet(original);
+
+    // Every vector path must reproduce the scalar reference bit for bit
+    for (std::size_t set = 1; set < latitudes.size(); ++set) {
+        QVERIFY(std::memcmp(latitudes[0].data(), latitudes[set].data(), count * sizeof(double)) == 0);
+    }
+}
+
+void TestMovement::testPhiloxKnownAnswers() {
+    // Reference vectors from the Random123 distribution (philox4x32_10)
+    PhiloxRng::Block zero = PhiloxRng::generateBlock({{0, 0, 0, 0}}, 0);
+    QCOMPARE(zero[0], quint32(0x6627e8d5));
+    QCOMPARE(zero[3], quint32(0x9b00dbd8));
+
+    PhiloxRng::Block pi = PhiloxRng::generateBlock({{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}},
+                                                   (quint64(0x299f31d0) << 32) | 0xa4093822);
+    QCOMPARE(pi[0], quint32(0xd16cfe09));
+    QCOMPARE(pi[3], quint32(0x24126ea1));
+
+    // Batch planes match individual draws
+    PhiloxRng random(7);
+    std::vector<quint64> planes(5 * 3);
+    random.fillBitPlanes(10, 99, 5, 3, planes.data());
+    QCOMPARE(planes[2 * 5 + 1], random.bits(11, 99, 2));
+    QCOMPARE(planes[0 * 5 + 4], random.bits(14, 99, 0));
+}
+
+void TestMovement::testBatchReproducible() {
+    auto runFleet = [](std::size_t chunk) {
+        FleetState fleet;
+        for (int i = 0; i < 50; ++i) {
+            fleet.addDrone(DroneData(QString("DRONE-%1").arg(i), 28.5, 77.5, 100.0,
+                                     0.0, 0.0, 100.0, GPSFixStatus::FIX_3D));
+        }
+        RandomWalkStrategy randomWalk;
+        for (quint64 tick = 1; tick <= 20; ++tick) {
+            const TickContext context{tick, 1234, 0.5};
+            for (std::size_t begin = 0; begin < fleet.size(); begin += chunk) {
+                randomWalk.updatePositions(fleet, begin, qMin(begin + chunk, fleet.size()), context);
+            }
+        }
+        return std::vector<double>(fleet.latitudes(), fleet.latitudes() + fleet.size());
+    };
+
+    // Same seed gives the same run, however the fleet is split into ranges
+    std::vector<double> whole = runFleet(50);
+    std::vector<double> chunked = runFleet(7);
+    QVERIFY(whole == chunked);
+}
+
 QTEST_MAIN(TestMovement)
 #include "test_movement.moc"
@@ -0,0 +1,270 @@
+#include <QtTest/QtTest>
+#include <QHostAddress>
+#include <QUdpSocket>
+#include <cstring>
+#include <vector>
+#include "droneidregistry.h"
+#include "telemetrypacket.h"
+#include "telemetrystreamer.h"
+#include "telemetryreceiver.h"
+#include "dronesimulator.h"
+#include "fleetstate.h"
+#include "dronedata.h"
+
+using namespace TelemetryPacket;
+
+class TestNetwork : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRecordRoundTrip();
+    void testStreamsKeyframesAndDeltas();
+    void testReceiverDrivesSimulator();
+};
+
+namespace {
+FleetState makeFleet(std::size_t count) {
+    FleetState fleet;
+    for (std::size_t i = 0; i < count; ++i) {
+        fleet.addDrone(DroneData(QString("NET-%1").arg(i), 28.4 + i * 1e-4, 77.0 - i * 1e-4,
+                                 100.0 + i, i % 360, 12.5, 80.0, GPSFixStatus::FIX_3D));
+    }
+    return fleet;
+}
+
+// Reads every datagram that arrives within a short quiet period
+std::vector<QByteArray> receiveAll(QUdpSocket& socket) {
+    std::vector<QByteArray> received;
+    while (socket.waitForReadyRead(200)) {
+        while (socket.hasPendingDatagrams()) {
+            QByteArray datagram(socket.pendingDatagramSize(), '\0');
+            socket.readDatagram(datagram.data(), datagram.size());
+            received.push_back(datagram);
+        }
+    }
+    return received;
+}
+}
+
+void TestNetwork::testRecordRoundTrip() {
+    FleetState fleet = makeFleet(2);
+    fleet.headings()[1] = -90.0;  // wraps to 270
+
+    const StateRecord base = quantize(fleet, 0);
+    char buffer[FULL_RECORD_BYTES];
+    writeFull(buffer, base);
+    const StateRecord full = readFull(buffer);
+    QCOMPARE(full.latitudeE7, base.latitudeE7);
+    QCOMPARE(full.altitudeCm, 10000);
+    QCOMPARE(full.batteryCentipercent, quint16(8000));
+    QCOMPARE(quantize(fleet, 1).headingCdeg, quint16(27000));
+
+    // A few metres of movement fits a delta; a few kilometres does not
+    StateRecord moved = base;
+    moved.latitudeE7 += 250;
+    moved.altitudeCm -= 300;
+    QVERIFY(fitsDelta(base, moved));
+    char delta[DELTA_RECORD_BYTES];
+    writeDelta(delta, base, moved);
+    const StateRecord decoded = readDelta(delta, base);
+    QCOMPARE(decoded.latitudeE7, moved.latitudeE7);
+    QCOMPARE(decoded.altitudeCm, moved.altitudeCm);
+    moved.longitudeE7 += 400000;
+    QVERIFY(!fitsDelta(base, moved));
+
+    // Datagrams with a damaged byte are rejected
+    char datagram[MAX_DATAGRAM_BYTES];
+    PacketHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.version = PROTOCOL_VERSION;
+    header.type = FULL_STATE;
+    header.recordCount = 1;
+    header.payloadBytes = FULL_RECORD_BYTES;
+    writeFull(datagram + sizeof(PacketHeader), base);
+    const std::size_t size = finishDatagram(datagram, header);
+    PacketHeader parsed;
+    QVERIFY(parseDatagram(datagram, size, &parsed));
+    QCOMPARE(parsed.recordCount, quint16(1));
+    datagram[sizeof(PacketHeader) + 3] ^= 0x10;
+    QVERIFY(!parseDatagram(datagram, size, &parsed));
+}
+
+void TestNetwork::testStreamsKeyframesAndDeltas() {
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress(QHostAddress::LocalHost), 0));
+    receiver.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 4 << 20);
+
+    const std::size_t droneCount = 1000;
+    FleetState fleet = makeFleet(droneCount);
+    fleet.setClock(1, 0.1);
+
+    TelemetryStreamer streamer(5);
+    QVERIFY(streamer.open("127.0.0.1", receiver.localPort()));
+    streamer.stream(fleet);
+
+    // First tick: name table, then every drone in full, in sequence
+    std::vector<StateRecord> keyframe(droneCount);
+    std::size_t names = 0;
+    quint32 expectedSequence = 0;
+    for (const QByteArray& datagram : receiveAll(receiver)) {
+        PacketHeader header;
+        QVERIFY(parseDatagram(datagram.constData(), datagram.size(), &header));
+        QVERIFY(datagram.size() <= int(MAX_DATAGRAM_BYTES));
+        QCOMPARE(header.sequence, expectedSequence++);
+        QCOMPARE(header.fleetSize, quint32(droneCount));
+        if (header.type == NAME_TABLE) {
+            names += header.recordCount;
+            continue;
+        }
+        QCOMPARE(header.type, quint8(FULL_STATE));
+        for (int i = 0; i < header.recordCount; ++i) {
+            keyframe[header.firstIndex + i] = readFull(datagram.constData() + sizeof(PacketHeader) + i * FULL_RECORD_BYTES);
+        }
+    }
+    QCOMPARE(names, droneCount);
+    QCOMPARE(streamer.getDroppedDatagrams(), quint64(0));
+    QCOMPARE(keyframe[7].latitudeE7, quantize(fleet, 7).latitudeE7);
+
+    // Second tick: small movements arrive as deltas against tick 1
+    for (std::size_t i = 0; i < droneCount; ++i) {
+        fleet.latitudes()[i] += 2e-5;
+        fleet.altitudes()[i] += 1.5;
+    }
+    fleet.setClock(2, 0.2);
+    streamer.stream(fleet);
+
+    std::size_t deltas = 0;
+    for (const QByteArray& datagram : receiveAll(receiver)) {
+        PacketHeader header;
+        QVERIFY(parseDatagram(datagram.constData(), datagram.size(), &header));
+        QCOMPARE(header.sequence, expectedSequence++);
+        QCOMPARE(header.type, quint8(DELTA_STATE));
+        QCOMPARE(header.baseTick, quint64(1));
+        for (int i = 0; i < header.recordCount; ++i) {
+            const std::size_t index = header.firstIndex + i;
+            const StateRecord record = readDelta(datagram.constData() + sizeof(PacketHeader) + i * DELTA_RECORD_BYTES,
+                                                 keyframe[index]);
+            QCOMPARE(record.latitudeE7, quantize(fleet, index).latitudeE7);
+            QCOMPARE(record.altitudeCm, quantize(fleet, index).altitudeCm);
+            ++deltas;
+        }
+    }
+    QCOMPARE(deltas, droneCount);
+    QCOMPARE(streamer.getStreamedTicks(), quint64(2));
+}
+
+void TestNetwork::testReceiverDrivesSimulator() {
+    DroneSimulator simulator;
+    TelemetryReceiver receiver(&simulator);
+    QVERIFY(receiver.open(0));
+    QVERIFY(receiver.getPort() != 0);
+
+    const std::size_t droneCount = 500;
+    FleetState fleet = makeFleet(droneCount);
+    fleet.setClock(1, 0.1);
+    TelemetryStreamer streamer(5);
+    QVERIFY(streamer.open("127.0.0.1", receiver.getPort()));
+    streamer.stream(fleet);
+
+    // The cache is published through the simulator like a replayed tick
+    QTRY_COMPARE(receiver.getReceivedDatagrams(), streamer.getSentDatagrams());
+    receiver.publish();
+    QCOMPARE(simulator.getFleet().size(), droneCount);
+    QCOMPARE(simulator.getFleet().nameAt(42), QString("NET-42"));
+    QCOMPARE(simulator.getFleet().getTick(), quint64(1));
+    QVERIFY(qAbs(simulator.getFleet().latitudes()[42] - fleet.latitudes()[42]) < 1e-7);
+
+    // Deltas update the last-value cache without a new layout
+    const quint64 layout = simulator.getFleet().getLayoutVersion();
+    for (std::size_t i = 0; i < droneCount; ++i) {
+        fleet.longitudes()[i] += 3e-5;
+        fleet.batteries()[i] = 55.5;
+    }
+    fleet.setClock(2, 0.2);
+    streamer.stream(fleet);
+    QTRY_COMPARE(receiver.getReceivedDatagrams(), streamer.getSentDatagrams());
+    receiver.publish();
+    QCOMPARE(simulator.getFleet().getTick(), quint64(2));
+    QCOMPARE(simulator.getFleet().getLayoutVersion(), layout);
+    QVERIFY(qAbs(simulator.getFleet().longitudes()[7] - fleet.longitudes()[7]) < 1e-7);
+    QCOMPARE(simulator.getFleet().batteries()[7], 55.5);
+    QCOMPARE(receiver.getLostDatagrams(), quint64(0));
+    QCOMPARE(receiver.getStaleRecords(), quint64(0));
+
+    // A well-formed datagram announcing a huge fleet is rejected, not allocated
+    char datagram[MAX_DATAGRAM_BYTES];
+    PacketHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.version = PROTOCOL_VERSION;
+    header.type = FULL_STATE;
+    header.sequence = 1u << 20;
+    header.fleetSize = 0xFFFFFFFFu;
+    header.tick = 3;
+    const std::size_t size = finishDatagram(datagram, header);
+    QUdpSocket hostile;
+    QCOMPARE(hostile.writeDatagram(datagram, size, QHostAddress(QHostAddress::LocalHost), receiver.getPort()),
+             qint64(size));
+    QTRY_COMPARE(receiver.getRejectedDatagrams(), quint64(1));
+    QCOMPARE(simulator.getFleet().size(), droneCount);
+
+    // A sender restarting from tick 1 with the same layout is a new stream,
+    // not a flood of late datagrams
+    for (std::size_t i = 0; i < droneCount; ++i) {
+        fleet.batteries()[i] = 90.0;
+    }
+    fleet.setClock(100, 10.0);
+    streamer.stream(fleet);
+    QTRY_COMPARE(receiver.getReceivedDatagrams(), streamer.getSentDatagrams());
+    receiver.publish();
+    QCOMPARE(simulator.getFleet().getTick(), quint64(100));
+
+    const quint64 receivedBefore = receiver.getReceivedDatagrams();
+    TelemetryStreamer restarted(5);
+    QVERIFY(restarted.open("127.0.0.1", receiver.getPort()));
+    for (std::size_t i = 0; i < droneCount; ++i) {
+        fleet.batteries()[i] = 42.0;
+    }
+    fleet.setClock(1, 0.1);
+    restarted.stream(fleet);
+    QTRY_COMPARE(receiver.getReceivedDatagrams(), receivedBefore + restarted.getSentDatagrams());
+    receiver.publish();
+    QCOMPARE(simulator.getFleet().getTick(), quint64(1));
+    QCOMPARE(simulator.getFleet().batteries()[7], 42.0);
+    QCOMPARE(simulator.getFleet().nameAt(42), QString("NET-42"));
+
+    // A sender that keeps renaming its drones cannot grow the process-wide
+    // registry; the first name of each drone in a layout sticks
+    const std::size_t registrySize = DroneIdRegistry::getInstance().size();
+    header.type = NAME_TABLE;
+    header.layoutVersion = static_cast<quint32>(fleet.getLayoutVersion());
+    header.fleetSize = static_cast<quint32>(droneCount);
+    header.tick = 1;
+    header.baseTick = 1;
+    header.firstIndex = 42;
+    header.recordCount = 1;
+    const quint64 rejectedBefore = receiver.getRejectedDatagrams();
+    for (int rename = 0; rename < 50; ++rename) {
+        const QByteArray name = QString("RENAMED-%1").arg(rename).toUtf8();
+        char* payload = datagram + sizeof(PacketHeader);
+        const DroneId id = 42;
+        std::memcpy(payload, &id, sizeof(id));
+        payload[sizeof(id)] = static_cast<char>(name.size());
+        std::memcpy(payload + sizeof(id) + 1, name.constData(), name.size());
+        header.payloadBytes = static_cast<quint16>(sizeof(id) + 1 + name.size());
+        header.sequence = static_cast<quint32>(restarted.getSentDatagrams()) + rename;
+        const std::size_t renameSize = finishDatagram(datagram, header);
+        const quint64 received = receiver.getReceivedDatagrams();
+        QCOMPARE(hostile.writeDatagram(datagram, renameSize, QHostAddress(QHostAddress::LocalHost),
+                                       receiver.getPort()), qint64(renameSize));
+        QTRY_COMPARE(receiver.getReceivedDatagrams(), received + 1);
+        receiver.publish();
+    }
+    QCOMPARE(receiver.getRejectedDatagrams(), rejectedBefore);
+    QCOMPARE(simulator.getFleet().nameAt(42), QString("NET-42"));
+    QCOMPARE(DroneIdRegistry::getInstance().size(), registrySize);
+}
+
+QTEST_MAIN(TestNetwork)
+#include "test_network.moc"
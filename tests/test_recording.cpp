@@ -0,0 +1,203 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <cstring>
+#include "telemetryrecorder.h"
+#include "telemetryreplay.h"
+#include "telemetryformat.h"
+#include "fleetstate.h"
+#include "dronedata.h"
+
+class TestRecording : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testCrc32();
+    void testRecorderWritesChunks();
+    void testReplaySeekAndLoad();
+    void testReplayRejectsCorruptChunk();
+};
+
+namespace {
+DroneData makeDrone(int index) {
+    return DroneData(QString("DRONE-%1").arg(index), 28.0 + index, 77.0, 100.0,
+                     0.0, 1.0, 100.0, GPSFixStatus::FIX_3D);
+}
+
+void advance(FleetState& fleet, quint64 tick) {
+    fleet.setClock(tick, tick * 0.5);
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        fleet.altitudes()[i] = tick * 10.0 + i;
+    }
+}
+
+// Ticks 1-5 with three drones, then ticks 6-10 with four, in chunks of four ticks
+quint64 recordSample(const QString& path) {
+    FleetState fleet;
+    for (int i = 0; i < 3; ++i) {
+        fleet.addDrone(makeDrone(i));
+    }
+
+    TelemetryRecorder recorder(4);
+    if (!recorder.open(path)) {
+        return 0;
+    }
+    for (quint64 tick = 1; tick <= 10; ++tick) {
+        if (tick == 6) {
+            fleet.addDrone(makeDrone(3));
+        }
+        advance(fleet, tick);
+        recorder.record(fleet);
+    }
+    recorder.close();
+    return recorder.getBytesWritten();
+}
+}
+
+void TestRecording::testCrc32() {
+    // Standard check value for "123456789"
+    QCOMPARE(TelemetryFormat::crc32("123456789", 9), quint32(0xCBF43926));
+
+    // Checksumming in pieces matches one pass
+    QByteArray data(1000, 'x');
+    quint32 split = TelemetryFormat::crc32(data.constData(), 333);
+    split = TelemetryFormat::crc32(data.constData() + 333, 667, split);
+    QCOMPARE(split, TelemetryFormat::crc32(data.constData(), 1000));
+}
+
+void TestRecording::testRecorderWritesChunks() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("fleet.dtr");
+
+    const quint64 bytesWritten = recordSample(path);
+    QVERIFY(bytesWritten > 0);
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray bytes = file.readAll();
+    QCOMPARE(quint64(bytes.size()), bytesWritten);
+
+    TelemetryFormat::FileHeader fileHeader;
+    std::memcpy(&fileHeader, bytes.constData(), sizeof(fileHeader));
+    QVERIFY(std::memcmp(fileHeader.magic, TelemetryFormat::FILE_MAGIC, 8) == 0);
+    QCOMPARE(fileHeader.version, TelemetryFormat::FORMAT_VERSION);
+
+    // Expected blocks: IDs(3), ticks 1-4, tick 5, IDs(4), ticks 6-9, tick 10.
+    // The drone joining at tick 6 starts a new ID table.
+    const quint32 expectedTypes[] = {
+        TelemetryFormat::ID_TABLE, TelemetryFormat::TICK_CHUNK, TelemetryFormat::TICK_CHUNK,
+        TelemetryFormat::ID_TABLE, TelemetryFormat::TICK_CHUNK, TelemetryFormat::TICK_CHUNK
+    };
+    const quint32 expectedTicks[] = {0, 4, 1, 0, 4, 1};
+
+    qint64 offset = sizeof(fileHeader);
+    int block = 0;
+    while (offset < bytes.size()) {
+        QVERIFY(block < 6);
+        TelemetryFormat::BlockHeader header;
+        std::memcpy(&header, bytes.constData() + offset, sizeof(header));
+        offset += sizeof(header);
+        QCOMPARE(header.type, expectedTypes[block]);
+        QCOMPARE(header.tickCount, expectedTicks[block]);
+
+        const char* payload = bytes.constData() + offset;
+        const quint64 samples = quint64(header.tickCount) * header.droneCount;
+        const quint64 unpadded = header.type == TelemetryFormat::ID_TABLE
+            ? header.payloadBytes
+            : header.tickCount * 16 + samples * TelemetryFormat::BYTES_PER_SAMPLE;
+        if (header.type == TelemetryFormat::TICK_CHUNK) {
+            QCOMPARE(header.payloadCrc32, TelemetryFormat::crc32(payload, unpadded));
+        }
+
+        // Altitude of drone 3 in tick 7 (second tick of the 6-9 chunk)
+        if (block == 4) {
+            QCOMPARE(header.firstTick, quint64(6));
+            QCOMPARE(header.lastTime, 4.5);
+            const char* altitudes = payload + header.tickCount * 16
+                + TelemetryFormat::ALTITUDE * samples * sizeof(double);
+            double altitude;
+            std::memcpy(&altitude, altitudes + (1 * header.droneCount + 3) * sizeof(double), sizeof(double));
+            QCOMPARE(altitude, 73.0);
+        }
+
+        offset += header.payloadBytes;
+        ++block;
+    }
+    QCOMPARE(block, 6);
+    QCOMPARE(offset, qint64(bytes.size()));
+}
+
+void TestRecording::testReplaySeekAndLoad() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("fleet.dtr");
+    QVERIFY(recordSample(path) > 0);
+
+    TelemetryReplay replay;
+    QVERIFY(replay.open(path));
+    QCOMPARE(replay.getTickCount(), quint64(10));
+    QCOMPARE(replay.getStartTime(), 0.5);
+    QCOMPARE(replay.getEndTime(), 5.0);
+
+    // Tick n was recorded at n * 0.5 s and sits at position n - 1
+    QCOMPARE(replay.seek(0.0), quint64(0));
+    QCOMPARE(replay.seek(2.0), quint64(3));
+    QCOMPARE(replay.seek(2.1), quint64(4));
+    QCOMPARE(replay.seek(4.5), quint64(8));
+    QCOMPARE(replay.seek(60.0), quint64(10));
+
+    FleetState fleet;
+    QVERIFY(replay.loadTick(6, fleet));
+    QCOMPARE(fleet.size(), std::size_t(4));
+    QCOMPARE(fleet.getTick(), quint64(7));
+    QCOMPARE(fleet.nameAt(3), QString("DRONE-3"));
+    QCOMPARE(fleet.altitudes()[3], 73.0);
+    QCOMPARE(fleet.latitudes()[2], 30.0);
+
+    // Going back across the layout change restores the shorter drone list
+    QVERIFY(replay.loadTick(0, fleet));
+    QCOMPARE(fleet.size(), std::size_t(3));
+    QCOMPARE(fleet.altitudes()[1], 11.0);
+    QVERIFY(!replay.loadTick(10, fleet));
+}
+
+void TestRecording::testReplayRejectsCorruptChunk() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("fleet.dtr");
+    QVERIFY(recordSample(path) > 0);
+
+    // Flip one byte near the end of the file, inside the last chunk's payload
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    const qint64 target = file.size() - 8 - 2;
+    QVERIFY(file.seek(target));
+    char byte = 0;
+    QVERIFY(file.getChar(&byte));
+    QVERIFY(file.seek(target));
+    QVERIFY(file.putChar(static_cast<char>(byte ^ 0x01)));
+    file.close();
+
+    TelemetryReplay replay;
+    QVERIFY(replay.open(path));
+    FleetState fleet;
+    QVERIFY(replay.loadTick(0, fleet));
+    QVERIFY(!replay.loadTick(9, fleet));
+    replay.close();
+
+    // A huge drone count in the first ID table fails the open instead of
+    // sizing anything from it
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    TelemetryFormat::BlockHeader header;
+    QVERIFY(file.seek(sizeof(TelemetryFormat::FileHeader)));
+    QCOMPARE(file.read(reinterpret_cast<char*>(&header), sizeof(header)), qint64(sizeof(header)));
+    QCOMPARE(header.type, quint32(TelemetryFormat::ID_TABLE));
+    header.droneCount = ~quint64(0);
+    QVERIFY(file.seek(sizeof(TelemetryFormat::FileHeader)));
+    QCOMPARE(file.write(reinterpret_cast<const char*>(&header), sizeof(header)), qint64(sizeof(header)));
+    file.close();
+    QVERIFY(!replay.open(path));
+}
+
+QTEST_MAIN(TestRecording)
+#include "test_recording.moc"
@@ -4,6 +4,18 @@
 #include "simulationfactory.h"
 #include "movementstrategy.h"
 #include "dronedata.h"
+#include "fleetstate.h"
+#include "drone.h"
+#include "tickscheduler.h"
+#include "telemetryrecorder.h"
+#include "telemetryplayer.h"
+#include "ensemblerunner.h"
+#include "alertengine.h"
+#include "geofence.h"
+#include "simulationcheckpoint.h"
+#include "logger.h"
+#include <QTemporaryDir>
+#include <cstring>
 
 class TestSimulation : public QObject {
     Q_OBJECT
@@ -16,6 +28,17 @@ private slots:
     void testSimulationStartStop();
     void testFailureMode();
     void testObserverPattern();
+    void testFleetState();
+    void testStrategyGroups();
+    void testSeededRunsReproduce();
+    void testParallelTickMatchesSerial();
+    void testRunTicksHeadless();
+    void testTickScheduler();
+    void testReplayRoundTrip();
+    void testSnapshotPublishing();
+    void testCheckpointForksRun();
+    void testEnsembleRunner();
+    void testAlertRules();
 
 private:
     std::unique_ptr<DroneSimulator> simulator;
@@ -34,17 +57,25 @@ void TestSimulation::cleanupTestCase() {
 
 void TestSimulation::testDroneDataCreation() {
     DroneData data;
-    QCOMPARE(data.getId(), QString("DRONE-001"));
+    QCOMPARE(data.getName(), QString("DRONE-001"));
     QCOMPARE(data.getBattery(), 100.0);
     QCOMPARE(data.getGPSStatus(), GPSFixStatus::FIX_3D);
 
     DroneData customData("TEST-DRONE", 40.0, -74.0, 150.0, 90.0, 5.0, 75.0, GPSFixStatus::FIX_2D);
-    QCOMPARE(customData.getId(), QString("TEST-DRONE"));
+    QCOMPARE(customData.getName(), QString("TEST-DRONE"));
     QCOMPARE(customData.getLatitude(), 40.0);
     QCOMPARE(customData.getLongitude(), -74.0);
     QCOMPARE(customData.getAltitude(), 150.0);
     QCOMPARE(customData.getBattery(), 75.0);
     QCOMPARE(customData.getGPSStatus(), GPSFixStatus::FIX_2D);
+
+    // Records are plain bytes; the name survives a memcpy through the interned ID
+    DroneData copy;
+    std::memcpy(static_cast<void*>(&copy), &customData, sizeof(DroneData));
+    QCOMPARE(copy.getId(), DroneIdRegistry::getInstance().intern("TEST-DRONE"));
+    QCOMPARE(copy.getName(), QString("TEST-DRONE"));
+    QCOMPARE(copy.getLatitude(), 40.0);
+    QVERIFY(DroneIdRegistry::getInstance().nameOf(customData.getId() + 100000).isEmpty());
 }
 
 void TestSimulation::testSimulatorFactory() {
@@ -96,5 +127,447 @@ void TestSimulation::testObserverPattern() {
     simulator->stopSimulation();
 }
 
+void TestSimulation::testFleetState() {
+    auto fleetSimulator = SimulationFactory::createSimulator(SimulationFactory::BASIC_SIMULATOR);
+    QCOMPARE(fleetSimulator->droneCount(), std::size_t(1));
+
+    fleetSimulator->setFleetSize(100);
+    QCOMPARE(fleetSimulator->droneCount(), std::size_t(100));
+    QCOMPARE(fleetSimulator->getDroneData(0).getName(), QString("DRONE-001"));
+    QCOMPARE(fleetSimulator->getDroneData(99).getName(), QString("DRONE-100"));
+
+    // Views round-trip through the column store
+    FleetState fleet;
+    DroneData data("TEST-DRONE", 40.0, -74.0, 150.0, 90.0, 5.0, 75.0, GPSFixStatus::FIX_2D);
+    std::size_t index = fleet.addDrone(data);
+    QCOMPARE(fleet.view(index).getAltitude(), 150.0);
+    data.setBattery(42.0);
+    fleet.store(index, data);
+    QCOMPARE(fleet.batteries()[index], 42.0);
+    QCOMPARE(fleet.view(index).getId(), data.getId());
+    QCOMPARE(fleet.nameAt(index), QString("TEST-DRONE"));
+
+    fleetSimulator->setFleetSize(10);
+    QCOMPARE(fleetSimulator->droneCount(), std::size_t(10));
+
+    // The proximity index follows fleet changes on demand
+    QCOMPARE(fleetSimulator->getSpatialIndex().size(), std::size_t(10));
+    std::vector<std::size_t> nearby;
+    const DroneData first = fleetSimulator->getDroneData(0);
+    fleetSimulator->getSpatialIndex().queryRadius(first.getLatitude(), first.getLongitude(),
+                                                  first.getAltitude(), 1.0, nearby);
+    QVERIFY(std::find(nearby.begin(), nearby.end(), std::size_t(0)) != nearby.end());
+}
+
+void TestSimulation::testStrategyGroups() {
+    auto fleetSimulator = SimulationFactory::createSimulator(SimulationFactory::BASIC_SIMULATOR);
+    fleetSimulator->setFleetSize(10);
+    fleetSimulator->setMovementStrategy(
+        SimulationFactory::createMovementStrategy(SimulationFactory::HOVER_MOVEMENT));
+    int walkSlot = fleetSimulator->addMovementStrategy(
+        SimulationFactory::createMovementStrategy(SimulationFactory::RANDOM_WALK_MOVEMENT));
+    QCOMPARE(walkSlot, 1);
+    fleetSimulator->assignMovementStrategy(5, 10, walkSlot);
+
+    fleetSimulator->runTicks(1);
+
+    // Hovering drones stay slow, random walkers stay inside the walk bounds
+    for (std::size_t i = 0; i < 5; ++i) {
+        double speed = fleetSimulator->getDroneData(i).getSpeed();
+        QVERIFY(speed >= 0.5 && speed <= 2.0);
+    }
+    for (std::size_t i = 5; i < 10; ++i) {
+        DroneData data = fleetSimulator->getDroneData(i);
+        QVERIFY(data.getSpeed() >= 0.0 && data.getSpeed() <= 5.0);
+        QVERIFY(data.getAltitude() >= 50.0 && data.getAltitude() <= 200.0);
+    }
+}
+
+void TestSimulation::testSeededRunsReproduce() {
+    auto run = [](quint64 seed) {
+        auto seeded = SimulationFactory::createSimulator(SimulationFactory::BASIC_SIMULATOR);
+        seeded->setFleetSize(20);
+        seeded->setRandomSeed(seed);
+        seeded->setMovementStrategy(
+            SimulationFactory::createMovementStrategy(SimulationFactory::RANDOM_WALK_MOVEMENT));
+        seeded->runTicks(10);
+        const FleetState& fleet = seeded->getFleet();
+        return std::vector<double>(fleet.longitudes(), fleet.longitudes() + fleet.size());
+    };
+
+    QVERIFY(run(2024) == run(2024));
+    QVERIFY(run(2024) != run(2025));
+}
+
+void TestSimulation::testParallelTickMatchesSerial() {
+    auto run = [](int threads) {
+        auto parallel = SimulationFactory::createSimulator(SimulationFactory::BASIC_SIMULATOR);
+        parallel->setThreadCount(threads);
+        parallel->setFleetSize(20000);
+        parallel->setRandomSeed(7);
+        parallel->setMovementStrategy(
+            SimulationFactory::createMovementStrategy(SimulationFactory::RANDOM_WALK_MOVEMENT));
+        int hoverSlot = parallel->addMovementStrategy(
+            SimulationFactory::createMovementStrategy(SimulationFactory::HOVER_MOVEMENT));
+        parallel->assignMovementStrategy(5000, 12000, hoverSlot);
+
+        parallel->runTicks(5);
+
+        const FleetState& fleet = parallel->getFleet();
+        std::vector<double> state(fleet.latitudes(), fleet.latitudes() + fleet.size());
+        state.insert(state.end(), fleet.batteries(), fleet.batteries() + fleet.size());
+        return state;
+    };
+
+    // Counter-based draws make the result independent of the thread count
+    QVERIFY(run(1) == run(4));
+}
+
+void TestSimulation::testRunTicksHeadless() {
+    auto simulator = SimulationFactory::createSimulator(SimulationFactory::BASIC_SIMULATOR);
+    simulator->setRandomSeed(7);
+    simulator->setFleetSize(100);
+    simulator->setMovementStrategy(
+        SimulationFactory::createMovementStrategy(SimulationFactory::HOVER_MOVEMENT));
+
+    // Batch runs advance the simulation without starting the timer
+    simulator->runTicks(50);
+    QCOMPARE(simulator->getUpdateCount(), quint64(50));
+    QVERIFY(!simulator->isRunning());
+    QVERIFY(simulator->getDroneData(99).getBattery() < 100.0);
+}
+
+void TestSimulation::testTickScheduler() {
+    TickScheduler scheduler(100.0);
+    QCOMPARE(scheduler.stepSeconds(), 0.01);
+    QCOMPARE(scheduler.timerIntervalMs(), 10);
+
+    // Late or early wake-ups keep the remainder for the next one
+    QCOMPARE(scheduler.advance(25000000), 2);
+    QCOMPARE(scheduler.advance(4000000), 0);
+    QCOMPARE(scheduler.advance(1000000), 1);
+
+    // A long stall catches up at most maxSubSteps() and drops the rest
+    scheduler.setMaxSubSteps(4);
+    QCOMPARE(scheduler.advance(100000000), 4);
+    QCOMPARE(scheduler.droppedSteps(), quint64(6));
+
+    scheduler.setRate(5000.0);
+    QCOMPARE(scheduler.rate(), TickScheduler::MAX_RATE_HZ);
+
+    // Battery drain follows simulated seconds, not the number of ticks
+    auto drainOverOneSecond = [](double rate) {
+        auto simulator = SimulationFactory::createSimulator(SimulationFactory::BASIC_SIMULATOR);
+        simulator->setTickRate(rate);
+        simulator->runTicks(static_cast<quint64>(rate));
+        return 100.0 - simulator->getFleet().batteries()[0];
+    };
+    QVERIFY(qAbs(drainOverOneSecond(2.0) - drainOverOneSecond(500.0)) < 1e-9);
+}
+
+void TestSimulation::testReplayRoundTrip() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("run.dtr");
+
+    auto live = SimulationFactory::createSimulator(SimulationFactory::BASIC_SIMULATOR);
+    live->setFleetSize(50);
+    live->setRandomSeed(11);
+    live->setMovementStrategy(
+        SimulationFactory::createMovementStrategy(SimulationFactory::RANDOM_WALK_MOVEMENT));
+    TelemetryRecorder recorder;
+    QVERIFY(recorder.open(path));
+    live->attach(&recorder);
+    live->runTicks(30);
+    live->detach(&recorder);
+    recorder.close();
+
+    // Replaying into another simulator reaches the same final state through its signal
+    auto replayed = SimulationFactory::createSimulator(SimulationFactory::BASIC_SIMULATOR);
+    QSignalSpy spy(replayed.get(), &DroneSimulator::telemetryUpdated);
+    TelemetryPlayer player(replayed.get());
+    QVERIFY(player.open(path));
+    QCOMPARE(player.runToEnd(), quint64(30));
+    QCOMPARE(spy.count(), 30);
+
+    const FleetState& expected = live->getFleet();
+    const FleetState& actual = replayed->getFleet();
+    QCOMPARE(actual.size(), expected.size());
+    QCOMPARE(actual.getTick(), expected.getTick());
+    QCOMPARE(actual.idAt(49), expected.idAt(49));
+    QVERIFY(std::equal(expected.latitudes(), expected.latitudes() + expected.size(), actual.latitudes()));
+    QVERIFY(std::equal(expected.batteries(), expected.batteries() + expected.size(), actual.batteries()));
+
+    // Seeking replays from the middle
+    player.seek(live->getSimulationTime() / 2);
+    QCOMPARE(player.getPosition(), quint64(14));
+}
+
+void TestSimulation::testSnapshotPublishing() {
+    auto publisher = SimulationFactory::createSimulator(SimulationFactory::BASIC_SIMULATOR);
+    publisher->setFleetSize(20);
+    Drone first(0);
+    Drone last(19);
+    publisher->attach(&first);
+    publisher->attach(&last);
+    QSignalSpy spy(publisher.get(), &DroneSimulator::fleetUpdated);
+
+    // Every observer and receiver gets the same snapshot for a tick
+    publisher->runTicks(1);
+    const FleetSnapshotPtr held = first.getSnapshot();
+    QVERIFY(held);
+    QCOMPARE(last.getSnapshot(), held);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).value<FleetSnapshotPtr>(), held);
+    QCOMPARE(last.getData().getId(), publisher->getFleet().idAt(19));
+
+    // A held snapshot stays frozen while the simulation moves on
+    const double heldLatitude = held->latitudes()[0];
+    const quint64 heldTick = held->getTick();
+    publisher->runTicks(5);
+    QCOMPARE(held->getTick(), heldTick);
+    QCOMPARE(held->latitudes()[0], heldLatitude);
+    QVERIFY(first.getSnapshot() != held);
+    QCOMPARE(first.getSnapshot()->getTick(), publisher->getFleet().getTick());
+
+    publisher->detach(&first);
+    publisher->detach(&last);
+}
+
+void TestSimulation::testCheckpointForksRun() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("fork.dck");
+
+    auto original = SimulationFactory::createSimulator(SimulationFactory::BASIC_SIMULATOR);
+    original->setFleetSize(3000);
+    original->setRandomSeed(99);
+    original->setTickRate(10.0);
+    original->setMovementStrategy(
+        SimulationFactory::createMovementStrategy(SimulationFactory::RANDOM_WALK_MOVEMENT));
+    int hoverSlot = original->addMovementStrategy(
+        SimulationFactory::createMovementStrategy(SimulationFactory::HOVER_MOVEMENT));
+    original->assignMovementStrategy(1000, 2200, hoverSlot);
+    original->runTicks(7);
+    original->setFailureMode(true);
+    QVERIFY(original->saveCheckpoint(path));
+
+    auto fork = SimulationFactory::createSimulator(SimulationFactory::BASIC_SIMULATOR);
+    QVERIFY(fork->restoreCheckpoint(path));
+    QCOMPARE(fork->droneCount(), std::size_t(3000));
+    QCOMPARE(fork->getUpdateCount(), quint64(7));
+    QCOMPARE(fork->getRandomSeed(), quint64(99));
+    QCOMPARE(fork->getTickRate(), 10.0);
+    QCOMPARE(fork->getFleet().nameAt(1500), original->getFleet().nameAt(1500));
+
+    // Both continue bit-identically, including strategy and battery state
+    original->runTicks(13);
+    fork->runTicks(13);
+    const FleetState& expected = original->getFleet();
+    const FleetState& actual = fork->getFleet();
+    QCOMPARE(actual.getTick(), expected.getTick());
+    QCOMPARE(actual.getSimulationTime(), expected.getSimulationTime());
+    const std::size_t bytes = expected.size() * sizeof(double);
+    QVERIFY(std::memcmp(actual.latitudes(), expected.latitudes(), bytes) == 0);
+    QVERIFY(std::memcmp(actual.longitudes(), expected.longitudes(), bytes) == 0);
+    QVERIFY(std::memcmp(actual.altitudes(), expected.altitudes(), bytes) == 0);
+    QVERIFY(std::memcmp(actual.batteries(), expected.batteries(), bytes) == 0);
+    QCOMPARE(actual.gpsStatuses()[0], GPSFixStatus::NO_FIX);
+
+    // An interrupted save leaves the previous checkpoint in place
+    {
+        CheckpointWriter interrupted;
+        QVERIFY(interrupted.open(path));
+        interrupted.write(quint64(1));
+    }
+    QVERIFY(fork->restoreCheckpoint(path));
+    QCOMPARE(fork->getUpdateCount(), quint64(7));
+    fork->runTicks(13);
+
+    // A drone count the name table cannot hold is refused before anything is sized
+    QFile file(path);
+    CheckpointFormat::FileHeader header;
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QCOMPARE(file.read(reinterpret_cast<char*>(&header), sizeof(header)), qint64(sizeof(header)));
+    const quint64 droneCount = header.droneCount;
+    header.droneCount = ~quint64(0) >> 1;
+    QVERIFY(file.seek(0));
+    QCOMPARE(file.write(reinterpret_cast<const char*>(&header), sizeof(header)), qint64(sizeof(header)));
+    file.close();
+    QVERIFY(!fork->restoreCheckpoint(path));
+    header.droneCount = droneCount;
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QCOMPARE(file.write(reinterpret_cast<const char*>(&header), sizeof(header)), qint64(sizeof(header)));
+    file.close();
+
+    // A damaged checkpoint is refused and leaves the simulator as it was
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    file.seek(file.size() / 2);
+    file.write("X");
+    file.close();
+    QVERIFY(!fork->restoreCheckpoint(path));
+    QCOMPARE(fork->getUpdateCount(), quint64(20));
+    QCOMPARE(fork->droneCount(), std::size_t(3000));
+}
+
+void TestSimulation::testEnsembleRunner() {
+    EnsembleRunner runner;
+    runner.setRunCount(24);
+    runner.setDronesPerRun(5);
+    runner.setDuration(600.0);
+    runner.setTickRate(2.0);
+    runner.setMovementType(SimulationFactory::RANDOM_WALK_MOVEMENT);
+    runner.setBaseSeed(7);
+    runner.setThreadCount(1);
+    QVERIFY(runner.seedForRun(0) != runner.seedForRun(1));
+
+    quint64 progressCalls = 0;
+    runner.setProgressCallback([&progressCalls](const EnsembleStatistics& statistics) {
+        ++progressCalls;
+        QVERIFY(statistics.getCompletedRuns() % 8 == 0);
+    }, 8);
+    // Members are quiet from construction on: nothing per run reaches the log
+    QTemporaryDir logDir;
+    QVERIFY(logDir.isValid());
+    const QString logPath = logDir.filePath("ensemble.log");
+    Logger::getInstance().setLogFile(logPath);
+    const EnsembleStatistics serial = runner.run();
+    Logger::getInstance().flush();
+    QFile log(logPath);
+    QVERIFY(log.open(QIODevice::ReadOnly));
+    const QByteArray logged = log.readAll();
+    QVERIFY(!logged.contains("DroneSimulator"));
+    QVERIFY(!logged.contains("Tick rate"));
+    QVERIFY(!logged.contains("Movement strategy"));
+    QCOMPARE(progressCalls, quint64(3));
+    QCOMPARE(serial.getCompletedRuns(), quint64(24));
+    QCOMPARE(serial.getDroneSamples(), quint64(24 * 5));
+
+    // Every drone lands in exactly one bin or in "never low"
+    quint64 counted = serial.getNeverLowCount();
+    for (quint64 count : serial.getLowBatteryHistogram()) {
+        counted += count;
+    }
+    QCOMPARE(counted, serial.getDroneSamples());
+    quint64 displaced = 0;
+    for (quint64 count : serial.getDisplacementHistogram()) {
+        displaced += count;
+    }
+    QCOMPARE(displaced, serial.getDroneSamples());
+    QVERIFY(serial.getMaxDisplacementMeters() > 0.0);
+    QCOMPARE(serial.fractionLowBefore(600.0),
+             1.0 - double(serial.getNeverLowCount()) / serial.getDroneSamples());
+
+    // Runs are independent, so the worker count does not change the outcome
+    runner.setProgressCallback(EnsembleRunner::ProgressCallback(), 0);
+    runner.setThreadCount(4);
+    const EnsembleStatistics parallel = runner.run();
+    QVERIFY(parallel.getLowBatteryHistogram() == serial.getLowBatteryHistogram());
+    QVERIFY(parallel.getDisplacementHistogram() == serial.getDisplacementHistogram());
+    QCOMPARE(parallel.getMaxDisplacementMeters(), serial.getMaxDisplacementMeters());
+    QVERIFY(qAbs(parallel.meanFinalBattery() - serial.meanFinalBattery()) < 1e-9);
+
+    runner.setBaseSeed(8);
+    const EnsembleStatistics other = runner.run();
+    QVERIFY(other.getDisplacementHistogram() != serial.getDisplacementHistogram()
+            || other.getMaxDisplacementMeters() != serial.getMaxDisplacementMeters());
+}
+
+void TestSimulation::testAlertRules() {
+    const QByteArray json =
+        "{\"rules\": ["
+        "  {\"name\": \"low\", \"trigger\": \"edge\","
+        "   \"when\": [{\"field\": \"battery\", \"op\": \"<=\", \"value\": 20}]},"
+        "  {\"name\": \"high-no-fix\", \"trigger\": \"level\", \"severity\": \"error\","
+        "   \"when\": [{\"field\": \"altitude\", \"op\": \">\", \"value\": 150},"
+        "             {\"field\": \"gps\", \"op\": \"==\", \"value\": \"NO_FIX\"}]},"
+        "  {\"name\": \"low-info\", \"trigger\": \"edge\", \"severity\": \"info\","
+        "   \"when\": [{\"field\": \"battery\", \"op\": \"<=\", \"value\": 20}]}"
+        "]}";
+    std::vector<AlertRule> rules;
+    QString error;
+    QVERIFY(AlertEngine::parseRules(json, rules, error));
+    QCOMPARE(rules.size(), std::size_t(3));
+    QCOMPARE(rules[1].severity, AlertRule::ERROR);
+    QCOMPARE(rules[1].conditions[1].value, 0.0);
+
+    AlertEngine engine;
+    QCOMPARE(engine.getRules().size(), AlertEngine::defaultRules().size());
+    engine.setRules(rules);
+    // The shared battery threshold compiles to one predicate
+    QCOMPARE(engine.getPredicateCount(), std::size_t(3));
+
+    std::vector<AlertRule> rejected;
+    QVERIFY(!AlertEngine::parseRules(
+        "{\"rules\": [{\"name\": \"x\", \"when\": [{\"field\": \"wind\", \"op\": \"<\", \"value\": 1}]}]}",
+        rejected, error));
+    QVERIFY(error.contains("wind"));
+
+    // Several evaluation blocks, the last one partial
+    FleetState fleet;
+    for (int i = 0; i < 2500; ++i) {
+        fleet.addDrone(DroneData(QString("ALERT-%1").arg(i), 28.5, 77.5, 100.0, 0.0, 0.0, 50.0,
+                                 GPSFixStatus::FIX_3D));
+    }
+    QVERIFY(engine.evaluate(fleet).empty());
+
+    // Edge rules fire once per crossing, ordered by drone then rule
+    fleet.batteries()[5] = 15.0;
+    fleet.batteries()[1100] = 15.0;
+    fleet.batteries()[2499] = 15.0;
+    fleet.altitudes()[2000] = 200.0;
+    const std::vector<AlertEvent> crossed = engine.evaluate(fleet);
+    QCOMPARE(crossed.size(), std::size_t(6));
+    QCOMPARE(crossed[0].index, std::size_t(5));
+    QCOMPARE(crossed[0].rule, std::size_t(0));
+    QCOMPARE(crossed[1].rule, std::size_t(2));
+    QCOMPARE(crossed[5].index, std::size_t(2499));
+    QCOMPARE(crossed[5].droneId, fleet.idAt(2499));
+    QVERIFY(engine.evaluate(fleet).empty());
+
+    // Level rules raise while every condition holds and clear afterwards
+    fleet.gpsStatuses()[2000] = GPSFixStatus::NO_FIX;
+    QCOMPARE(engine.evaluate(fleet).size(), std::size_t(1));
+    QCOMPARE(engine.getEvents()[0].rule, std::size_t(1));
+    QCOMPARE(engine.getEvents()[0].transition, AlertEvent::RAISED);
+    fleet.altitudes()[2000] = 100.0;
+    QCOMPARE(engine.evaluate(fleet).size(), std::size_t(1));
+    QCOMPARE(engine.getEvents()[0].transition, AlertEvent::CLEARED);
+
+    // State follows drones by ID when the layout changes; a drone that is
+    // already low when it joins is not reported by the edge rules
+    FleetState shifted;
+    for (std::size_t i = 1; i < fleet.size(); ++i) {
+        shifted.addDrone(fleet.view(i));
+    }
+    shifted.addDrone(DroneData(QString("ALERT-NEW"), 28.5, 77.5, 100.0, 0.0, 0.0, 10.0, GPSFixStatus::FIX_3D));
+    shifted.batteries()[1099] = 50.0;
+    QVERIFY(engine.evaluate(shifted).empty());
+    shifted.batteries()[1099] = 12.0;
+    QCOMPARE(engine.evaluate(shifted).size(), std::size_t(2));
+    QCOMPARE(engine.getEvents()[0].droneId, fleet.idAt(1100));
+    QCOMPARE(engine.getTotalRaised(), quint64(9));
+
+    // The default geofence rules follow the zones, named statuses included
+    std::vector<AlertRule> fenceRules;
+    QVERIFY(AlertEngine::parseRules(
+        "{\"rules\": [{\"name\": \"nfz\", \"when\": [{\"field\": \"geofence\", \"op\": \"==\", "
+        "\"value\": \"INSIDE_EXCLUSION\"}]}]}", fenceRules, error));
+    QCOMPARE(fenceRules[0].conditions[0].value, static_cast<double>(Geofence::INSIDE_EXCLUSION));
+
+    fleet.gpsStatuses()[2000] = GPSFixStatus::FIX_3D;
+    AlertEngine fenced;
+    std::vector<GeofenceZone> zones = Geofence::defaultZones();
+    zones.push_back(Geofence::box("tower", GeofenceZone::EXCLUSION, GeofenceBounds{28.6, 28.7, 77.6, 77.7}));
+    fenced.setGeofence(std::make_shared<const Geofence>(zones));
+    QVERIFY(fenced.evaluate(fleet).empty());
+    fleet.latitudes()[10] = 28.65;
+    fleet.longitudes()[10] = 77.65;
+    fleet.latitudes()[1500] = 30.0;
+    QCOMPARE(fenced.evaluate(fleet).size(), std::size_t(2));
+    QCOMPARE(fenced.getRules()[fenced.getEvents()[0].rule].name, QString("geofence-exclusion"));
+    QCOMPARE(fenced.getRules()[fenced.getEvents()[1].rule].name, QString("geofence-exit"));
+}
+
 QTEST_MAIN(TestSimulation)
 #include "test_simulation.moc"
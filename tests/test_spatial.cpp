@@ -0,0 +1,291 @@
+#include <QtTest/QtTest>
+#include <QtMath>
+#include <algorithm>
+#include <vector>
+#include "spatialgrid.h"
+#include "conflictdetector.h"
+#include "geofence.h"
+#include "fleetstate.h"
+#include "dronedata.h"
+#include "philoxrng.h"
+
+class TestSpatial : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRadiusQueryMatchesScan();
+    void testBoxQuery();
+    void testEmptyAndRebuild();
+    void testPairsMatchScan();
+    void testConflictDetection();
+    void testGeofenceMatchesScan();
+};
+
+namespace {
+FleetState randomFleet(std::size_t count, quint64 seed) {
+    const PhiloxRng random(seed, PhiloxRng::MOVEMENT);
+    FleetState fleet;
+    fleet.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        fleet.addDrone(DroneData(QString("DRONE-%1").arg(i),
+                                 28.40 + 0.05 * random.uniform(i, 0, 0),
+                                 77.00 + 0.05 * random.uniform(i, 0, 1),
+                                 50.0 + 150.0 * random.uniform(i, 0, 2),
+                                 0.0, 0.0, 100.0, GPSFixStatus::FIX_3D));
+    }
+    return fleet;
+}
+
+// Collects what a detector forwards
+class ConflictRecorder : public ConflictListener {
+public:
+    void updateConflicts(const std::vector<ConflictEvent>& conflicts) override { received = conflicts; ++calls; }
+
+    std::vector<ConflictEvent> received;
+    int calls = 0;
+};
+
+// Star-shaped (so concave) polygon with alternating radii, in degrees
+GeofenceZone starZone(const QString& name, GeofenceZone::Type type, double latitude, double longitude,
+                      double radius, std::size_t points, const PhiloxRng& random, quint64 stream) {
+    GeofenceZone zone;
+    zone.name = name;
+    zone.type = type;
+    for (std::size_t i = 0; i < 2 * points; ++i) {
+        const double angle = M_PI * i / points;
+        const double scale = (i % 2 ? 0.4 : 1.0) * (0.7 + 0.3 * random.uniform(stream, i, 0));
+        zone.vertices.push_back({latitude + radius * scale * qCos(angle), longitude + radius * scale * qSin(angle)});
+    }
+    return zone;
+}
+
+// Plain crossing-number test, for points off the boundary
+bool insidePolygon(const GeofenceZone& zone, double latitude, double longitude) {
+    bool inside = false;
+    for (std::size_t i = 0, j = zone.vertices.size() - 1; i < zone.vertices.size(); j = i++) {
+        const GeofenceZone::Vertex& a = zone.vertices[i];
+        const GeofenceZone::Vertex& b = zone.vertices[j];
+        if ((a.latitude > latitude) != (b.latitude > latitude)
+            && longitude < a.longitude + (latitude - a.latitude) * (b.longitude - a.longitude) / (b.latitude - a.latitude)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+}
+
+void TestSpatial::testRadiusQueryMatchesScan() {
+    const FleetState fleet = randomFleet(5000, 3);
+    SpatialGrid grid(50.0);
+    grid.rebuild(fleet);
+    QCOMPARE(grid.size(), fleet.size());
+
+    // Every query must return exactly the drones a full scan finds
+    for (std::size_t probe = 0; probe < 50; ++probe) {
+        const double latitude = fleet.latitudes()[probe];
+        const double longitude = fleet.longitudes()[probe];
+        const double altitude = fleet.altitudes()[probe];
+        const double radius = probe % 2 ? 40.0 : 400.0;
+
+        std::vector<std::size_t> found;
+        grid.queryRadius(latitude, longitude, altitude, radius, found);
+        std::sort(found.begin(), found.end());
+
+        std::vector<std::size_t> expected;
+        for (std::size_t i = 0; i < fleet.size(); ++i) {
+            const double dx = grid.eastMeters(fleet.longitudes()[i]) - grid.eastMeters(longitude);
+            const double dy = grid.northMeters(fleet.latitudes()[i]) - grid.northMeters(latitude);
+            const double dz = fleet.altitudes()[i] - altitude;
+            if (dx * dx + dy * dy + dz * dz <= radius * radius) {
+                expected.push_back(i);
+            }
+        }
+        QVERIFY(std::binary_search(found.begin(), found.end(), probe));
+        QCOMPARE(found, expected);
+    }
+
+    // 0.001 degrees of latitude is about 111 m
+    QVERIFY(qAbs(grid.northMeters(28.426) - grid.northMeters(28.425) - 111.2) < 0.1);
+}
+
+void TestSpatial::testBoxQuery() {
+    const FleetState fleet = randomFleet(2000, 5);
+    SpatialGrid grid;
+    grid.rebuild(fleet);
+
+    std::vector<std::size_t> found;
+    grid.queryBox(28.41, 77.01, 28.43, 77.02, found);
+    std::sort(found.begin(), found.end());
+
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < fleet.size(); ++i) {
+        if (fleet.latitudes()[i] >= 28.41 && fleet.latitudes()[i] <= 28.43
+            && fleet.longitudes()[i] >= 77.01 && fleet.longitudes()[i] <= 77.02) {
+            expected.push_back(i);
+        }
+    }
+    QVERIFY(!expected.empty());
+    QCOMPARE(found, expected);
+
+    // A box covering the whole area falls back to one pass over the grid
+    found.clear();
+    grid.queryBox(-90.0, -180.0, 90.0, 180.0, found);
+    QCOMPARE(found.size(), fleet.size());
+}
+
+void TestSpatial::testEmptyAndRebuild() {
+    SpatialGrid grid;
+    std::vector<std::size_t> found;
+    grid.queryRadius(28.4, 77.0, 100.0, 1000.0, found);
+    QVERIFY(found.empty());
+
+    // Rebuilding picks up moved drones
+    FleetState fleet = randomFleet(100, 7);
+    grid.rebuild(fleet);
+    fleet.latitudes()[42] = 10.0;
+    fleet.longitudes()[42] = 10.0;
+    grid.rebuild(fleet);
+    grid.queryRadius(10.0, 10.0, fleet.altitudes()[42], 1.0, found);
+    QCOMPARE(found, std::vector<std::size_t>{42});
+
+    fleet.clear();
+    grid.rebuild(fleet);
+    QVERIFY(grid.isEmpty());
+}
+
+void TestSpatial::testPairsMatchScan() {
+    const FleetState fleet = randomFleet(1500, 9);
+    SpatialGrid grid(30.0);
+    grid.rebuild(fleet);
+
+    // Radii below, at and above the cell size
+    for (double radius : {20.0, 30.0, 75.0}) {
+        std::vector<std::pair<std::size_t, std::size_t>> found;
+        grid.findPairsWithin(radius, found);
+        std::sort(found.begin(), found.end());
+
+        std::vector<std::pair<std::size_t, std::size_t>> expected;
+        for (std::size_t i = 0; i < fleet.size(); ++i) {
+            for (std::size_t j = i + 1; j < fleet.size(); ++j) {
+                const double dx = grid.eastMeters(fleet.longitudes()[i]) - grid.eastMeters(fleet.longitudes()[j]);
+                const double dy = grid.northMeters(fleet.latitudes()[i]) - grid.northMeters(fleet.latitudes()[j]);
+                const double dz = fleet.altitudes()[i] - fleet.altitudes()[j];
+                if (dx * dx + dy * dy + dz * dz <= radius * radius) {
+                    expected.emplace_back(i, j);
+                }
+            }
+        }
+        QVERIFY(!expected.empty());
+        QCOMPARE(found, expected);
+    }
+}
+
+void TestSpatial::testConflictDetection() {
+    // 0.0002 degrees of latitude is about 22 m
+    FleetState fleet;
+    fleet.addDrone(DroneData(QString("CONVERGE-A"), 28.5000, 77.0, 100.0, 0.0, 5.0, 100.0, GPSFixStatus::FIX_3D));
+    fleet.addDrone(DroneData(QString("CONVERGE-B"), 28.5002, 77.0, 100.0, 180.0, 5.0, 100.0, GPSFixStatus::FIX_3D));
+    fleet.addDrone(DroneData(QString("DIVERGE-A"), 28.6000, 77.0, 100.0, 180.0, 5.0, 100.0, GPSFixStatus::FIX_3D));
+    fleet.addDrone(DroneData(QString("DIVERGE-B"), 28.6002, 77.0, 100.0, 0.0, 5.0, 100.0, GPSFixStatus::FIX_3D));
+    fleet.addDrone(DroneData(QString("TOUCH-A"), 28.7000, 77.0, 100.0, 0.0, 0.0, 100.0, GPSFixStatus::FIX_3D));
+    fleet.addDrone(DroneData(QString("TOUCH-B"), 28.7000, 77.0, 102.0, 0.0, 0.0, 100.0, GPSFixStatus::FIX_3D));
+
+    ConflictDetector detector(50.0, 5.0);
+    ConflictRecorder recorder;
+    detector.addListener(&recorder);
+    detector.updateFleet(std::make_shared<const FleetState>(fleet));
+
+    // Converging drones lose separation, diverging ones do not, touching ones collide
+    QCOMPARE(recorder.calls, 1);
+    QCOMPARE(recorder.received.size(), std::size_t(2));
+    const ConflictEvent& converging = recorder.received[0];
+    QCOMPARE(converging.first, std::size_t(0));
+    QCOMPARE(converging.second, std::size_t(1));
+    QCOMPARE(converging.severity, ConflictEvent::PROXIMITY);
+    QVERIFY(qAbs(converging.distanceMeters - 22.2) < 0.1);
+    QVERIFY(qAbs(converging.closingSpeed - 10.0) < 1e-9);
+    QVERIFY(converging.isNew);
+    QCOMPARE(recorder.received[1].first, std::size_t(4));
+    QCOMPARE(recorder.received[1].severity, ConflictEvent::COLLISION);
+    QCOMPARE(detector.getTotalConflicts(), quint64(2));
+
+    // A conflict that persists is reported again but not counted again
+    detector.detect(fleet);
+    QCOMPARE(detector.getConflicts().size(), std::size_t(2));
+    QVERIFY(!detector.getConflicts()[0].isNew);
+    QCOMPARE(detector.getTotalConflicts(), quint64(2));
+
+    detector.removeListener(&recorder);
+}
+
+void TestSpatial::testGeofenceMatchesScan() {
+    // A concave inclusion zone holding hundreds of overlapping exclusion zones
+    const PhiloxRng random(11, PhiloxRng::MOVEMENT);
+    std::vector<GeofenceZone> zones;
+    zones.push_back(starZone("area", GeofenceZone::INCLUSION, 28.7, 77.5, 0.5, 40, random, 0));
+    for (quint64 z = 1; z <= 400; ++z) {
+        zones.push_back(starZone(QString("nfz-%1").arg(z), GeofenceZone::EXCLUSION,
+                                 28.2 + 1.0 * random.uniform(z, 0, 1), 77.0 + 1.0 * random.uniform(z, 0, 2),
+                                 0.005 + 0.03 * random.uniform(z, 0, 3), 6, random, z));
+    }
+    zones.push_back(Geofence::box("depot", GeofenceZone::EXCLUSION, GeofenceBounds{28.70, 28.71, 77.50, 77.52}));
+    const Geofence fence(zones);
+    QVERIFY(!fence.isBox());
+    QVERIFY(fence.getCellCount() <= Geofence::MAX_GRID_CELLS);
+
+    // Every status matches testing each zone in turn
+    const std::size_t count = 20000;
+    std::vector<double> latitudes(count), longitudes(count);
+    std::vector<quint8> status(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        latitudes[i] = 28.1 + 1.2 * random.uniform(i, 1, 0);
+        longitudes[i] = 76.9 + 1.2 * random.uniform(i, 1, 1);
+    }
+    fence.classify(latitudes.data(), longitudes.data(), count, status.data());
+    for (std::size_t i = 0; i < count; ++i) {
+        int excluding = -1;
+        for (std::size_t z = 1; z < zones.size() && excluding < 0; ++z) {
+            excluding = insidePolygon(zones[z], latitudes[i], longitudes[i]) ? static_cast<int>(z) : -1;
+        }
+        const Geofence::Status expected = excluding >= 0 ? Geofence::INSIDE_EXCLUSION
+            : insidePolygon(zones[0], latitudes[i], longitudes[i]) ? Geofence::CLEAR : Geofence::OUTSIDE_INCLUSION;
+        QCOMPARE(static_cast<Geofence::Status>(status[i]), expected);
+
+        int zone = -1;
+        QCOMPARE(fence.classify(latitudes[i], longitudes[i], &zone), expected);
+        if (expected == Geofence::INSIDE_EXCLUSION) {
+            QVERIFY(insidePolygon(zones[zone], latitudes[i], longitudes[i]));
+        }
+    }
+
+    // Boundaries belong to their zone, corners included
+    QCOMPARE(fence.classify(28.70, 77.51), Geofence::INSIDE_EXCLUSION);
+    QCOMPARE(fence.classify(28.705, 77.52), Geofence::INSIDE_EXCLUSION);
+    QCOMPARE(fence.classify(28.71, 77.52), Geofence::INSIDE_EXCLUSION);
+    const Geofence& area = Geofence::operatingArea();
+    QVERIFY(area.isBox());
+    QCOMPARE(area.classify(28.4, 77.0), Geofence::CLEAR);
+    QCOMPARE(area.classify(29.0, 77.3), Geofence::CLEAR);
+    QCOMPARE(area.classify(28.6, 78.0), Geofence::CLEAR);
+    QCOMPARE(area.classify(29.0 + 1e-9, 77.3), Geofence::OUTSIDE_INCLUSION);
+    QCOMPARE(Geofence().classify(0.0, 0.0), Geofence::CLEAR);
+
+    // Zone files; exclusion is the default type
+    std::vector<GeofenceZone> parsed;
+    QString error;
+    QVERIFY(Geofence::parseZones(R"({"zones": [
+        {"name": "field", "type": "inclusion", "vertices": [[28.4, 77.0], [28.4, 77.2], [28.6, 77.1]]},
+        {"name": "tower", "vertices": [[28.45, 77.09], [28.45, 77.11], [28.47, 77.11], [28.47, 77.09]]}
+    ]})", parsed, error));
+    QCOMPARE(parsed.size(), std::size_t(2));
+    QCOMPARE(parsed[1].type, GeofenceZone::EXCLUSION);
+    const Geofence loaded(parsed);
+    QCOMPARE(loaded.classify(28.46, 77.10), Geofence::INSIDE_EXCLUSION);
+    QCOMPARE(loaded.classify(28.42, 77.10), Geofence::CLEAR);
+    QCOMPARE(loaded.classify(28.55, 77.01), Geofence::OUTSIDE_INCLUSION);
+    QVERIFY(!Geofence::parseZones(R"({"zones": [{"name": "line", "vertices": [[28.4, 77.0], [28.5, 77.0]]}]})",
+                                  parsed, error));
+}
+
+QTEST_MAIN(TestSpatial)
+#include "test_spatial.moc"